@@ -9,12 +9,17 @@
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE	/* sched_getcpu() */
+#endif
+
 #include <assert.h>
 #include <errno.h>
+#include <float.h>
 #include <limits.h>
 #include <stddef.h>
 #include <stdint.h>
-#include <string.h>	/* memcpy(), memmove(), memset(), strlen() */
+#include <string.h>	/* memchr(), memcpy(), memmove(), memset(), strlen() */
 
 /* //////////////////////////////////////////////////////////////////////// */
 
@@ -91,6 +96,12 @@
 #define UNUSED			/*@unused@*/
 #endif
 
+#if HAS_ATTRIBUTE(no_sanitize_address)
+#define NO_SANITIZE_ADDRESS	__attribute__((no_sanitize_address))
+#else
+#define NO_SANITIZE_ADDRESS
+#endif
+
 #define DEBUG_ONLY		UNUSED
 
 /* ======================================================================== */
@@ -123,21 +134,165 @@
 #define UNLIKELY(cond)		(cond)
 #endif
 
+/* ======================================================================== */
+
+#if defined(__GNUC__) && defined(__ATOMIC_ACQUIRE)
+#define HAVE_ATOMICS
+#define ATOMIC_LOAD_RLX(ptr)		__atomic_load_n(ptr, __ATOMIC_RELAXED)
+#define ATOMIC_LOAD_ACQ(ptr)		__atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define ATOMIC_STORE_RLX(ptr, val)	__atomic_store_n( \
+	ptr, val, __ATOMIC_RELAXED \
+)
+#define ATOMIC_STORE_REL(ptr, val)	__atomic_store_n( \
+	ptr, val, __ATOMIC_RELEASE \
+)
+#define ATOMIC_CAS_ACQREL(ptr, expp, val)	__atomic_compare_exchange_n( \
+	ptr, expp, val, 1, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE \
+)
+#define ATOMIC_SUBFETCH_ACQREL(ptr, val)	__atomic_sub_fetch( \
+	ptr, val, __ATOMIC_ACQ_REL \
+)
+#define ATOMIC_FETCHADD_RLX(ptr, val)	__atomic_fetch_add( \
+	ptr, val, __ATOMIC_RELAXED \
+)
+#define ATOMIC_FENCE_ACQ()		__atomic_thread_fence(__ATOMIC_ACQUIRE)
+#define ATOMIC_FENCE_REL()		__atomic_thread_fence(__ATOMIC_RELEASE)
+#define ATOMIC_FENCE_SEQ()		__atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+
+/* ======================================================================== */
+
+#if defined(__SIZEOF_INT128__) && !defined(S_SPLINT_S)
+#define HAVE_UINT128
+__extension__ typedef unsigned __int128	UInt128;
+#endif
+
+/* asspf_printf_int128() (matches ASSPF_HAVE_INT128) */
+#if defined(HAVE_UINT128) && (UINTMAX_MAX == UINT64_MAX)
+#define HAVE_PRINTF_INT128
+#endif
+
+/* ------------------------------------------------------------------------ */
+
+#if !defined(ASSPF_OPT_NO_SIMD) && defined(__AVX2__)
+#include <immintrin.h>
+#define HAVE_SIMD_AVX2
+#define HAVE_SIMD_SSE2
+#elif !defined(ASSPF_OPT_NO_SIMD) && defined(__SSE2__)
+#include <emmintrin.h>
+#define HAVE_SIMD_SSE2
+#endif
+
 /* //////////////////////////////////////////////////////////////////////// */
 
+/* what a flush does when the fd would block (matches ASSPF_POLICY_*) */
+enum WriteBuf_Policy {
+	WRITEBUF_POLICY_BLOCK,	/* keep trying */
+	WRITEBUF_POLICY_RETRY,	/* try again up to 'policy_arg' times */
+	WRITEBUF_POLICY_POLL,	/* poll(2) up to 'policy_arg' ms per stall */
+	WRITEBUF_POLICY_DROP	/* give up at once */
+};
+
+/* where a WriteBuf's bytes go when it gets flushed */
+enum WriteBuf_Sink {
+	WRITEBUF_SINK_FD,
+	WRITEBUF_SINK_RING,
+	WRITEBUF_SINK_SHARED,
+	WRITEBUF_SINK_SHARDS,
+	WRITEBUF_SINK_MMAPLOG
+};
+
+#ifdef ASSPF_OPT_STATS
+/* what a writebuf has been up to (see asspf_writebuf_stats()) */
+struct WriteBuf_Stats {
+	size_t	nbytes_flushed;	/* out of the buffer (written or dropped) */
+	size_t	nbytes_written;	/* taken by the sink */
+	size_t	nsyscalls;	/* write(2), writev(2), sendfile(2), ... */
+	size_t	npartial;	/* writes that took less than they were given */
+	size_t	nretries;	/* failed writes tried again (EAGAIN, EINTR) */
+	size_t	nbypass;	/* writes too big for the buffer, gathered */
+	size_t	nformat_errors;	/* prints that printed nothing */
+};
+
+#define STATS_ADD(Xwritebuf, Xmember, Xn)	( \
+	(Xwritebuf)->stats.Xmember += (size_t) (Xn) \
+)
+#else
+#define STATS_ADD(Xwritebuf, Xmember, Xn)	((void) 0)
+#endif
+
 struct ASSPF_WriteBuf {
 	/*@temp@*/
-	char		*buf;
-	unsigned short	limit;
-	unsigned short	nmemb;
-	int		fd;
+	char			*buf;
+	size_t			limit;
+	size_t			nmemb;
+	int			fd;
+	/*@null@*/ /*@dependent@*/
+	void			*sink;
+	enum WriteBuf_Sink	sinktype;
+	unsigned int		flags;
+	enum WriteBuf_Policy	policy;
+	int			policy_arg;
+	size_t			dropped;
+#ifdef ASSPF_OPT_STATS
+	struct WriteBuf_Stats	stats;
+#endif
+};
+
+#define WRITEBUF_FLAG_NONE	0x0u
+#define WRITEBUF_FLAG_BINARY	0x1u	/* write binary trace records */
+
+struct ASSPF_IOVec {
+	/*@temp@*/
+	const void	*base;
+	size_t		 size;
+};
+
+#ifdef ASSPF_OPT_STATS
+/* a copy of a writebuf's counters, for asspf_writebuf_stats() */
+struct ASSPF_Stats {
+	size_t	bytes_buffered;
+	size_t	bytes_written;
+	size_t	bytes_dropped;
+	size_t	syscalls;
+	size_t	partial_writes;
+	size_t	retries;
+	size_t	bypass_writes;
+	size_t	format_errors;
+};
+#endif
+
+struct ASSPF_ReadBuf {
+	/*@temp@*/
+	char			*buf;
+	size_t			limit;
+	size_t			idx;	/* of the next unread byte */
+	size_t			nmemb;
+	int			fd;
+	int			eof;	/* read(2) returned 0 or failed */
 };
 
+/* a seqlock: 'seq' is odd while someone refills the rest, and 0 if empty */
+struct ASSPF_TimeCache {
+	uint64_t	seq;
+	uint64_t	minute;		/* of 'prefix', since the epoch */
+	uint64_t	prefix[3u];	/* "YYYY-MM-DDTHH:MM:" */
+};
+
+/* which clock a timestamp comes from (matches ASSPF_CLOCK_*) */
+#define TIMESTAMP_CLOCK_REALTIME	0
+#define TIMESTAMP_CLOCK_MONOTONIC	1
+
+/* what asspf_read_u64()/asspf_read_i64() return (matches ASSPF_PARSE_*) */
+#define READBUF_PARSE_OK	0
+#define READBUF_PARSE_NONE	1	/* no number, or the end of the input */
+#define READBUF_PARSE_RANGE	2	/* out of range, so clamped */
+
 /* ------------------------------------------------------------------------ */
 
 /* returns a defined struct */
 ALWAYS_INLINE CONST struct ASSPF_WriteBuf
-writebuf_get(char *buf, unsigned short size, int fd)
+writebuf_get(char *buf, size_t size, int fd)
 /*@*/
 {
 	struct ASSPF_WriteBuf retval;
@@ -146,6 +301,15 @@ writebuf_get(char *buf, unsigned short size, int fd)
 	retval.limit	= size;
 	retval.nmemb	= 0;
 	retval.fd	= fd;
+	retval.sink	= NULL;
+	retval.sinktype	= WRITEBUF_SINK_FD;
+	retval.flags	= WRITEBUF_FLAG_NONE;
+	retval.policy	= WRITEBUF_POLICY_BLOCK;
+	retval.policy_arg	= 0;
+	retval.dropped	= 0;
+#ifdef ASSPF_OPT_STATS
+	(void) memset(&retval.stats, 0, sizeof retval.stats);
+#endif
 
 	return retval;
 }
@@ -153,17 +317,127 @@ writebuf_get(char *buf, unsigned short size, int fd)
 /* //////////////////////////////////////////////////////////////////////// */
 
 #if defined(__unix__)
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
 #include <unistd.h>
+#define CLOCK_GETTIME(id, ts)	clock_gettime(id, ts)
+#define SET_NONBLOCK(fd)	( \
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) != -1 ? 0 : -1 \
+)
+#ifdef O_CLOEXEC
+#define OPEN_RDONLY(path)	open(path, O_RDONLY | O_CLOEXEC)
+#else
+#define OPEN_RDONLY(path)	open(path, O_RDONLY)
+#endif
+#define CLOSE(fd)		close(fd)
+#define READ(fd, buf, count)	((size_t)   read(fd, buf, count))
 #define WRITE(fd, buf, count)	((size_t)  write(fd, buf, count))
+#ifndef ASSPF_OPT_NO_WRITEV
+#include <sys/uio.h>
+#define WRITEV(fd, iov, iovcnt)	((size_t) writev(fd, iov, iovcnt))
+#endif
+#if defined(__linux__) && !defined(ASSPF_OPT_NO_SPLICE)
+#include <sys/sendfile.h>
+#define SENDFILE(out_fd, in_fd, count)	((size_t) sendfile( \
+	out_fd, in_fd, NULL, count \
+))
+#define SPLICE(in_fd, out_fd, count)	((size_t) splice( \
+	in_fd, NULL, out_fd, NULL, count, (unsigned int) SPLICE_F_MOVE \
+))
+#endif
 
 #elif defined(__WIN32__)
+#include <fcntl.h>
 #include <io.h>
+#include <time.h>
+/* no monotonic clock here: both read the realtime one */
+#define CLOCK_REALTIME		0
+#define CLOCK_MONOTONIC		1
+#define CLOCK_GETTIME(id, ts)	(timespec_get(ts, TIME_UTC) != 0 ? 0 : -1)
+/* CRT pipes have no non-blocking mode */
+#define SET_NONBLOCK(fd)	((void) (fd), 0)
+#define OPEN_RDONLY(path)	_open(path, _O_RDONLY | _O_BINARY)
+#define CLOSE(fd)		_close(fd)
+#define READ(fd, buf, count)	((size_t)  _read(fd, buf, count))
 #define WRITE(fd, buf, count)	((size_t) _write(fd, buf, count))
 
 #else
 #error "unsupported system"
 #endif
 
+/* ------------------------------------------------------------------------ */
+
+#ifdef WRITEV
+#define SYSIOVEC	iovec
+#else
+struct Sys_IOVec {
+	void	*iov_base;
+	size_t	 iov_len;
+};
+#define SYSIOVEC	Sys_IOVec
+#endif
+
+/* max number of iovecs per gathered write */
+#define GATHER_IOVCNT_MAX	16u
+
+/* ------------------------------------------------------------------------ */
+
+#undef writebuf
+static size_t writebuf_sink_write(
+	struct ASSPF_WriteBuf *writebuf, const void *, size_t
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+;
+
+#ifdef HAVE_ATOMICS
+struct ASSPF_Ring;
+
+#undef ring
+static size_t ring_publish(struct ASSPF_Ring *ring, const void *, size_t)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*ring
+@*/
+;
+
+struct ASSPF_SharedBuf;
+
+#undef sharedbuf
+extern size_t asspf_shared_write(
+	struct ASSPF_SharedBuf *sharedbuf, const void *, size_t
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*sharedbuf
+@*/
+;
+
+struct ASSPF_Shards;
+
+#undef shards
+extern size_t asspf_shards_write(
+	struct ASSPF_Shards *shards, const void *, size_t
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*shards
+@*/
+;
+
+struct ASSPF_MMapLog;
+
+#undef mmaplog
+extern size_t asspf_mmaplog_write(
+	struct ASSPF_MMapLog *mmaplog, const void *, size_t
+)
+/*@modifies	*mmaplog@*/
+;
+#endif
+
 /* ======================================================================== */
 
 /* returns 0 on success */
@@ -173,6 +447,18 @@ asspf_writebuf_autoinit(
 	/*@reldef@*/ char *buf, unsigned short limit
 )
 /*@modifies	*writebuf@*/
+{
+	*writebuf = writebuf_get(buf, (size_t) limit, fd);
+	return 0;
+}
+
+/* returns 0 on success */
+int
+asspf_writebuf_autoinit_large(
+	/*@out@*/ struct ASSPF_WriteBuf *writebuf, int fd,
+	/*@reldef@*/ char *buf, size_t limit
+)
+/*@modifies	*writebuf@*/
 {
 	*writebuf = writebuf_get(buf, limit, fd);
 	return 0;
@@ -180,38 +466,125 @@ asspf_writebuf_autoinit(
 
 /* ======================================================================== */
 
+/* returns TRUE if a failed write should be tried again */
+/* 'ntries' counts the retries so far
+   (for WRITEBUF_POLICY_POLL, the milliseconds spent, at least 1 a try) */
+static int
+sys_write_again(
+	int fd, enum WriteBuf_Policy policy, int policy_arg, int *ntries
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		*ntries
+@*/
+{
+#ifdef __unix__
+	struct pollfd pfd;
+	struct timespec ts_0, ts_1;
+	long elapsed;
+	int result;
+
+	if ( (errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR) ){
+		return FALSE;
+	}
+
+	switch ( policy ){
+	case WRITEBUF_POLICY_BLOCK:
+		return TRUE;
+	case WRITEBUF_POLICY_RETRY:
+		return (*ntries)++ < policy_arg;
+	case WRITEBUF_POLICY_POLL:
+		/* one budget for the whole write, interrupts included */
+		if ( *ntries >= policy_arg ){
+			return FALSE;
+		}
+		if ( errno == EINTR ){
+			++(*ntries);
+			return TRUE;
+		}
+		pfd.fd      = fd;
+		pfd.events  = (short) POLLOUT;
+		pfd.revents = 0;
+		(void) CLOCK_GETTIME(CLOCK_MONOTONIC, &ts_0);
+		result = poll(&pfd, (nfds_t) 1u, policy_arg - *ntries);
+		if ( CLOCK_GETTIME(CLOCK_MONOTONIC, &ts_1) != 0 ){
+			ts_1 = ts_0;
+		}
+		elapsed = ((long) (ts_1.tv_sec - ts_0.tv_sec) * 1000L)
+			+ ((ts_1.tv_nsec - ts_0.tv_nsec) / 1000000L);
+		elapsed = (elapsed < 1L ? 1L : elapsed);
+		elapsed = (elapsed > (long) policy_arg
+			? (long) policy_arg : elapsed
+		);
+		*ntries += (int) elapsed;
+		return (result > 0) || ((result < 0) && (errno == EINTR));
+	case WRITEBUF_POLICY_DROP:
+		break;
+	}
+#else
+	(void) fd;
+	(void) policy;
+	(void) policy_arg;
+	(void) ntries;
+#endif
+	return FALSE;
+}
+
 /* returns the number of bytes written */
-NOINLINE size_t
-asspf_sys_write(int fd, const void *buf, size_t size)
+/* (to the writebuf's fd, under its policy; the buffer is not touched) */
+static size_t
+sys_write(struct ASSPF_WriteBuf *writebuf, const void *buf, size_t size)
 /*@globals	fileSystem@*/
-/*@modifies	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
 {
 	const char *buf_c = buf;
 	size_t retval = 0, result;
+	int ntries = 0;
 
 try_again:
-	result = WRITE(fd, buf_c, size);
+	result = WRITE(writebuf->fd, buf_c, size);
+	STATS_ADD(writebuf, nsyscalls, 1u);
 	if LIKELY ( result != SIZE_MAX ){
 		assert(result <= size);
 		retval += result;
 		if UNLIKELY ( result < size ){
+			STATS_ADD(writebuf, npartial, 1u);
 			buf_c = &buf_c[result];
 			size -= result;
 			goto try_again;
 		}
 	}
-#ifdef __unix__
-	else {	if ( (errno == EAGAIN) || (errno == EINTR) ){
+	else {	if ( sys_write_again(
+			writebuf->fd, writebuf->policy, writebuf->policy_arg,
+			&ntries
+		) ){
+			STATS_ADD(writebuf, nretries, 1u);
 			goto try_again;
 		}
 	}
-#endif
 	return retval;
 }
 
+/* ======================================================================== */
+
+/* returns the number of bytes written */
+NOINLINE size_t
+asspf_sys_write(int fd, const void *buf, size_t size)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem@*/
+{
+	struct ASSPF_WriteBuf writebuf = writebuf_get(NULL, 0, fd);
+
+	return sys_write(&writebuf, buf, size);
+}
+
 /* returns the number of bytes left in the buffer (0 == success) */
-NOINLINE unsigned short
-asspf_flush(struct ASSPF_WriteBuf *writebuf)
+static NOINLINE size_t
+writebuf_flush(struct ASSPF_WriteBuf *writebuf)
 /*@globals	fileSystem@*/
 /*@modifies	fileSystem,
 		*writebuf
@@ -219,1178 +592,6951 @@ asspf_flush(struct ASSPF_WriteBuf *writebuf)
 {
 	size_t nbytes_writ, writ_diff;
 
-	nbytes_writ = asspf_sys_write(
-		writebuf->fd, writebuf->buf, (size_t) writebuf->nmemb
+	nbytes_writ = writebuf_sink_write(
+		writebuf, writebuf->buf, writebuf->nmemb
 	);
-	assert(nbytes_writ <= (size_t) writebuf->nmemb);
+	STATS_ADD(writebuf, nbytes_flushed, nbytes_writ);
+	assert(nbytes_writ <= writebuf->nmemb);
 
 	/* check if the write failed */
-	writ_diff = ((size_t) writebuf->nmemb) - nbytes_writ;
+	writ_diff = writebuf->nmemb - nbytes_writ;
 	if UNLIKELY ( writ_diff != 0 ){
-		(void) memmove(
-			writebuf->buf, &writebuf->buf[nbytes_writ], writ_diff
-		);
+		if ( writebuf->policy != WRITEBUF_POLICY_BLOCK ){
+			/* give up on the rest */
+			writebuf->dropped += writ_diff;
+			STATS_ADD(writebuf, nbytes_flushed, writ_diff);
+			writ_diff = 0;
+		}
+		else {	(void) memmove(
+				writebuf->buf, &writebuf->buf[nbytes_writ],
+				writ_diff
+			);
+		}
 	}
-	writebuf->nmemb = (unsigned short) writ_diff;
+	writebuf->nmemb = writ_diff;
 
-	return (unsigned short) writ_diff;
+	return writ_diff;
 }
 
-/* returns the number of chars written to the buffer */
-NOINLINE size_t
-asspf_write(struct ASSPF_WriteBuf *writebuf, const void *src, size_t size)
+/* returns the number of bytes left in the buffer (0 == success) */
+/* (clamped to USHRT_MAX) */
+unsigned short
+asspf_flush(struct ASSPF_WriteBuf *writebuf)
 /*@globals	fileSystem@*/
 /*@modifies	fileSystem,
 		*writebuf
 @*/
 {
-	size_t nbytes_writ = 0;
-	unsigned short nmemb;
+	const size_t writ_diff = writebuf_flush(writebuf);
 
-	/* check if the writebuf needs to be flushed */
-	if ( (writebuf->nmemb != 0)
-	    &&
-	     (size > (size_t) (writebuf->limit - writebuf->nmemb))
-	){
-		nmemb = asspf_flush(writebuf);
-		if UNLIKELY ( nmemb != 0 ){
-			return 0;
+	return (unsigned short) (writ_diff > (size_t) USHRT_MAX
+		? (size_t) USHRT_MAX : writ_diff
+	);
+}
+
+/* returns the number of bytes written */
+/* 'iov' gets modified */
+static size_t
+sys_writev(
+	struct ASSPF_WriteBuf *writebuf, struct SYSIOVEC iov[], size_t iovcnt
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf,
+		iov[]
+@*/
+{
+	size_t retval = 0, result;
+	size_t i = 0;
+#ifdef WRITEV
+	int ntries = 0;
+#endif
+
+#ifdef WRITEV
+try_again:
+	while ( (i < iovcnt) && (iov[i].iov_len == 0) ){
+		i += 1u;
+	}
+	if ( i == iovcnt ){
+		return retval;
+	}
+	result = WRITEV(writebuf->fd, &iov[i], (int) (iovcnt - i));
+	STATS_ADD(writebuf, nsyscalls, 1u);
+	if LIKELY ( result != SIZE_MAX ){
+		retval += result;
+		/* skip past what was written (and any empties after it) */
+		while (
+			(i < iovcnt) && ((result != 0) || (iov[i].iov_len == 0))
+		){
+			if ( result < iov[i].iov_len ){
+				iov[i].iov_base  = &((char *) iov[i].iov_base)[
+					result
+				];
+				iov[i].iov_len  -= result;
+				result           = 0;
+			}
+			else {	result          -= iov[i].iov_len;
+				iov[i].iov_len   = 0;
+				i               += 1u;
+			}
 		}
+		if ( i == iovcnt ){
+			return retval;
+		}
+		STATS_ADD(writebuf, npartial, 1u);
+		goto try_again;
 	}
-
-	/* check if the source is too big for the writebuf */
-	if ( size > (size_t) writebuf->limit ){
-		nbytes_writ = asspf_sys_write(writebuf->fd, src, size);
+	else {	if ( sys_write_again(
+			writebuf->fd, writebuf->policy, writebuf->policy_arg,
+			&ntries
+		) ){
+			STATS_ADD(writebuf, nretries, 1u);
+			goto try_again;
+		}
 	}
-	else {	(void) memcpy(&writebuf->buf[writebuf->nmemb], src, size);
-		writebuf->nmemb += (unsigned short) size;
-		nbytes_writ = size;
+#else	/* !defined(WRITEV) */
+	for ( ; i < iovcnt; ++i ){
+		result  = sys_write(writebuf, iov[i].iov_base, iov[i].iov_len);
+		retval += result;
+		if UNLIKELY ( result != iov[i].iov_len ){
+			break;
+		}
 	}
-
-	return nbytes_writ;
+#endif	/* WRITEV */
+	return retval;
 }
 
-/* returns the number of chars written to the buffer */
-size_t
-asspf_puts(struct ASSPF_WriteBuf *writebuf, const char *s)
+/* returns the number of bytes the writebuf's sink took */
+static size_t
+writebuf_sink_write(
+	struct ASSPF_WriteBuf *writebuf, const void *buf, size_t size
+)
 /*@globals	fileSystem@*/
 /*@modifies	fileSystem,
 		*writebuf
 @*/
 {
-	return asspf_write(writebuf, s, strlen(s));
+	size_t retval = 0;
+
+	switch ( writebuf->sinktype ){
+	case WRITEBUF_SINK_FD:
+		retval = sys_write(writebuf, buf, size);
+		break;
+	case WRITEBUF_SINK_RING:
+#ifdef HAVE_ATOMICS
+		assert(writebuf->sink != NULL);
+		retval = ring_publish(writebuf->sink, buf, size);
+#else
+		assert(FALSE);
+#endif
+		break;
+	case WRITEBUF_SINK_SHARED:
+#ifdef HAVE_ATOMICS
+		assert(writebuf->sink != NULL);
+		retval = asspf_shared_write(writebuf->sink, buf, size);
+#else
+		assert(FALSE);
+#endif
+		break;
+	case WRITEBUF_SINK_SHARDS:
+#ifdef HAVE_ATOMICS
+		assert(writebuf->sink != NULL);
+		retval = asspf_shards_write(writebuf->sink, buf, size);
+#else
+		assert(FALSE);
+#endif
+		break;
+	case WRITEBUF_SINK_MMAPLOG:
+#ifdef HAVE_ATOMICS
+		assert(writebuf->sink != NULL);
+		retval = asspf_mmaplog_write(writebuf->sink, buf, size);
+#else
+		assert(FALSE);
+#endif
+		break;
+	}
+	STATS_ADD(writebuf, nbytes_written, retval);
+	return retval;
 }
 
-/* returns the number of chars written to the buffer */
-size_t
-asspf_putc(struct ASSPF_WriteBuf *writebuf, char c)
+/* returns the number of bytes the writebuf's sink took */
+/* 'iov' gets modified */
+static size_t
+writebuf_sink_writev(
+	struct ASSPF_WriteBuf *writebuf, struct SYSIOVEC iov[], size_t iovcnt
+)
 /*@globals	fileSystem@*/
 /*@modifies	fileSystem,
-		*writebuf
+		*writebuf,
+		iov[]
 @*/
 {
-	return asspf_write(writebuf, &c, sizeof c);
-}
-
-/* //////////////////////////////////////////////////////////////////////// */
+	size_t retval = 0, result;
+	size_t i;
 
-#ifndef ASSPF_OPT_NO_PRINTF
+	if LIKELY ( writebuf->sinktype == WRITEBUF_SINK_FD ){
+		retval = sys_writev(writebuf, iov, iovcnt);
+		STATS_ADD(writebuf, nbytes_written, retval);
+		return retval;
+	}
 
-/* //////////////////////////////////////////////////////////////////////// */
+	for ( i = 0; i < iovcnt; ++i ){
+		result  = writebuf_sink_write(
+			writebuf, iov[i].iov_base, iov[i].iov_len
+		);
+		retval += result;
+		if UNLIKELY ( result != iov[i].iov_len ){
+			break;
+		}
+	}
+	return retval;
+}
 
-#undef writebuf
-static NOINLINE size_t printf_int(
-	struct ASSPF_WriteBuf *writebuf, const char *, uintmax_t, size_t
+/* returns the number of 'src' bytes written */
+/* writes out the buffer, then 'src', sharing system calls between them */
+static NOINLINE size_t
+writebuf_gather(
+	struct ASSPF_WriteBuf *writebuf, const struct ASSPF_IOVec src[],
+	size_t srccnt
 )
 /*@globals	fileSystem@*/
 /*@modifies	fileSystem,
 		*writebuf
 @*/
-;
+{
+	struct SYSIOVEC iov[GATHER_IOVCNT_MAX];
+	size_t iovcnt, size, size_buf, nbytes_writ, writ_diff;
+	size_t retval = 0, size_src = 0;
+	size_t i = 0;
 
-#if UINT_LEAST16_MAX != UINT_LEAST8_MAX
-#define X_ASSPS_U16LEAST_NEEDED
-#endif
+	for ( i = 0; i < srccnt; ++i ){
+		size_src += src[i].size;
+	}
+	STATS_ADD(writebuf, nbypass, 1u);
+
+	i = 0;
+	do {	/* buffered bytes go first */
+		iovcnt   = 0;
+		size_buf = writebuf->nmemb;
+		if ( size_buf != 0 ){
+			iov[0].iov_base = writebuf->buf;
+			iov[0].iov_len  = size_buf;
+			iovcnt += 1u;
+		}
+		size = size_buf;
+		for ( ; (i < srccnt) && (iovcnt < GATHER_IOVCNT_MAX); ++i ){
+			/*@-temptrans@*/
+			iov[iovcnt].iov_base = (void *) src[i].base;
+			/*@=temptrans@*/
+			iov[iovcnt].iov_len  = src[i].size;
+			iovcnt += 1u;
+			size   += src[i].size;
+		}
 
-#if UINT_LEAST32_MAX != UINT_LEAST16_MAX
-#define X_ASSPS_U32LEAST_NEEDED
-#endif
-
-#if UINT_LEAST64_MAX != UINT_LEAST32_MAX
-#define X_ASSPS_U64LEAST_NEEDED
-#endif
+		nbytes_writ = writebuf_sink_writev(writebuf, iov, iovcnt);
+		assert(nbytes_writ <= size);
 
-#if UINTMAX_MAX != UINT_LEAST8_MAX  \
- && UINTMAX_MAX != UINT_LEAST16_MAX \
- && UINTMAX_MAX != UINT_LEAST32_MAX \
- && UINTMAX_MAX != UINT_LEAST64_MAX
-#define X_ASSPS_UINTMAX_NEEDED
-#endif
+		/* check if the write failed in the buffered bytes */
+		if UNLIKELY ( nbytes_writ < size_buf ){
+			writ_diff = size_buf - nbytes_writ;
+			if ( writebuf->policy != WRITEBUF_POLICY_BLOCK ){
+				writebuf->dropped += writ_diff;
+				writebuf->nmemb    = 0;
+				STATS_ADD(writebuf, nbytes_flushed, size_buf);
+			}
+			else {	(void) memmove(
+					writebuf->buf,
+					&writebuf->buf[nbytes_writ], writ_diff
+				);
+				writebuf->nmemb = writ_diff;
+				STATS_ADD(
+					writebuf, nbytes_flushed, nbytes_writ
+				);
+			}
+			break;
+		}
+		writebuf->nmemb = 0;
+		STATS_ADD(writebuf, nbytes_flushed, size_buf);
+		retval += nbytes_writ - size_buf;
 
-#if UINTPTR_MAX != UINT_LEAST8_MAX  \
- && UINTPTR_MAX != UINT_LEAST16_MAX \
- && UINTPTR_MAX != UINT_LEAST32_MAX \
- && UINTPTR_MAX != UINT_LEAST64_MAX \
- && UINTPTR_MAX != UINTMAX_MAX
-#define X_ASSPS_UINTPTR_NEEDED
-#endif
+		/* check if the write failed in 'src' */
+		if UNLIKELY ( nbytes_writ != size ){
+			break;
+		}
+	} while ( i < srccnt );
 
-/* ------------------------------------------------------------------------ */
+	if UNLIKELY (
+		(retval != size_src)
+	&&
+		(writebuf->policy != WRITEBUF_POLICY_BLOCK)
+	){
+		writebuf->dropped += size_src - retval;
+	}
+	return retval;
+}
 
-/* returns the number of bytes written to the writebuf */
-size_t
-asspf_printf_int8least(
-	struct ASSPF_WriteBuf *writebuf, const char *format,
-	uint_least8_t value
-)
+/* returns the number of chars written to the buffer */
+/* (the bytes go in as-is, even in binary mode) */
+static size_t
+writebuf_write(struct ASSPF_WriteBuf *writebuf, const void *src, size_t size)
 /*@globals	fileSystem@*/
 /*@modifies	fileSystem,
 		*writebuf
 @*/
 {
-	return printf_int(writebuf, format, (uintmax_t) value, sizeof value);
+	struct ASSPF_IOVec iov;
+	size_t nmemb;
+
+	/* check if the source is too big for the writebuf */
+	if UNLIKELY ( size > writebuf->limit ){
+		iov.base = src;
+		iov.size = size;
+		return writebuf_gather(writebuf, &iov, (size_t) 1u);
+	}
+
+	/* check if the writebuf needs to be flushed */
+	if ( size > writebuf->limit - writebuf->nmemb ){
+		nmemb = writebuf_flush(writebuf);
+		if UNLIKELY ( nmemb != 0 ){
+			return 0;
+		}
+	}
+
+	(void) memcpy(&writebuf->buf[writebuf->nmemb], src, size);
+	writebuf->nmemb += size;
+	return size;
 }
 
-#ifdef X_ASSPS_U16LEAST_NEEDED
-/* returns the number of bytes written to the writebuf */
-size_t
-asspf_printf_int16least(
-	struct ASSPF_WriteBuf *writebuf, const char *format,
-	uint_least16_t value
-)
+/* returns a pointer to 'size' unused bytes at the end of the buffer */
+/* returns NULL if 'size' is too big for the buffer, or the flush failed */
+/* (the bytes go in as-is, even in binary mode) */
+/*@null@*/ /*@dependent@*/ static char *
+writebuf_reserve(struct ASSPF_WriteBuf *writebuf, size_t size)
 /*@globals	fileSystem@*/
 /*@modifies	fileSystem,
 		*writebuf
 @*/
 {
-	return printf_int(writebuf, format, (uintmax_t) value, sizeof value);
+	size_t nmemb;
+
+	if UNLIKELY ( size > writebuf->limit ){
+		return NULL;
+	}
+
+	/* check if the writebuf needs to be flushed */
+	if ( size > writebuf->limit - writebuf->nmemb ){
+		nmemb = writebuf_flush(writebuf);
+		if UNLIKELY ( nmemb != 0 ){
+			return NULL;
+		}
+	}
+
+	return &writebuf->buf[writebuf->nmemb];
 }
-#endif	/* X_ASSPS_U16LEAST_NEEDED */
 
-#ifdef X_ASSPS_U32LEAST_NEEDED
-/* returns the number of bytes written to the writebuf */
-size_t
-asspf_printf_int32least(
-	struct ASSPF_WriteBuf *writebuf, const char *format,
-	uint_least32_t value
+/* ------------------------------------------------------------------------ */
+
+/* binary trace records (little-endian):
+	'S' [size (4 bytes)] [bytes]
+	'I' [format id (2 bytes)] [value size (1 byte)] [value]
+	'F' [format size (1 byte)] [format] [value size (1 byte)] [value]
+*/
+#define BINREC_TEXT		'S'
+#define BINREC_INT_ID		'I'
+#define BINREC_INT_FORMAT	'F'
+
+#define BINREC_TEXT_HDR_SIZE	5u
+
+/* returns the number of bytes written to 'dest' */
+static size_t
+binrec_le(/*@out@*/ char *dest, uintmax_t value, size_t size)
+/*@modifies	*dest@*/
+{
+	size_t i;
+
+	for ( i = 0; i < size; ++i ){
+		dest[i] = (char) (value & 0xFFu);
+		value >>= 4u;
+		value >>= 4u;
+	}
+	return size;
+}
+
+/* returns the number of bytes written to 'dest' */
+static size_t
+binrec_text_hdr(/*@out@*/ char *dest, size_t size)
+/*@modifies	*dest@*/
+{
+	dest[0] = BINREC_TEXT;
+	return 1u + binrec_le(&dest[1], (uintmax_t) size, (size_t) 4u);
+}
+
+/* returns the number of bytes written to the buffer */
+/* in binary mode, one text record for all of 'src' */
+static size_t
+binrec_put_text(
+	struct ASSPF_WriteBuf *writebuf, const void *src, size_t size
 )
 /*@globals	fileSystem@*/
 /*@modifies	fileSystem,
 		*writebuf
 @*/
 {
-	return printf_int(writebuf, format, (uintmax_t) value, sizeof value);
+	char hdr[BINREC_TEXT_HDR_SIZE];
+	struct ASSPF_IOVec iov[2u];
+	char *dest;
+	size_t nbytes_writ;
+
+	if UNLIKELY ( (uintmax_t) size > (uintmax_t) UINT32_MAX ){
+		return 0;
+	}
+
+	/* check if the record is too big for the writebuf */
+	/* (a buffer smaller than the header would wrap the subtraction) */
+	if UNLIKELY (
+		(writebuf->limit < sizeof hdr)
+	||
+		(size > writebuf->limit - sizeof hdr)
+	){
+		(void) binrec_text_hdr(hdr, size);
+		iov[0].base = hdr;
+		iov[0].size = sizeof hdr;
+		iov[1].base = src;
+		iov[1].size = size;
+		nbytes_writ = writebuf_gather(writebuf, iov, (size_t) 2u);
+		return (nbytes_writ > sizeof hdr
+			? nbytes_writ - sizeof hdr : 0
+		);
+	}
+
+	dest = writebuf_reserve(writebuf, sizeof hdr + size);
+	if UNLIKELY ( dest == NULL ){
+		return 0;
+	}
+	(void) binrec_text_hdr(dest, size);
+	(void) memcpy(&dest[sizeof hdr], src, size);
+	writebuf->nmemb += sizeof hdr + size;
+	return size;
 }
-#endif	/* X_ASSPS_U32LEAST_NEEDED */
 
-#ifdef X_ASSPS_U64LEAST_NEEDED
-/* returns the number of bytes written to the writebuf */
+/* ======================================================================== */
+
+/* returns 0 on success (always succeeds) */
+/* switches a writebuf in or out of binary (trace record) mode */
+int
+asspf_writebuf_binary(struct ASSPF_WriteBuf *writebuf, int enable)
+/*@modifies	*writebuf@*/
+{
+	if ( enable != 0 ){
+		writebuf->flags |= WRITEBUF_FLAG_BINARY;
+	}
+	else {	writebuf->flags &= ~WRITEBUF_FLAG_BINARY; }
+	return 0;
+}
+
+/* returns 0 on success */
+/* returns 1 if 'policy' is not one of ASSPF_POLICY_* */
+int
+asspf_writebuf_policy(
+	struct ASSPF_WriteBuf *writebuf, int policy, int policy_arg
+)
+/*@modifies	*writebuf@*/
+{
+	switch ( policy ){
+	case (int) WRITEBUF_POLICY_BLOCK:
+	case (int) WRITEBUF_POLICY_RETRY:
+	case (int) WRITEBUF_POLICY_POLL:
+	case (int) WRITEBUF_POLICY_DROP:
+		writebuf->policy     = (enum WriteBuf_Policy) policy;
+		writebuf->policy_arg = policy_arg;
+		return 0;
+	default:
+		return 1;
+	}
+}
+
+/* returns the number of bytes given up on by the flush policy */
 size_t
-asspf_printf_int64least(
-	struct ASSPF_WriteBuf *writebuf, const char *format,
-	uint_least64_t value
+asspf_writebuf_dropped(const struct ASSPF_WriteBuf *writebuf)
+/*@*/
+{
+	return writebuf->dropped;
+}
+
+#ifdef ASSPF_OPT_STATS
+/* returns 0 on success (always succeeds) */
+/* copies out the writebuf's counters */
+int
+asspf_writebuf_stats(
+	const struct ASSPF_WriteBuf *writebuf,
+	/*@out@*/ struct ASSPF_Stats *stats
 )
+/*@modifies	*stats@*/
+{
+	const struct WriteBuf_Stats *const ws = &writebuf->stats;
+
+	/* what is still in the buffer was buffered too */
+	stats->bytes_buffered	= ws->nbytes_flushed + writebuf->nmemb;
+	stats->bytes_written	= ws->nbytes_written;
+	stats->bytes_dropped	= writebuf->dropped;
+	stats->syscalls		= ws->nsyscalls;
+	stats->partial_writes	= ws->npartial;
+	stats->retries		= ws->nretries;
+	stats->bypass_writes	= ws->nbypass;
+	stats->format_errors	= ws->nformat_errors;
+	return 0;
+}
+#endif
+
+/* returns the number of chars written to the buffer */
+NOINLINE size_t
+asspf_write(struct ASSPF_WriteBuf *writebuf, const void *src, size_t size)
 /*@globals	fileSystem@*/
 /*@modifies	fileSystem,
 		*writebuf
 @*/
 {
-	return printf_int(writebuf, format, (uintmax_t) value, sizeof value);
+	if UNLIKELY ( (writebuf->flags & WRITEBUF_FLAG_BINARY) != 0 ){
+		return binrec_put_text(writebuf, src, size);
+	}
+	return writebuf_write(writebuf, src, size);
 }
-#endif	/* X_ASSPS_U64LEAST_NEEDED */
 
-#ifdef X_ASSPS_UINTMAX_NEEDED
-/* returns the number of bytes written to the writebuf */
-size_t
-asspf_printf_intmax(
-	struct ASSPF_WriteBuf *writebuf, const char *format, uintmax_t value
-)
+/* returns a pointer to 'size' unused bytes at the end of the buffer */
+/* returns NULL if 'size' is too big for the buffer, or the flush failed */
+/*@null@*/ /*@dependent@*/ char *
+asspf_reserve(struct ASSPF_WriteBuf *writebuf, size_t size)
 /*@globals	fileSystem@*/
 /*@modifies	fileSystem,
 		*writebuf
 @*/
 {
-	return printf_int(writebuf, format, (uintmax_t) value, sizeof value);
+	char *dest;
+
+	if UNLIKELY ( (writebuf->flags & WRITEBUF_FLAG_BINARY) != 0 ){
+		/* leave room for the text record header */
+		if UNLIKELY (
+			(writebuf->limit < BINREC_TEXT_HDR_SIZE)
+		||
+			(size > writebuf->limit - BINREC_TEXT_HDR_SIZE)
+		||
+			((uintmax_t) size > (uintmax_t) UINT32_MAX)
+		){
+			return NULL;
+		}
+		dest = writebuf_reserve(writebuf, BINREC_TEXT_HDR_SIZE + size);
+		return (dest != NULL ? &dest[BINREC_TEXT_HDR_SIZE] : NULL);
+	}
+	return writebuf_reserve(writebuf, size);
 }
-#endif /* X_ASSPS_UINTMAX_NEEDED */
 
-#ifdef X_ASSPS_UINTPTR_NEEDED
-/* returns the number of bytes written to the writebuf */
+/* returns the number of chars added to the buffer */
+/* 'size' must not be more than what was last reserved */
 size_t
-asspf_printf_intptr(
-	struct ASSPF_WriteBuf *writebuf, const char *format, uintptr_t value
+asspf_commit(struct ASSPF_WriteBuf *writebuf, size_t size)
+/*@modifies	*writebuf@*/
+{
+	if UNLIKELY ( (writebuf->flags & WRITEBUF_FLAG_BINARY) != 0 ){
+		assert(
+			BINREC_TEXT_HDR_SIZE + size
+			<=
+			writebuf->limit - writebuf->nmemb
+		);
+		writebuf->nmemb += binrec_text_hdr(
+			&writebuf->buf[writebuf->nmemb], size
+		);
+		writebuf->nmemb += size;
+		return size;
+	}
+
+	assert(size <= writebuf->limit - writebuf->nmemb);
+
+	writebuf->nmemb += size;
+	return size;
+}
+
+/* returns the number of chars written to the buffer */
+size_t
+asspf_writev(
+	struct ASSPF_WriteBuf *writebuf, const struct ASSPF_IOVec iov[],
+	size_t iovcnt
 )
 /*@globals	fileSystem@*/
 /*@modifies	fileSystem,
 		*writebuf
 @*/
 {
-	return printf_int(writebuf, format, (uintmax_t) value, sizeof value);
-}
-#endif /* X_ASSPS_UINTPTR_NEEDED */
-
-/* //////////////////////////////////////////////////////////////////////// */
+	size_t size = 0;
+	char *dest;
+	size_t i;
 
-/* checks if the targeted arch has an arithmetic (signed) right shift */
-#define HAS_ASR(Xtype)	( \
-	/*@-shiftimplementation@*/ \
-	(Xtype) (((Xtype) UINTMAX_MAX) >> 1u) == (Xtype) UINTMAX_MAX \
-	/*@=shiftimplementation@*/ \
-)
+	for ( i = 0; i < iovcnt; ++i ){
+		size += iov[i].size;
+	}
 
-/* returns 'value' arithmetically shifted 'count' bits right */
-ALWAYS_INLINE CONST intmax_t
-asr_imax(intmax_t x, uint_fast8_t k)
-/*@*/
-{
-	assert((size_t) k < (sizeof x) * CHAR_BIT);
+	/* check if the sources are too big for the writebuf */
+	if UNLIKELY (
+		((writebuf->flags & WRITEBUF_FLAG_BINARY) != 0)
+	&&
+		(
+			(writebuf->limit < BINREC_TEXT_HDR_SIZE)
+		||
+			(size > writebuf->limit - BINREC_TEXT_HDR_SIZE)
+		)
+	){
+		/* a text record each */
+		size = 0;
+		for ( i = 0; i < iovcnt; ++i ){
+			size += binrec_put_text(
+				writebuf, iov[i].base, iov[i].size
+			);
+		}
+		return size;
+	}
+	if UNLIKELY ( size > writebuf->limit ){
+		return writebuf_gather(writebuf, iov, iovcnt);
+	}
 
-	if ( HAS_ASR(intmax_t) ){
-		/*@-shiftimplementation@*/
-		return (intmax_t) (x >> k);
-		/*@=shiftimplementation@*/
+	dest = asspf_reserve(writebuf, size);
+	if UNLIKELY ( dest == NULL ){
+		return 0;
 	}
-	else {	return (x < 0
-			? (intmax_t) ~((~((uintmax_t) x)) >> k)
-			: (intmax_t) (((uintmax_t) x) >> k)
-		);
+	size = 0;
+	for ( i = 0; i < iovcnt; ++i ){
+		(void) memcpy(&dest[size], iov[i].base, iov[i].size);
+		size += iov[i].size;
 	}
+	return asspf_commit(writebuf, size);
 }
 
-/* returns 'value' arithmetically shifted 'count' bits left */
-ALWAYS_INLINE CONST intmax_t
-asl_imax(intmax_t x, uint_fast8_t k)
-/*@*/
-{
-	assert((size_t) k < (sizeof x) * CHAR_BIT);
-
-	return (intmax_t) (((uintmax_t) x) << k);
-}
+/* ------------------------------------------------------------------------ */
 
-/* returns the absolute value of an integer */
-ALWAYS_INLINE CONST uintmax_t
-abs_imax(intmax_t x)
+/* returns the index of the lowest set bit of 'mask' (which is not 0) */
+ALWAYS_INLINE CONST unsigned int
+mask_ctz(unsigned int mask)
 /*@*/
 {
-	/* the compiler does better with this than imaxabs() or bit-tricks */
-	return (x < 0 ? -((uintmax_t) x) : (uintmax_t) x);
-}
-
-/* returns the 'ilog10 + 1' of an integer */
-/* only used on pre-defined values (like a constexpr) */
-ALWAYS_INLINE CONST size_t
-ilog10p1(uintmax_t limit)
-/*@*/
-{	size_t retval = (size_t) 1u;
+#if HAS_BUILTIN(__builtin_ctz)
+	return (unsigned int) __builtin_ctz(mask);
+#else
+	unsigned int i = 0;
 
-	while ( (limit /= 10u) != 0 ){
-		++retval;
+	while ( (mask & 1u) == 0 ){
+		mask >>= 1u;
+		++i;
 	}
-	return retval;
+	return i;
+#endif
 }
 
-/* returns whether 'c' is a decimal digit */
-/* @note isdigit() is not on the whitelist */
-ALWAYS_INLINE CONST int
-ascii_isdigit(char c)
-/*@*/
-{
-	return (int) ((c >= '0') && (c <= '9'));
-}
+#ifdef HAVE_SIMD_SSE2
 
-/* returns the number of chars read from 'str' and sets '*dest' on success */
-/* returns 0 on error */
-/* @note atoi() is not on the whitelist */
-static size_t
-ascii_a2uint(const char *str, size_t limit, /*@out@*/ unsigned int *dest)
+/* returns the number of chars copied from 's' to 'dest' */
+/* copies up to 'size' chars of 's', stopping at its NUL (strlen() and
+   memcpy() in one pass, 16 bytes at a time) */
+/* whole blocks get stored while 'size' has room for them, NUL and all */
+/* @note the loads never cross into an unmapped page (4 KiB or bigger),
+   but they do read the bytes around 's' */
+static NO_SANITIZE_ADDRESS size_t
+simd_copy_str(/*@out@*/ char *dest, const char *s, size_t size)
 /*@modifies	*dest@*/
 {
-	const size_t ndigits_max = ilog10p1((uintmax_t) UINT_MAX);
-	size_t ndigits;
-	unsigned int power, number, temp;
-	size_t i;
-
-	/* count the digits */
-	for ( ndigits = 0; ndigits < limit; ++ndigits ){
-		if ( ascii_isdigit(str[ndigits]) == 0 ){
-			break;
+	const __m128i zero = _mm_setzero_si128();
+	const size_t  off  = (size_t) ((uintptr_t) s & 0xFu);
+	__m128i x;
+	unsigned int mask;
+	size_t i, n;
+
+	if LIKELY (
+		(size >= 16u)
+	&&
+		((size_t) ((uintptr_t) s & 0xFFFu) <= 0x1000u - 16u)
+	){
+		/* the first block, unaligned */
+		x    = _mm_loadu_si128((const __m128i *) s);
+		mask = (unsigned int) _mm_movemask_epi8(
+			_mm_cmpeq_epi8(x, zero)
+		);
+		_mm_storeu_si128((__m128i *) dest, x);
+		if ( mask != 0 ){
+			return (size_t) mask_ctz(mask);
 		}
 	}
-	if ( (ndigits == 0) || (ndigits > ndigits_max) ){
-		/*@-mustmod@*/ /*@-mustdefine@*/
+	else {	/* the aligned block 's' starts in, shifted down to 's' */
+		x    = _mm_load_si128((const __m128i *) ((uintptr_t) s - off));
+		mask = (unsigned int) _mm_movemask_epi8(
+			_mm_cmpeq_epi8(x, zero)
+		);
+		n    = 16u - off;
+		n    = (n < size ? n : size);
+		i    = (size_t) mask_ctz((mask >> off) | (1u << n));
+		(void) memcpy(dest, s, i);
+		if ( i != 16u - off ){
+			return i;
+		}
+	}
+
+	/* aligned from here on */
+	for ( i = 16u - off; size - i >= 16u; i += 16u ){
+		x    = _mm_load_si128((const __m128i *) &s[i]);
+		mask = (unsigned int) _mm_movemask_epi8(
+			_mm_cmpeq_epi8(x, zero)
+		);
+		_mm_storeu_si128((__m128i *) &dest[i], x);
+		if ( mask != 0 ){
+			return i + mask_ctz(mask);
+		}
+	}
+	if ( i < size ){
+		x    = _mm_load_si128((const __m128i *) &s[i]);
+		mask = (unsigned int) _mm_movemask_epi8(
+			_mm_cmpeq_epi8(x, zero)
+		);
+		n    = (size_t) mask_ctz(mask | (1u << (size - i)));
+		(void) memcpy(&dest[i], &s[i], n);
+		i   += n;
+	}
+	return i;
+}
+
+#endif	/* HAVE_SIMD_SSE2 */
+
+/* returns the number of chars written to the buffer */
+size_t
+asspf_puts(struct ASSPF_WriteBuf *writebuf, const char *s)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+{
+#ifdef HAVE_SIMD_SSE2
+	size_t retval = 0;
+	size_t n;
+
+	/* copy straight into the buffer, flushing each time it fills */
+	if LIKELY (
+		((writebuf->flags & WRITEBUF_FLAG_BINARY) == 0)
+	&&
+		(writebuf->limit != 0)
+	){
+		for (;;){
+			if UNLIKELY ( writebuf->nmemb == writebuf->limit ){
+				if UNLIKELY ( writebuf_flush(writebuf) != 0 ){
+					return retval;
+				}
+			}
+			n = simd_copy_str(
+				&writebuf->buf[writebuf->nmemb], &s[retval],
+				writebuf->limit - writebuf->nmemb
+			);
+			writebuf->nmemb += n;
+			retval          += n;
+			if ( s[retval] == '\0' ){
+				return retval;
+			}
+		}
+	}
+#endif
+	return asspf_write(writebuf, s, strlen(s));
+}
+
+/* returns the number of chars written to the buffer */
+size_t
+asspf_putc(struct ASSPF_WriteBuf *writebuf, char c)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+{
+	return asspf_write(writebuf, &c, sizeof c);
+}
+
+/* ------------------------------------------------------------------------ */
+
+/* what gets escaped, and how */
+#define ESCAPE_MODE_JSON	0	/* '"', '\\', 0x00-0x1F ("\u00XX") */
+#define ESCAPE_MODE_C		1	/* ... and 0x7F-0xFF ("\ooo") */
+
+#define ESCAPE_SIZE_MAX		6u	/* "\u00XX" */
+
+/* returns whether 'c' needs an escape */
+ALWAYS_INLINE CONST int
+escape_needed(char c, int mode)
+/*@*/
+{
+	const unsigned int u = (unsigned int) (unsigned char) c;
+
+	return (int) (
+		(u < 0x20u) || (c == '"') || (c == '\\')
+	||
+		((mode == ESCAPE_MODE_C) && (u >= 0x7Fu))
+	);
+}
+
+#ifdef HAVE_SIMD_SSE2
+/* returns a bit per byte of 'x' that needs an escape */
+ALWAYS_INLINE CONST unsigned int
+simd_escape_mask_16(__m128i x, int mode)
+/*@*/
+{
+	__m128i hit;
+
+	hit = _mm_or_si128(
+		_mm_cmpeq_epi8(x, _mm_set1_epi8('"')),
+		_mm_cmpeq_epi8(x, _mm_set1_epi8('\\'))
+	);
+	if ( mode == ESCAPE_MODE_C ){
+		/* signed, so 0x80-0xFF are below 0x20 too */
+		hit = _mm_or_si128(hit, _mm_or_si128(
+			_mm_cmplt_epi8(x, _mm_set1_epi8(0x20)),
+			_mm_cmpeq_epi8(x, _mm_set1_epi8(0x7F))
+		));
+	}
+	else {	/* unsigned x <= 0x1F */
+		hit = _mm_or_si128(hit, _mm_cmpeq_epi8(
+			_mm_max_epu8(x, _mm_set1_epi8(0x1F)),
+			_mm_set1_epi8(0x1F)
+		));
+	}
+	return (unsigned int) _mm_movemask_epi8(hit);
+}
+#endif
+
+#ifdef HAVE_SIMD_AVX2
+/* returns a bit per byte of 'x' that needs an escape */
+ALWAYS_INLINE CONST unsigned int
+simd_escape_mask_32(__m256i x, int mode)
+/*@*/
+{
+	__m256i hit;
+
+	hit = _mm256_or_si256(
+		_mm256_cmpeq_epi8(x, _mm256_set1_epi8('"')),
+		_mm256_cmpeq_epi8(x, _mm256_set1_epi8('\\'))
+	);
+	if ( mode == ESCAPE_MODE_C ){
+		hit = _mm256_or_si256(hit, _mm256_or_si256(
+			_mm256_cmpgt_epi8(_mm256_set1_epi8(0x20), x),
+			_mm256_cmpeq_epi8(x, _mm256_set1_epi8(0x7F))
+		));
+	}
+	else {	hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(
+			_mm256_max_epu8(x, _mm256_set1_epi8(0x1F)),
+			_mm256_set1_epi8(0x1F)
+		));
+	}
+	return (unsigned int) _mm256_movemask_epi8(hit);
+}
+#endif
+
+/* returns the number of chars at the start of 'src' that need no escape */
+ALWAYS_INLINE size_t
+escape_scan(const char *src, size_t size, int mode)
+/*@*/
+{
+	size_t i = 0;
+#ifdef HAVE_SIMD_SSE2
+	unsigned int mask;
+#endif
+
+#ifdef HAVE_SIMD_AVX2
+	for ( ; size - i >= 32u; i += 32u ){
+		mask = simd_escape_mask_32(
+			_mm256_loadu_si256((const __m256i *) &src[i]), mode
+		);
+		if ( mask != 0 ){
+			return i + mask_ctz(mask);
+		}
+	}
+#endif
+#ifdef HAVE_SIMD_SSE2
+	for ( ; size - i >= 16u; i += 16u ){
+		mask = simd_escape_mask_16(
+			_mm_loadu_si128((const __m128i *) &src[i]), mode
+		);
+		if ( mask != 0 ){
+			return i + mask_ctz(mask);
+		}
+	}
+#endif
+	for ( ; i < size; ++i ){
+		if ( escape_needed(src[i], mode) ){
+			break;
+		}
+	}
+	return i;
+}
+
+/* returns the number of chars written to 'dest' (at most ESCAPE_SIZE_MAX) */
+static size_t
+escape_put_char(/*@out@*/ char *dest, char c, int mode)
+/*@modifies	*dest@*/
+{
+	const unsigned int u = (unsigned int) (unsigned char) c;
+	char e;
+
+	switch ( c ){
+	case '"':	e = '"';	break;
+	case '\\':	e = '\\';	break;
+	case '\b':	e = 'b';	break;
+	case '\f':	e = 'f';	break;
+	case '\n':	e = 'n';	break;
+	case '\r':	e = 'r';	break;
+	case '\t':	e = 't';	break;
+	case '\a':	e = (mode == ESCAPE_MODE_C ? 'a' : '\0');	break;
+	case '\v':	e = (mode == ESCAPE_MODE_C ? 'v' : '\0');	break;
+	default:	e = '\0';	break;
+	}
+
+	dest[0] = '\\';
+	if ( e != '\0' ){
+		dest[1] = e;
+		return (size_t) 2u;
+	}
+	if ( mode == ESCAPE_MODE_C ){
+		/* always 3 octal digits, so a digit after it cannot join in */
+		dest[1] = (char) ('0' + (u >> 6u));
+		dest[2] = (char) ('0' + ((u >> 3u) & 07u));
+		dest[3] = (char) ('0' + (u & 07u));
+		return (size_t) 4u;
+	}
+	dest[1] = 'u';
+	dest[2] = '0';
+	dest[3] = '0';
+	dest[4] = "0123456789abcdef"[u >> 4u];
+	dest[5] = "0123456789abcdef"[u & 0xFu];
+	return (size_t) 6u;
+}
+
+/* returns the number of chars written to 'dest' */
+/* escapes as much of 'src' (from '*idx' on) as fits in 'size' chars */
+ALWAYS_INLINE size_t
+escape_fill(
+	/*@out@*/ char *dest, size_t size, const char *src, size_t src_size,
+	size_t *idx, int mode
+)
+/*@modifies	*dest,
+		*idx
+@*/
+{
+	size_t i = *idx;
+	size_t n = 0;
+	size_t run;
+
+	while ( i < src_size ){
+		if ( escape_needed(src[i], mode) ){
+			if ( size - n < ESCAPE_SIZE_MAX ){
+				break;
+			}
+			n += escape_put_char(&dest[n], src[i++], mode);
+			continue;
+		}
+		/* copy the clean run in one go */
+		run = src_size - i;
+		run = escape_scan(
+			&src[i], (run < size - n ? run : size - n), mode
+		);
+		if ( run == 0 ){
+			break;
+		}
+		(void) memcpy(&dest[n], &src[i], run);
+		n += run;
+		i += run;
+	}
+	*idx = i;
+	return n;
+}
+
+/* returns the number of chars written to the buffer */
+/* escapes straight into the buffer, a reservation at a time */
+ALWAYS_INLINE size_t
+escape_write(
+	struct ASSPF_WriteBuf *writebuf, const char *src, size_t size,
+	int mode
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+{
+	const size_t hdr_size = ((writebuf->flags & WRITEBUF_FLAG_BINARY) != 0
+		? (size_t) BINREC_TEXT_HDR_SIZE : 0
+	);
+	char tmp[ESCAPE_SIZE_MAX];
+	size_t retval = 0, i = 0;
+	size_t room, n;
+	char *dest;
+
+	while ( i < size ){
+		if LIKELY ( writebuf->limit >= hdr_size + ESCAPE_SIZE_MAX ){
+			/* what is left of the buffer (or all of it, flushed) */
+			room = writebuf->limit - writebuf->nmemb;
+			room = (room >= hdr_size + ESCAPE_SIZE_MAX
+				? room : writebuf->limit
+			);
+			room = (room - hdr_size > (size_t) UINT32_MAX
+				? (size_t) UINT32_MAX : room - hdr_size
+			);
+			dest = asspf_reserve(writebuf, room);
+			if UNLIKELY ( dest == NULL ){
+				break;
+			}
+			retval += asspf_commit(
+				writebuf,
+				escape_fill(dest, room, src, size, &i, mode)
+			);
+		}
+		else {	/* too small a buffer to escape into */
+			n = escape_fill(tmp, sizeof tmp, src, size, &i, mode);
+			if UNLIKELY ( asspf_write(writebuf, tmp, n) != n ){
+				break;
+			}
+			retval += n;
+		}
+	}
+	return retval;
+}
+
+/* returns the number of chars written to the buffer */
+/* writes 'src' escaped for the inside of a JSON string ('"' and '\\' get a
+   backslash, control chars "\n"-style or "\u00XX"; the rest is as-is) */
+size_t
+asspf_put_json_string(
+	struct ASSPF_WriteBuf *writebuf, const char *src, size_t size
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+{
+	return escape_write(writebuf, src, size, ESCAPE_MODE_JSON);
+}
+
+/* returns the number of chars written to the buffer */
+/* writes 'src' escaped for the inside of a C string literal ('"' and '\\'
+   get a backslash, control chars "\n"-style or octal, as do 0x7F-0xFF) */
+size_t
+asspf_put_c_escaped(
+	struct ASSPF_WriteBuf *writebuf, const char *src, size_t size
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+{
+	return escape_write(writebuf, src, size, ESCAPE_MODE_C);
+}
+
+/* ------------------------------------------------------------------------ */
+
+/* max bytes per sendfile(2)/splice(2) */
+#define COPY_FD_CHUNK_SIZE	((size_t) 0x100000u)
+
+/* returns the number of bytes copied */
+/* copies 'src_fd' (up to 'max_bytes', or its end) into the writebuf */
+/* a plain fd writebuf gets flushed, then the kernel moves the bytes itself;
+   otherwise (or if the kernel refuses) they go through the buffer */
+size_t
+asspf_copy_fd(struct ASSPF_WriteBuf *writebuf, int src_fd, size_t max_bytes)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+{
+	size_t retval = 0, size, result;
+	char *dest;
+#ifdef SENDFILE
+	int use_splice = FALSE;
+	int ntries     = 0;
+
+	if (
+		(writebuf->sinktype == WRITEBUF_SINK_FD)
+	&&
+		((writebuf->flags & WRITEBUF_FLAG_BINARY) == 0)
+	){
+		if UNLIKELY ( writebuf_flush(writebuf) != 0 ){
+			return 0;
+		}
+
+		while ( retval < max_bytes ){
+			size   = max_bytes - retval;
+			size   = (size > COPY_FD_CHUNK_SIZE
+				? COPY_FD_CHUNK_SIZE : size
+			);
+			result = (use_splice
+				? SPLICE(src_fd, writebuf->fd, size)
+				: SENDFILE(writebuf->fd, src_fd, size)
+			);
+			STATS_ADD(writebuf, nsyscalls, 1u);
+			if LIKELY ( result != SIZE_MAX ){
+				if ( result == 0 ){
+					return retval;	/* EOF */
+				}
+				STATS_ADD(writebuf, nbytes_written, result);
+				retval += result;
+				continue;
+			}
+
+			/* splice(2) wants a pipe on one end;
+			   sendfile(2) wants a file it can map on the other */
+			if ( (errno == EINVAL) || (errno == ENOSYS) ){
+				if ( ! use_splice ){
+					use_splice = TRUE;
+					continue;
+				}
+				break;
+			}
+			if ( ! sys_write_again(
+				writebuf->fd, writebuf->policy,
+				writebuf->policy_arg, &ntries
+			) ){
+				return retval;
+			}
+			STATS_ADD(writebuf, nretries, 1u);
+		}
+	}
+#endif	/* SENDFILE */
+
+	/* read into the buffer, a half-buffer at a time */
+	while ( retval < max_bytes ){
+		size = max_bytes - retval;
+		size = (size > writebuf->limit / 2u
+			? writebuf->limit / 2u : size
+		);
+		dest = asspf_reserve(writebuf, size);
+		if UNLIKELY ( (size == 0) || (dest == NULL) ){
+			break;
+		}
+
+		result = READ(src_fd, dest, size);
+		if UNLIKELY ( result == SIZE_MAX ){
+			if ( errno == EINTR ){
+				continue;
+			}
+			break;
+		}
+		if ( result == 0 ){
+			break;	/* EOF */
+		}
+		(void) asspf_commit(writebuf, result);
+		retval += result;
+	}
+
+	return retval;
+}
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/* returns whether 'c' is a decimal digit */
+/* @note isdigit() is not on the whitelist */
+ALWAYS_INLINE CONST int
+ascii_isdigit(char c)
+/*@*/
+{
+	return (int) ((c >= '0') && (c <= '9'));
+}
+
+/* returns whether 'c' is whitespace in the "C" locale */
+/* @note isspace() is not on the whitelist */
+ALWAYS_INLINE CONST int
+ascii_isspace(char c)
+/*@*/
+{
+	return (int) ((c == ' ') || ((c >= '\t') && (c <= '\r')));
+}
+
+/* returns the value of 'c' as a hex digit, or 16 if it is not one */
+ALWAYS_INLINE CONST unsigned int
+ascii_xdigit(char c)
+/*@*/
+{
+	if ( ascii_isdigit(c) != 0 ){
+		return (unsigned int) (c - '0');
+	}
+	c |= (char) 0x20;	/* tolower */
+	if ( (c >= 'a') && (c <= 'f') ){
+		return (unsigned int) (c - 'a') + 10u;
+	}
+	return 16u;
+}
+
+/* returns the number of digits read from 'str' (0 if there are none) */
+/* a value over 'max' sets '*overflow' and saturates '*dest' at 'max' */
+/* the digits carry on from 'number' (0 to start a new one) */
+/* @note strtoul() is not on the whitelist */
+static size_t
+ascii_a2umax(
+	const char *str, size_t limit, unsigned int base, uintmax_t max,
+	uintmax_t number, /*@out@*/ uintmax_t *dest, /*@out@*/ int *overflow
+)
+/*@modifies	*dest,
+		*overflow
+@*/
+{
+	const uintmax_t cutoff = max / base;
+	const unsigned int cutlim = (unsigned int) (max % base);
+	unsigned int digit;
+	size_t ndigits;
+
+	*overflow = FALSE;
+	for ( ndigits = 0; ndigits < limit; ++ndigits ){
+		digit = ascii_xdigit(str[ndigits]);
+		if ( digit >= base ){
+			break;
+		}
+		if UNLIKELY (
+			(number > cutoff)
+		||
+			((number == cutoff) && (digit > cutlim))
+		){
+			*overflow = TRUE;
+			number    = max;
+			continue;	/* eat the rest of the digits */
+		}
+		number = number * base + digit;
+	}
+
+	*dest = number;
+	return ndigits;
+}
+
+/* returns the number of chars read from 'str' (0 if there is no number,
+   or 'base' is not 0 or 2 to 16) */
+/* base 0 is hex with a "0x" prefix, else decimal;
+   base 16 allows the prefix */
+/* '*radix' gets the base the digits were read in */
+static size_t
+ascii_a2umax_base(
+	const char *str, size_t limit, int base, uintmax_t max,
+	/*@out@*/ uintmax_t *dest, /*@out@*/ int *overflow,
+	/*@out@*/ unsigned int *radix
+)
+/*@modifies	*dest,
+		*overflow,
+		*radix
+@*/
+{
+	size_t ndigits;
+
+	if UNLIKELY ( (base != 0) && ((base < 2) || (base > 16)) ){
+		/*@-mustdefine@*/
 		return 0;
-		/*@=mustmod@*/ /*@=mustdefine@*/
+		/*@=mustdefine@*/
+	}
+
+	if (
+		((base == 0) || (base == 16))
+	&&
+		(limit > 2u) && (str[0] == '0')
+	&&
+		((str[1] == 'x') || (str[1] == 'X'))
+	&&
+		(ascii_xdigit(str[2]) < 16u)
+	){
+		*radix  = 16u;
+		ndigits = ascii_a2umax(
+			&str[2], limit - 2u, 16u, max, 0, dest, overflow
+		);
+		return ndigits + 2u;
+	}
+
+	*radix = (base == 0 ? 10u : (unsigned int) base);
+	return ascii_a2umax(str, limit, *radix, max, 0, dest, overflow);
+}
+
+/* "00" to "99", for writing decimal two digits at a time */
+static const char digit_pairs[200u] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+/* ======================================================================== */
+
+/* returns a defined struct */
+ALWAYS_INLINE CONST struct ASSPF_ReadBuf
+readbuf_get(char *buf, size_t size, int fd)
+/*@*/
+{
+	struct ASSPF_ReadBuf retval;
+
+	retval.buf	= buf;
+	retval.limit	= size;
+	retval.idx	= 0;
+	retval.nmemb	= 0;
+	retval.fd	= fd;
+	retval.eof	= (int) (fd < 0);
+
+	return retval;
+}
+
+/* returns 0 on success */
+int
+asspf_readbuf_autoinit(
+	/*@out@*/ struct ASSPF_ReadBuf *readbuf, int fd,
+	/*@reldef@*/ char *buf, size_t limit
+)
+/*@modifies	*readbuf@*/
+{
+	*readbuf = readbuf_get(buf, limit, fd);
+	return 0;
+}
+
+/* returns 0 on success */
+/* on failure, the readbuf is still defined, but empty */
+int
+asspf_readbuf_open(
+	/*@out@*/ struct ASSPF_ReadBuf *readbuf, const char *path,
+	/*@reldef@*/ char *buf, size_t limit
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*readbuf
+@*/
+{
+	*readbuf = readbuf_get(buf, limit, OPEN_RDONLY(path));
+	return (int) (readbuf->fd < 0);
+}
+
+/* returns 0 on success */
+int
+asspf_readbuf_close(struct ASSPF_ReadBuf *readbuf)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*readbuf
+@*/
+{
+	int retval;
+
+	if ( readbuf->fd < 0 ){
+		return 0;
+	}
+	retval = CLOSE(readbuf->fd);
+
+	readbuf->fd  = -1;
+	readbuf->eof = TRUE;
+	return retval;
+}
+
+/* ------------------------------------------------------------------------ */
+
+/* returns the number of bytes added to the buffer (0 at the end) */
+/* moves the unread bytes to the front first */
+static size_t
+readbuf_fill(struct ASSPF_ReadBuf *readbuf)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*readbuf
+@*/
+{
+	size_t nbytes_read;
+
+	if ( readbuf->idx != 0 ){
+		(void) memmove(
+			readbuf->buf, &readbuf->buf[readbuf->idx],
+			readbuf->nmemb - readbuf->idx
+		);
+		readbuf->nmemb -= readbuf->idx;
+		readbuf->idx    = 0;
+	}
+	if ( (readbuf->eof != 0) || (readbuf->nmemb == readbuf->limit) ){
+		return 0;
+	}
+
+	do {	nbytes_read = READ(
+			readbuf->fd, &readbuf->buf[readbuf->nmemb],
+			readbuf->limit - readbuf->nmemb
+		);
+	} while UNLIKELY ( (nbytes_read == SIZE_MAX) && (errno == EINTR) );
+
+	if ( (nbytes_read == 0) || (nbytes_read == SIZE_MAX) ){
+		readbuf->eof = TRUE;
+		return 0;
+	}
+	readbuf->nmemb += nbytes_read;
+	return nbytes_read;
+}
+
+/* returns the length of the token at 'buf[idx]' (0 at the end) */
+/* skips whitespace, then buffers the whole token (if it fits) */
+static size_t
+readbuf_token_peek(struct ASSPF_ReadBuf *readbuf)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*readbuf
+@*/
+{
+	size_t len = 0;
+
+	for (;;){
+		while (
+			(readbuf->idx < readbuf->nmemb)
+		&&
+			(ascii_isspace(readbuf->buf[readbuf->idx]) != 0)
+		){
+			++readbuf->idx;
+		}
+		if ( readbuf->idx < readbuf->nmemb ){
+			break;
+		}
+		if ( readbuf_fill(readbuf) == 0 ){
+			return 0;
+		}
+	}
+
+	for (;;){
+		while (
+			(readbuf->idx + len < readbuf->nmemb)
+		&&
+			(ascii_isspace(readbuf->buf[readbuf->idx + len]) == 0)
+		){
+			++len;
+		}
+		if (
+			(readbuf->idx + len < readbuf->nmemb)
+		||
+			(readbuf_fill(readbuf) == 0)
+		){
+			return len;
+		}
+	}
+}
+
+/* returns the number of chars read (0 if there is no number) */
+/* reads the number in the 'len'-byte token readbuf_token_peek() found,
+   after its sign ('sign' bytes) */
+/* the digits can run past the end of a full buffer: they carry on
+   after a refill, so only a real overflow sets '*overflow' */
+static size_t
+readbuf_a2umax(
+	struct ASSPF_ReadBuf *readbuf, size_t len, size_t sign, int base,
+	uintmax_t max, /*@out@*/ uintmax_t *dest, /*@out@*/ int *overflow
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*readbuf,
+		*dest,
+		*overflow
+@*/
+{
+	unsigned int radix;
+	size_t retval, nread;
+	int overflow_more;
+
+	retval = ascii_a2umax_base(
+		&readbuf->buf[readbuf->idx + sign], len - sign, base, max,
+		dest, overflow, &radix
+	);
+	if ( retval == 0 ){
+		return 0;
+	}
+	retval       += sign;
+	readbuf->idx += retval;
+
+	while (
+		(readbuf->idx == readbuf->nmemb) && (readbuf_fill(readbuf) != 0)
+	){
+		nread = ascii_a2umax(
+			&readbuf->buf[readbuf->idx],
+			readbuf->nmemb - readbuf->idx, radix, max, *dest,
+			dest, &overflow_more
+		);
+		*overflow    |= overflow_more;
+		readbuf->idx += nread;
+		retval       += nread;
+	}
+	return retval;
+}
+
+/* ------------------------------------------------------------------------ */
+
+/* returns the number of bytes copied to 'dest' */
+/* (less than 'size' only at the end of the input) */
+size_t
+asspf_read(struct ASSPF_ReadBuf *readbuf, /*@out@*/ void *dest, size_t size)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*readbuf,
+		*dest
+@*/
+{
+	size_t retval = 0, avail;
+
+	while ( retval < size ){
+		avail = readbuf->nmemb - readbuf->idx;
+		if ( avail == 0 ){
+			if ( readbuf_fill(readbuf) == 0 ){
+				break;
+			}
+			continue;
+		}
+		avail = (avail > size - retval ? size - retval : avail);
+		(void) memcpy(
+			&((char *) dest)[retval], &readbuf->buf[readbuf->idx],
+			avail
+		);
+		readbuf->idx += avail;
+		retval       += avail;
+	}
+	return retval;
+}
+
+/* returns a pointer to the next line (without its newline) in the buffer,
+   or NULL at the end of the input */
+/* a line longer than the buffer comes back a bufferful at a time */
+/*@null@*/ /*@dependent@*/
+char *
+asspf_readline(struct ASSPF_ReadBuf *readbuf, /*@out@*/ size_t *len)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*readbuf,
+		*len
+@*/
+{
+	const char *newline;
+	size_t nscanned = 0;
+	char *retval;
+
+	for (;;){
+		newline = memchr(
+			&readbuf->buf[readbuf->idx + nscanned], '\n',
+			readbuf->nmemb - readbuf->idx - nscanned
+		);
+		if ( newline != NULL ){
+			retval        = &readbuf->buf[readbuf->idx];
+			*len          = (size_t) (newline - retval);
+			readbuf->idx += *len + 1u;
+			return retval;
+		}
+		nscanned = readbuf->nmemb - readbuf->idx;
+		if ( readbuf_fill(readbuf) == 0 ){
+			break;
+		}
+	}
+
+	*len = nscanned;
+	if ( nscanned == 0 ){
+		return NULL;
+	}
+	retval       = &readbuf->buf[readbuf->idx];
+	readbuf->idx = readbuf->nmemb;
+	return retval;
+}
+
+/* returns a pointer to the next whitespace-separated token in the buffer,
+   or NULL at the end of the input */
+/* a token longer than the buffer comes back a bufferful at a time */
+/*@null@*/ /*@dependent@*/
+char *
+asspf_readtoken(struct ASSPF_ReadBuf *readbuf, /*@out@*/ size_t *len)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*readbuf,
+		*len
+@*/
+{
+	char *retval;
+
+	*len = readbuf_token_peek(readbuf);
+	if ( *len == 0 ){
+		return NULL;
+	}
+	retval        = &readbuf->buf[readbuf->idx];
+	readbuf->idx += *len;
+	return retval;
+}
+
+/* ------------------------------------------------------------------------ */
+
+/* returns READBUF_PARSE_OK, READBUF_PARSE_NONE, or READBUF_PARSE_RANGE */
+/* reads an unsigned integer (after any whitespace) */
+int
+asspf_read_u64(
+	struct ASSPF_ReadBuf *readbuf, int base,
+	/*@out@*/ uint_least64_t *dest
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*readbuf,
+		*dest
+@*/
+{
+	const size_t len = readbuf_token_peek(readbuf);
+	const char *str  = &readbuf->buf[readbuf->idx];
+	uintmax_t number;
+	size_t nread, sign = 0;
+	int overflow;
+
+	if ( (len != 0) && (str[0] == '+') ){
+		sign = 1u;
+	}
+	nread = readbuf_a2umax(
+		readbuf, len, sign, base, (uintmax_t) UINT_LEAST64_MAX,
+		&number, &overflow
+	);
+	if ( nread == 0 ){
+		/*@-mustdefine@*/
+		return READBUF_PARSE_NONE;
+		/*@=mustdefine@*/
+	}
+
+	*dest = (uint_least64_t) number;
+	return (overflow != 0 ? READBUF_PARSE_RANGE : READBUF_PARSE_OK);
+}
+
+/* returns READBUF_PARSE_OK, READBUF_PARSE_NONE, or READBUF_PARSE_RANGE */
+/* reads a signed integer (after any whitespace) */
+int
+asspf_read_i64(
+	struct ASSPF_ReadBuf *readbuf, int base,
+	/*@out@*/ int_least64_t *dest
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*readbuf,
+		*dest
+@*/
+{
+	const size_t len = readbuf_token_peek(readbuf);
+	const char *str  = &readbuf->buf[readbuf->idx];
+	uintmax_t number, max = (uintmax_t) INT_LEAST64_MAX;
+	size_t nread, sign = 0;
+	int overflow, negative = FALSE;
+
+	if ( (len != 0) && ((str[0] == '+') || (str[0] == '-')) ){
+		negative = (int) (str[0] == '-');
+		sign     = 1u;
+		max     += (uintmax_t) negative;	/* -INT_LEAST64_MIN */
+	}
+	nread = readbuf_a2umax(
+		readbuf, len, sign, base, max, &number, &overflow
+	);
+	if ( nread == 0 ){
+		/*@-mustdefine@*/
+		return READBUF_PARSE_NONE;
+		/*@=mustdefine@*/
+	}
+
+	if ( negative != 0 ){
+		/* two's complement, without overflowing on the minimum */
+		*dest = (number != 0
+			? -((int_least64_t) (number - 1u)) - 1
+			: 0
+		);
+	}
+	else {	*dest = (int_least64_t) number; }
+	return (overflow != 0 ? READBUF_PARSE_RANGE : READBUF_PARSE_OK);
+}
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+#define TIMESTAMP_PREFIX_LEN	17u	/* "YYYY-MM-DDTHH:MM:" */
+#define TIMESTAMP_SUFFIX_LEN	13u	/* "SS.nnnnnnnnnZ" */
+#define TIMESTAMP_SIZE_MAX	32u
+
+/* realtime seconds of 0000-01-01T00:00:00Z and 9999-12-31T23:59:59Z */
+#define TIMESTAMP_SEC_MIN	INT64_C(-62167219200)
+#define TIMESTAMP_SEC_MAX	INT64_C(253402300799)
+
+/* writes 'value' to 'dest' as 'ndigits' decimal digits, zero-padded */
+static void
+timestamp_put_digits(/*@out@*/ char *dest, unsigned long value, size_t ndigits)
+/*@modifies	*dest@*/
+{
+	/* two digits at a time */
+	while ( ndigits >= 2u ){
+		ndigits -= 2u;
+		(void) memcpy(
+			&dest[ndigits], &digit_pairs[2u * (value % 100u)],
+			(size_t) 2u
+		);
+		value /= 100u;
+	}
+	if ( ndigits != 0 ){
+		dest[0] = (char) ('0' + (char) (value % 10u));
+	}
+	return;
+}
+
+/* writes "YYYY-MM-DDTHH:MM:" for 'minutes' since the epoch to 'dest' */
+/* @note gmtime() is not on the whitelist */
+static void
+timestamp_format_prefix(/*@out@*/ char *dest, int_least64_t minutes)
+/*@modifies	*dest@*/
+{
+	int_least64_t days, era, year;
+	uint_least64_t doe, yoe, doy, mp, month, day, mod;
+
+	days = (minutes >= 0 ? minutes : minutes - 1439) / 1440;
+	mod  = (uint_least64_t) (minutes - days * 1440);
+
+	/* civil-from-days, in 400-year eras starting on March 1st
+	   (H. Hinnant, "chrono-Compatible Low-Level Date Algorithms") */
+	days += 719468;
+	era   = (days >= 0 ? days : days - 146096) / 146097;
+	doe   = (uint_least64_t) (days - era * 146097);
+	yoe   = (doe - doe / 1460u + doe / 36524u - doe / 146096u) / 365u;
+	doy   = doe - (365u * yoe + yoe / 4u - yoe / 100u);
+	mp    = (5u * doy + 2u) / 153u;
+	day   = doy - (153u * mp + 2u) / 5u + 1u;
+	month = (mp < 10u ? mp + 3u : mp - 9u);
+	year  = (int_least64_t) yoe + era * 400 + (int_least64_t) (month <= 2u);
+
+	timestamp_put_digits(&dest[ 0u], (unsigned long) year, (size_t) 4u);
+	dest[ 4u] = '-';
+	timestamp_put_digits(&dest[ 5u], (unsigned long) month, (size_t) 2u);
+	dest[ 7u] = '-';
+	timestamp_put_digits(&dest[ 8u], (unsigned long) day, (size_t) 2u);
+	dest[10u] = 'T';
+	timestamp_put_digits(
+		&dest[11u], (unsigned long) mod / 60u, (size_t) 2u
+	);
+	dest[13u] = ':';
+	timestamp_put_digits(
+		&dest[14u], (unsigned long) mod % 60u, (size_t) 2u
+	);
+	dest[16u] = ':';
+	return;
+}
+
+#ifdef HAVE_ATOMICS
+
+/* returns TRUE if 'dest' got the cached prefix for 'minute' */
+/* never waits: a cache in the middle of a refill is a miss */
+static int
+timecache_load(
+	struct ASSPF_TimeCache *cache, uint64_t minute,
+	/*@out@*/ char *dest
+)
+/*@modifies	*dest@*/
+{
+	uint64_t prefix[3u];
+	uint64_t seq;
+
+	seq = ATOMIC_LOAD_ACQ(&cache->seq);
+	if ( (seq == 0) || ((seq & 1u) != 0) ){
+		/*@-mustdefine@*/
+		return FALSE;
+		/*@=mustdefine@*/
+	}
+	if ( ATOMIC_LOAD_RLX(&cache->minute) != minute ){
+		/*@-mustdefine@*/
+		return FALSE;
+		/*@=mustdefine@*/
+	}
+	prefix[0u] = ATOMIC_LOAD_RLX(&cache->prefix[0u]);
+	prefix[1u] = ATOMIC_LOAD_RLX(&cache->prefix[1u]);
+	prefix[2u] = ATOMIC_LOAD_RLX(&cache->prefix[2u]);
+	ATOMIC_FENCE_ACQ();
+	if ( ATOMIC_LOAD_RLX(&cache->seq) != seq ){
+		/*@-mustdefine@*/
+		return FALSE;
+		/*@=mustdefine@*/
+	}
+
+	(void) memcpy(dest, prefix, (size_t) TIMESTAMP_PREFIX_LEN);
+	return TRUE;
+}
+
+/* refills the cache, unless someone else is (maybe the code that a signal
+   handler calling this interrupted) */
+static void
+timecache_store(
+	struct ASSPF_TimeCache *cache, uint64_t minute, const char *src
+)
+/*@modifies	*cache@*/
+{
+	uint64_t prefix[3u];
+	uint64_t seq;
+
+	seq = ATOMIC_LOAD_RLX(&cache->seq);
+	if ( ((seq & 1u) != 0) || (! ATOMIC_CAS_ACQREL(
+		&cache->seq, &seq, seq + 1u
+	)) ){
+		return;
+	}
+	ATOMIC_FENCE_REL();
+
+	prefix[2u] = 0;
+	(void) memcpy(prefix, src, (size_t) TIMESTAMP_PREFIX_LEN);
+	ATOMIC_STORE_RLX(&cache->minute, minute);
+	ATOMIC_STORE_RLX(&cache->prefix[0u], prefix[0u]);
+	ATOMIC_STORE_RLX(&cache->prefix[1u], prefix[1u]);
+	ATOMIC_STORE_RLX(&cache->prefix[2u], prefix[2u]);
+
+	ATOMIC_STORE_REL(&cache->seq, seq + 2u);
+	return;
+}
+
+#endif	/* HAVE_ATOMICS */
+
+/* ------------------------------------------------------------------------ */
+
+/* returns the number of bytes written to the writebuf,
+   or 0 if the time does not fit its format */
+/* realtime:  "YYYY-MM-DDTHH:MM:SS.nnnnnnnnnZ" (RFC 3339, UTC)
+   monotonic: "S.nnnnnnnnn" */
+size_t
+asspf_put_time(
+	struct ASSPF_WriteBuf *writebuf, int clock_id, int_least64_t sec,
+	long nsec, /*@null@*/ struct ASSPF_TimeCache *cache
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf,
+		*cache
+@*/
+{
+	char str[TIMESTAMP_SIZE_MAX];
+	int_least64_t minutes;
+	size_t len, i;
+
+	if UNLIKELY ( (nsec < 0) || (nsec > 999999999L) ){
+		return 0;
+	}
+
+	if ( clock_id == TIMESTAMP_CLOCK_MONOTONIC ){
+		if UNLIKELY ( sec < 0 ){
+			return 0;
+		}
+		/* the seconds go in backwards, ahead of the fraction */
+		i = TIMESTAMP_SIZE_MAX - 10u;
+		do {	str[--i] = (char) ('0' + (char) (sec % 10));
+			sec /= 10;
+		} while ( sec != 0 );
+		str[TIMESTAMP_SIZE_MAX - 10u] = '.';
+		timestamp_put_digits(
+			&str[TIMESTAMP_SIZE_MAX - 9u], (unsigned long) nsec,
+			(size_t) 9u
+		);
+		return asspf_write(writebuf, &str[i], TIMESTAMP_SIZE_MAX - i);
+	}
+	if UNLIKELY ( clock_id != TIMESTAMP_CLOCK_REALTIME ){
+		return 0;
+	}
+	if UNLIKELY ( (sec < TIMESTAMP_SEC_MIN) || (sec > TIMESTAMP_SEC_MAX) ){
+		return 0;
+	}
+
+	minutes = (sec >= 0 ? sec : sec - 59) / 60;
+#ifdef HAVE_ATOMICS
+	if (
+		(cache == NULL)
+	||
+		(! timecache_load(cache, (uint64_t) minutes, str))
+	){
+		timestamp_format_prefix(str, minutes);
+		if ( cache != NULL ){
+			timecache_store(cache, (uint64_t) minutes, str);
+		}
+	}
+#else
+	(void) cache;
+	timestamp_format_prefix(str, minutes);
+#endif
+
+	len = TIMESTAMP_PREFIX_LEN;
+	timestamp_put_digits(
+		&str[len], (unsigned long) (sec - minutes * 60), (size_t) 2u
+	);
+	str[len + 2u] = '.';
+	timestamp_put_digits(
+		&str[len + 3u], (unsigned long) nsec, (size_t) 9u
+	);
+	str[len + 12u] = 'Z';
+	len += TIMESTAMP_SUFFIX_LEN;
+
+	return asspf_write(writebuf, str, len);
+}
+
+/* returns the number of bytes written to the writebuf */
+/* returns 0 if the clock cannot be read */
+size_t
+asspf_put_timestamp(
+	struct ASSPF_WriteBuf *writebuf, int clock_id,
+	/*@null@*/ struct ASSPF_TimeCache *cache
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		*writebuf,
+		*cache
+@*/
+{
+	struct timespec ts;
+	int result;
+
+	switch ( clock_id ){
+	case TIMESTAMP_CLOCK_REALTIME:
+		result = CLOCK_GETTIME(CLOCK_REALTIME, &ts);
+		break;
+	case TIMESTAMP_CLOCK_MONOTONIC:
+		result = CLOCK_GETTIME(CLOCK_MONOTONIC, &ts);
+		break;
+	default:
+		return 0;
+	}
+	if UNLIKELY ( result != 0 ){
+		return 0;
+	}
+
+	return asspf_put_time(
+		writebuf, clock_id, (int_least64_t) ts.tv_sec,
+		(long) ts.tv_nsec, cache
+	);
+}
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+#ifdef HAVE_ATOMICS
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/* keeps 'head' and 'tail' off of each other's cache lines */
+#define RING_CACHELINE_SIZE	64u
+
+/* a single-producer/single-consumer byte ring */
+struct ASSPF_Ring {
+	size_t		head;	/* only written by the producer */
+	char		pad_0[RING_CACHELINE_SIZE - (sizeof(size_t))];
+	size_t		tail;	/* only written by the consumer */
+	char		pad_1[RING_CACHELINE_SIZE - (sizeof(size_t))];
+	/*@temp@*/
+	char		*data;
+	size_t		mask;
+	int		wake_fd;
+};
+
+/* ------------------------------------------------------------------------ */
+
+/* returns the number of bytes put into the ring */
+/* only takes what fits, so it never waits on the consumer */
+static size_t
+ring_publish(struct ASSPF_Ring *ring, const void *src, size_t size)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*ring
+@*/
+{
+	const char *const src_c = src;
+	const uint64_t wake_value = 1u;	/* eventfd(2) wants 8 bytes */
+	size_t head, tail, nfree, off, size_1;
+
+	head  = ATOMIC_LOAD_RLX(&ring->head);
+	tail  = ATOMIC_LOAD_ACQ(&ring->tail);
+	nfree = (ring->mask + 1u) - (head - tail);
+	size  = (size > nfree ? nfree : size);
+	if UNLIKELY ( size == 0 ){
+		return 0;
+	}
+
+	/* copy, wrapping around the end */
+	off    = head & ring->mask;
+	size_1 = (ring->mask + 1u) - off;
+	size_1 = (size > size_1 ? size_1 : size);
+	(void) memcpy(&ring->data[off], src_c, size_1);
+	(void) memcpy(ring->data, &src_c[size_1], size - size_1);
+
+	ATOMIC_STORE_REL(&ring->head, head + size);
+
+	/* wake the consumer, only if it had emptied the ring;
+	   pairs with the fence in asspf_ring_drain(), so either this sees
+	   the ring empty, or the consumer sees the new head */
+	/* (a full eventfd/pipe fails with EAGAIN; fine, it is awake) */
+	if ( ring->wake_fd >= 0 ){
+		ATOMIC_FENCE_SEQ();
+		if ( ATOMIC_LOAD_RLX(&ring->tail) == head ){
+			(void) WRITE(
+				ring->wake_fd, &wake_value, sizeof wake_value
+			);
+		}
+	}
+
+	return size;
+}
+
+/* ======================================================================== */
+
+/* returns 0 on success */
+/* 'size' must be a power of 2 */
+/* 'wake_fd' is made non-blocking, so a publish never waits on it */
+int
+asspf_ring_init(
+	/*@out@*/ struct ASSPF_Ring *ring, /*@reldef@*/ char *buf,
+	size_t size, int wake_fd
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*ring
+@*/
+{
+	if UNLIKELY (
+		(size == 0) || ((size & (size - 1u)) != 0)
+	||
+		((wake_fd >= 0) && (SET_NONBLOCK(wake_fd) != 0))
+	){
+		return 1;
+	}
+
+	(void) memset(ring, 0, sizeof *ring);
+	ring->head	= 0;
+	ring->tail	= 0;
+	ring->data	= buf;
+	ring->mask	= size - 1u;
+	ring->wake_fd	= wake_fd;
+	return 0;
+}
+
+/* returns 0 on success */
+int
+asspf_writebuf_autoinit_ring(
+	/*@out@*/ struct ASSPF_WriteBuf *writebuf, struct ASSPF_Ring *ring,
+	/*@reldef@*/ char *buf, size_t limit
+)
+/*@modifies	*writebuf@*/
+{
+	*writebuf = writebuf_get(buf, limit, -1);
+	writebuf->sink     = ring;
+	writebuf->sinktype = WRITEBUF_SINK_RING;
+	return 0;
+}
+
+/* returns the number of bytes moved from the ring to 'fd' */
+/* only the consumer calls this */
+size_t
+asspf_ring_drain(struct ASSPF_Ring *ring, int fd)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*ring
+@*/
+{
+	size_t retval = 0;
+	size_t head, tail, off, size, nbytes_writ;
+
+	for (;;){
+		tail = ATOMIC_LOAD_RLX(&ring->tail);
+		head = ATOMIC_LOAD_ACQ(&ring->head);
+		if ( head == tail ){
+			break;
+		}
+
+		/* up to the end of the data, or the wrap-around */
+		off  = tail & ring->mask;
+		size = (ring->mask + 1u) - off;
+		size = (head - tail < size ? head - tail : size);
+
+		nbytes_writ = asspf_sys_write(fd, &ring->data[off], size);
+		ATOMIC_STORE_REL(&ring->tail, tail + nbytes_writ);
+		/* see ring_publish() */
+		ATOMIC_FENCE_SEQ();
+		retval += nbytes_writ;
+		if UNLIKELY ( nbytes_writ != size ){
+			break;
+		}
+	}
+
+	return retval;
+}
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/* SharedBuf state word:
+	bit  63		sealed (no new reservations, the last writer flushes)
+	bits 16..62	fill offset
+	bits  0..15	number of writers still copying
+*/
+#define SHARED_SEALED		((uint64_t) 1u << 63u)
+#define SHARED_OFF_SHIFT	16u
+#define SHARED_OFF_MAX		(((uint64_t) 1u << 47u) - 1u)
+#define SHARED_CNT_MASK		((uint64_t) 0xFFFFu)
+
+#define SHARED_OFF(Xstate)	( \
+	(size_t) (((Xstate) & ~SHARED_SEALED) >> SHARED_OFF_SHIFT) \
+)
+#define SHARED_CNT(Xstate)	((Xstate) & SHARED_CNT_MASK)
+
+/* a WriteBuf-like buffer that many threads/handlers can write at once */
+struct ASSPF_SharedBuf {
+	uint64_t	state;
+	char		pad_0[RING_CACHELINE_SIZE - (sizeof(uint64_t))];
+	/*@temp@*/
+	char		*buf;
+	size_t		limit;
+	int		fd;
+};
+
+/* ------------------------------------------------------------------------ */
+
+/* returns the number of bytes written */
+/* writes out the sealed buffer, then opens it back up */
+/* (only called by whoever took the writer count of a sealed buffer to 0) */
+static NOINLINE size_t
+sharedbuf_flush_sealed(struct ASSPF_SharedBuf *sharedbuf, uint64_t state)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*sharedbuf
+@*/
+{
+	size_t retval;
+
+	assert(((state & SHARED_SEALED) != 0) && (SHARED_CNT(state) == 0));
+
+	retval = asspf_sys_write(
+		sharedbuf->fd, sharedbuf->buf, SHARED_OFF(state)
+	);
+	ATOMIC_STORE_REL(&sharedbuf->state, (uint64_t) 0u);
+	return retval;
+}
+
+/* returns the monotonic clock, in nanoseconds (0 if it cannot be read) */
+static uint64_t
+shared_stamp(void)
+/*@globals	internalState@*/
+/*@*/
+{
+	struct timespec ts;
+
+	if UNLIKELY ( CLOCK_GETTIME(CLOCK_MONOTONIC, &ts) != 0 ){
+		return 0;
+	}
+	return ((uint64_t) ts.tv_sec * UINT64_C(1000000000))
+		+ (uint64_t) ts.tv_nsec;
+}
+
+/* returns 0 on success, with the offset of 'size' bytes in 'off_out' */
+/* returns 1 if the caller should write its bytes out itself */
+/* if 'seal', a full buffer gets sealed and flushed by the last writer out,
+   otherwise it waits for a drainer (see asspf_shards_drain()) */
+/* a 'stamp_out' gets the clock, read after the state the reservation won
+   on was loaded: slots later in the buffer never get an earlier stamp */
+static int
+sharedbuf_reserve(
+	struct ASSPF_SharedBuf *sharedbuf, size_t size, int seal,
+	/*@out@*/ size_t *off_out, /*@null@*/ /*@out@*/ uint64_t *stamp_out
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		*sharedbuf,
+		*off_out,
+		*stamp_out
+@*/
+{
+	uint64_t state, state_new;
+	size_t off;
+
+	if UNLIKELY ( size > sharedbuf->limit ){
+		return 1;
+	}
+
+	state = ATOMIC_LOAD_ACQ(&sharedbuf->state);
+	for (;;){
+		off = SHARED_OFF(state);
+		if UNLIKELY (
+			((state & SHARED_SEALED) != 0)
+		||
+			(SHARED_CNT(state) == SHARED_CNT_MASK)
+		){
+			/* someone else is flushing; do not wait on them */
+			return 1;
+		}
+
+		if UNLIKELY ( size > sharedbuf->limit - off ){
+			if ( ! seal ){
+				return 1;
+			}
+			/* full: seal it */
+			state_new = state | SHARED_SEALED;
+			if ( ! ATOMIC_CAS_ACQREL(
+				&sharedbuf->state, &state, state_new
+			) ){
+				continue;
+			}
+			if ( SHARED_CNT(state_new) != 0 ){
+				/* the last writer out flushes it */
+				return 1;
+			}
+			(void) sharedbuf_flush_sealed(sharedbuf, state_new);
+			state = ATOMIC_LOAD_ACQ(&sharedbuf->state);
+			continue;
+		}
+
+		state_new  = state + ((uint64_t) size << SHARED_OFF_SHIFT);
+		state_new += 1u;
+		if ( stamp_out != NULL ){
+			*stamp_out = shared_stamp();
+		}
+		if ( ATOMIC_CAS_ACQREL(&sharedbuf->state, &state, state_new) ){
+			break;
+		}
+	}
+
+	*off_out = off;
+	return 0;
+}
+
+/* marks a reserved slot complete */
+static void
+sharedbuf_release(struct ASSPF_SharedBuf *sharedbuf, int seal)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*sharedbuf
+@*/
+{
+	uint64_t state;
+
+	state = ATOMIC_SUBFETCH_ACQREL(&sharedbuf->state, (uint64_t) 1u);
+	if UNLIKELY (
+		seal
+	&&
+		((state & SHARED_SEALED) != 0) && (SHARED_CNT(state) == 0)
+	){
+		(void) sharedbuf_flush_sealed(sharedbuf, state);
+	}
+	return;
+}
+
+/* ======================================================================== */
+
+/* returns 0 on success */
+/* returns 1 if 'limit' is too big */
+int
+asspf_sharedbuf_init(
+	/*@out@*/ struct ASSPF_SharedBuf *sharedbuf, int fd,
+	/*@reldef@*/ char *buf, size_t limit
+)
+/*@modifies	*sharedbuf@*/
+{
+	if UNLIKELY ( (uint64_t) limit > SHARED_OFF_MAX ){
+		return 1;
+	}
+
+	(void) memset(sharedbuf, 0, sizeof *sharedbuf);
+	sharedbuf->state	= 0;
+	sharedbuf->buf		= buf;
+	sharedbuf->limit	= limit;
+	sharedbuf->fd		= fd;
+	return 0;
+}
+
+/* returns 0 on success (always succeeds) */
+int
+asspf_writebuf_autoinit_shared(
+	/*@out@*/ struct ASSPF_WriteBuf *writebuf,
+	struct ASSPF_SharedBuf *sharedbuf, /*@reldef@*/ char *buf,
+	size_t limit
+)
+/*@modifies	*writebuf@*/
+{
+	*writebuf = writebuf_get(buf, limit, sharedbuf->fd);
+	writebuf->sink     = sharedbuf;
+	writebuf->sinktype = WRITEBUF_SINK_SHARED;
+	return 0;
+}
+
+/* returns the number of bytes written */
+/* 'src' lands in the buffer in one piece, or goes out in one write(2) */
+size_t
+asspf_shared_write(
+	struct ASSPF_SharedBuf *sharedbuf, const void *src, size_t size
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*sharedbuf
+@*/
+{
+	size_t off;
+
+	if UNLIKELY (
+		sharedbuf_reserve(sharedbuf, size, TRUE, &off, NULL) != 0
+	){
+		return asspf_sys_write(sharedbuf->fd, src, size);
+	}
+	(void) memcpy(&sharedbuf->buf[off], src, size);
+	sharedbuf_release(sharedbuf, TRUE);
+
+	return size;
+}
+
+/* returns the number of bytes written out by this call */
+/* if writers are still copying, the last one of them does the flush */
+size_t
+asspf_shared_flush(struct ASSPF_SharedBuf *sharedbuf)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*sharedbuf
+@*/
+{
+	uint64_t state, state_new;
+
+	state = ATOMIC_LOAD_ACQ(&sharedbuf->state);
+	do {	if ( (state & SHARED_SEALED) != 0 ){
+			return 0;
+		}
+		state_new = state | SHARED_SEALED;
+	} while ( ! ATOMIC_CAS_ACQREL(&sharedbuf->state, &state, state_new) );
+
+	if ( SHARED_CNT(state_new) != 0 ){
+		return 0;
+	}
+	return sharedbuf_flush_sealed(sharedbuf, state_new);
+}
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+#if defined(__linux__)
+#include <sched.h>
+#define CURRENT_CPU()	sched_getcpu()
+#else
+#define CURRENT_CPU()	0
+#endif
+
+#define SHARDS_MAX	256u
+
+/* shard record: [stamp (8 bytes)] [payload size (4 bytes)] [payload] */
+#define SHARD_HDR_SIZE	12u
+
+/* per-CPU SharedBufs, merged back together by timestamp */
+/* each CPU has two halves: writers fill the active one,
+   while the drainer empties the other one */
+/* the inactive halves stay sealed, so a writer still holding the old
+   'active' cannot reserve into a half that was already drained */
+struct ASSPF_Shards {
+	/*@temp@*/
+	struct ASSPF_SharedBuf	*shard;
+	size_t		nshards;
+	unsigned int	active;	/* 0 or 1, only written by the drainer */
+	int		fd;
+};
+
+/* ------------------------------------------------------------------------ */
+
+/* returns the number of bytes in the half, once it is sealed
+   and its writers are done with it */
+/* only the drainer calls this; the half stays sealed
+   until the next drain reopens it */
+static size_t
+shards_seal(struct ASSPF_SharedBuf *sharedbuf)
+/*@modifies	*sharedbuf@*/
+{
+	uint64_t state, state_new;
+
+	/* even an empty half, so no late writer publishes into it */
+	state = ATOMIC_LOAD_ACQ(&sharedbuf->state);
+	do {	state_new = state | SHARED_SEALED;
+	} while ( ! ATOMIC_CAS_ACQREL(&sharedbuf->state, &state, state_new) );
+
+	/* wait for the writers to finish copying */
+	while ( SHARED_CNT(state_new) != 0 ){
+		state_new = ATOMIC_LOAD_ACQ(&sharedbuf->state);
+	}
+	return SHARED_OFF(state_new);
+}
+
+/* reverses 'buf[0 .. size)' */
+static void
+shards_reverse(char *buf, size_t size)
+/*@modifies	*buf@*/
+{
+	size_t i, j;
+	char c;
+
+	for ( i = 0, j = size; i + 1u < j; ++i, --j ){
+		c          = buf[i];
+		buf[i]     = buf[j - 1u];
+		buf[j - 1u] = c;
+	}
+	return;
+}
+
+/* sorts the records of a drained half by stamp */
+/* sharedbuf_reserve() already hands out stamps in slot order,
+   so this is one pass unless the clock misbehaved;
+   a late record gets rotated back in front of the first newer one */
+static void
+shards_sort(char *buf, size_t size)
+/*@modifies	*buf@*/
+{
+	size_t off, next, at;
+	uint64_t stamp, stamp_at, stamp_last = 0;
+	uint32_t size32;
+
+	for ( off = 0; off < size; off = next ){
+		(void) memcpy(&stamp, &buf[off], sizeof stamp);
+		(void) memcpy(&size32, &buf[off + 8u], sizeof size32);
+		next = off + SHARD_HDR_SIZE + (size_t) size32;
+		if LIKELY ( stamp >= stamp_last ){
+			stamp_last = stamp;
+			continue;
+		}
+
+		at = 0;
+		for (;;){
+			(void) memcpy(&stamp_at, &buf[at], sizeof stamp_at);
+			if ( stamp_at > stamp ){
+				break;
+			}
+			(void) memcpy(&size32, &buf[at + 8u], sizeof size32);
+			at += SHARD_HDR_SIZE + (size_t) size32;
+		}
+		/* swaps 'buf[at .. off)' and 'buf[off .. next)' */
+		shards_reverse(&buf[at], off - at);
+		shards_reverse(&buf[off], next - off);
+		shards_reverse(&buf[at], next - at);
+	}
+	return;
+}
+
+/* ======================================================================== */
+
+/* returns 0 on success */
+/* returns 1 if 'nshards' or 'shard_limit' is out of range */
+/* 'shard' holds 2 * 'nshards' SharedBufs */
+/* 'buf' holds 2 * 'nshards' * 'shard_limit' bytes */
+int
+asspf_shards_init(
+	/*@out@*/ struct ASSPF_Shards *shards, int fd,
+	/*@out@*/ struct ASSPF_SharedBuf shard[], size_t nshards,
+	/*@reldef@*/ char *buf, size_t shard_limit
+)
+/*@modifies	*shards,
+		shard[]
+@*/
+{
+	size_t i;
+
+	if UNLIKELY (
+		(nshards == 0) || (nshards > (size_t) SHARDS_MAX)
+	||
+		(shard_limit <= (size_t) SHARD_HDR_SIZE)
+	){
+		return 1;
+	}
+
+	for ( i = 0; i < 2u * nshards; ++i ){
+		if UNLIKELY ( asspf_sharedbuf_init(
+			&shard[i], fd, &buf[i * shard_limit], shard_limit
+		) != 0 ){
+			return 1;
+		}
+	}
+
+	/* the inactive halves start out sealed */
+	for ( i = 0; i < nshards; ++i ){
+		shard[(2u * i) + 1u].state = SHARED_SEALED;
+	}
+
+	(void) memset(shards, 0, sizeof *shards);
+	shards->shard	= shard;
+	shards->nshards	= nshards;
+	shards->active	= 0;
+	shards->fd	= fd;
+	return 0;
+}
+
+/* returns 0 on success (always succeeds) */
+int
+asspf_writebuf_autoinit_shards(
+	/*@out@*/ struct ASSPF_WriteBuf *writebuf,
+	struct ASSPF_Shards *shards, /*@reldef@*/ char *buf, size_t limit
+)
+/*@modifies	*writebuf@*/
+{
+	*writebuf = writebuf_get(buf, limit, shards->fd);
+	writebuf->sink     = shards;
+	writebuf->sinktype = WRITEBUF_SINK_SHARDS;
+	return 0;
+}
+
+/* returns the number of bytes written */
+/* 'src' goes into the current CPU's shard as one record,
+   or straight out in one write(2) if the shard is full */
+size_t
+asspf_shards_write(struct ASSPF_Shards *shards, const void *src, size_t size)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*shards
+@*/
+{
+	struct ASSPF_SharedBuf *sharedbuf;
+	int cpu;
+	unsigned int active, active_old;
+	size_t idx, off;
+	uint64_t stamp;
+	uint32_t size32;
+
+	if UNLIKELY (
+		(size > shards->shard[0].limit - SHARD_HDR_SIZE)
+	||
+		((uintmax_t) size > (uintmax_t) UINT32_MAX)
+	){
+		return asspf_sys_write(shards->fd, src, size);
+	}
+
+	/* a migration after this only costs some cache misses,
+	   since the shard itself is multi-writer */
+	cpu = CURRENT_CPU();
+	cpu = (cpu < 0 ? 0 : cpu);
+	idx = 2u * ((size_t) cpu % shards->nshards);
+
+	active = ATOMIC_LOAD_ACQ(&shards->active);
+	for (;;){
+		sharedbuf = &shards->shard[idx + active];
+		if LIKELY ( sharedbuf_reserve(
+			sharedbuf, SHARD_HDR_SIZE + size, FALSE, &off, &stamp
+		) == 0 ){
+			break;
+		}
+
+		/* the drainer may have just swapped the halves */
+		active_old = active;
+		active     = ATOMIC_LOAD_ACQ(&shards->active);
+		if ( active == active_old ){
+			return asspf_sys_write(shards->fd, src, size);
+		}
+	}
+
+	size32 = (uint32_t) size;
+	(void) memcpy(&sharedbuf->buf[off], &stamp, sizeof stamp);
+	(void) memcpy(&sharedbuf->buf[off + 8u], &size32, sizeof size32);
+	(void) memcpy(&sharedbuf->buf[off + SHARD_HDR_SIZE], src, size);
+	sharedbuf_release(sharedbuf, FALSE);
+
+	return size;
+}
+
+/* returns the number of payload bytes written to 'writebuf' */
+/* reopens the halves drained last time, swaps the halves,
+   seals the old ones, sorts each one, then merges them by stamp */
+/* a half is copied into 'scratch' if it fits,
+   otherwise it is merged from its own buffer */
+/* only one thread may drain at a time */
+size_t
+asspf_shards_drain(
+	struct ASSPF_Shards *shards, struct ASSPF_WriteBuf *writebuf,
+	/*@out@*/ char *scratch, size_t scratch_size
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*shards,
+		*writebuf,
+		*scratch
+@*/
+{
+	/*@dependent@*/
+	char *base[SHARDS_MAX];
+	size_t begin[SHARDS_MAX], end[SHARDS_MAX];
+	struct ASSPF_SharedBuf *sharedbuf;
+	size_t retval = 0, nmemb = 0;
+	size_t i, best, size;
+	uint64_t stamp, stamp_best = 0;
+	uint32_t size32;
+	unsigned int active_old;
+
+	/* reopen and swap every shard before taking any,
+	   so newer records do not sneak in ahead of older ones */
+	active_old = shards->active;
+	for ( i = 0; i < shards->nshards; ++i ){
+		sharedbuf = &shards->shard[(2u * i) + (active_old ^ 1u)];
+		ATOMIC_STORE_REL(&sharedbuf->state, (uint64_t) 0u);
+	}
+	ATOMIC_STORE_REL(&shards->active, active_old ^ 1u);
+
+	for ( i = 0; i < shards->nshards; ++i ){
+		sharedbuf = &shards->shard[(2u * i) + active_old];
+		size      = shards_seal(sharedbuf);
+		if ( size <= scratch_size - nmemb ){
+			(void) memcpy(&scratch[nmemb], sharedbuf->buf, size);
+			base[i] = &scratch[nmemb];
+			nmemb  += size;
+		}
+		else {	base[i] = sharedbuf->buf; }
+		begin[i] = 0;
+		end[i]   = size;
+		shards_sort(base[i], size);
+	}
+
+	/* k-way merge on the record heads */
+	for (;;){
+		best = SIZE_MAX;
+		for ( i = 0; i < shards->nshards; ++i ){
+			if ( begin[i] == end[i] ){
+				continue;
+			}
+			(void) memcpy(&stamp, &base[i][begin[i]], sizeof stamp);
+			if ( (best == SIZE_MAX) || (stamp < stamp_best) ){
+				best       = i;
+				stamp_best = stamp;
+			}
+		}
+		if ( best == SIZE_MAX ){
+			break;
+		}
+
+		(void) memcpy(
+			&size32, &base[best][begin[best] + 8u], sizeof size32
+		);
+		retval += asspf_write(
+			writebuf, &base[best][begin[best] + SHARD_HDR_SIZE],
+			(size_t) size32
+		);
+		begin[best] += SHARD_HDR_SIZE + (size_t) size32;
+	}
+
+	return retval;
+}
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+#define MMAPLOG_MAGIC		"ASSPFLOG"
+#define MMAPLOG_VERSION		1u
+
+/* the start of the mapped file (native byte order) */
+struct MMapLog_Hdr {
+	char		magic[8u];
+	uint32_t	version;
+	uint32_t	hdr_size;
+	uint64_t	data_size;
+	uint64_t	head;		/* total bytes ever written */
+	char		pad_0[32u];
+};
+
+/* a crash log living in a MAP_SHARED file mapping */
+struct ASSPF_MMapLog {
+	/*@temp@*/
+	struct MMapLog_Hdr	*hdr;
+	/*@temp@*/
+	char			*data;
+	size_t			size;
+};
+
+/* ======================================================================== */
+
+/* returns 0 on success */
+/* returns 1 if 'map' is too small */
+/* a log already in 'map' (same size) is kept and appended to */
+int
+asspf_mmaplog_init(
+	/*@out@*/ struct ASSPF_MMapLog *mmaplog, void *map, size_t map_size
+)
+/*@modifies	*mmaplog,
+		*map
+@*/
+{
+	struct MMapLog_Hdr *const hdr = map;
+
+	if UNLIKELY ( map_size <= sizeof *hdr ){
+		return 1;
+	}
+
+	mmaplog->hdr  = hdr;
+	mmaplog->data = &((char *) map)[sizeof *hdr];
+	mmaplog->size = map_size - sizeof *hdr;
+
+	if (
+		(memcmp(hdr->magic, MMAPLOG_MAGIC, sizeof hdr->magic) == 0)
+	&&
+		(hdr->version == (uint32_t) MMAPLOG_VERSION)
+	&&
+		(hdr->hdr_size == (uint32_t) sizeof *hdr)
+	&&
+		(hdr->data_size == (uint64_t) mmaplog->size)
+	){
+		return 0;
+	}
+
+	(void) memset(hdr, 0, sizeof *hdr);
+	(void) memcpy(hdr->magic, MMAPLOG_MAGIC, sizeof hdr->magic);
+	hdr->version	= (uint32_t) MMAPLOG_VERSION;
+	hdr->hdr_size	= (uint32_t) sizeof *hdr;
+	hdr->data_size	= (uint64_t) mmaplog->size;
+	hdr->head	= 0;
+	return 0;
+}
+
+/* returns 0 on success (always succeeds) */
+int
+asspf_writebuf_autoinit_mmaplog(
+	/*@out@*/ struct ASSPF_WriteBuf *writebuf,
+	struct ASSPF_MMapLog *mmaplog, /*@reldef@*/ char *buf, size_t limit
+)
+/*@modifies	*writebuf@*/
+{
+	*writebuf = writebuf_get(buf, limit, -1);
+	writebuf->sink     = mmaplog;
+	writebuf->sinktype = WRITEBUF_SINK_MMAPLOG;
+	return 0;
+}
+
+/* returns the number of bytes written (always 'size') */
+/* no system calls: the oldest bytes get overwritten,
+   and the kernel writes the pages back, even after a crash */
+size_t
+asspf_mmaplog_write(
+	struct ASSPF_MMapLog *mmaplog, const void *src, size_t size
+)
+/*@modifies	*mmaplog@*/
+{
+	const char *src_c = src;
+	const size_t retval = size;
+	uint64_t head;
+	size_t off, size_1;
+
+	/* only the end of it would survive anyway */
+	if UNLIKELY ( size > mmaplog->size ){
+		src_c = &src_c[size - mmaplog->size];
+		size  = mmaplog->size;
+	}
+
+	/* claim [head, head + size), so writers can share the log */
+	head = ATOMIC_FETCHADD_RLX(&mmaplog->hdr->head, (uint64_t) size);
+
+	/* copy, wrapping around the end */
+	off    = (size_t) (head % (uint64_t) mmaplog->size);
+	size_1 = mmaplog->size - off;
+	size_1 = (size > size_1 ? size_1 : size);
+	(void) memcpy(&mmaplog->data[off], src_c, size_1);
+	(void) memcpy(mmaplog->data, &src_c[size_1], size - size_1);
+
+	return retval;
+}
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+#endif	/* HAVE_ATOMICS */
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+#ifndef ASSPF_OPT_NO_PRINTF
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+#undef writebuf
+static NOINLINE size_t printf_int(
+	struct ASSPF_WriteBuf *writebuf, const char *, uintmax_t, size_t
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+;
+
+#if UINT_LEAST16_MAX != UINT_LEAST8_MAX
+#define X_ASSPS_U16LEAST_NEEDED
+#endif
+
+#if UINT_LEAST32_MAX != UINT_LEAST16_MAX
+#define X_ASSPS_U32LEAST_NEEDED
+#endif
+
+#if UINT_LEAST64_MAX != UINT_LEAST32_MAX
+#define X_ASSPS_U64LEAST_NEEDED
+#endif
+
+#if UINTMAX_MAX != UINT_LEAST8_MAX  \
+ && UINTMAX_MAX != UINT_LEAST16_MAX \
+ && UINTMAX_MAX != UINT_LEAST32_MAX \
+ && UINTMAX_MAX != UINT_LEAST64_MAX
+#define X_ASSPS_UINTMAX_NEEDED
+#endif
+
+#if UINTPTR_MAX != UINT_LEAST8_MAX  \
+ && UINTPTR_MAX != UINT_LEAST16_MAX \
+ && UINTPTR_MAX != UINT_LEAST32_MAX \
+ && UINTPTR_MAX != UINT_LEAST64_MAX \
+ && UINTPTR_MAX != UINTMAX_MAX
+#define X_ASSPS_UINTPTR_NEEDED
+#endif
+
+/* ------------------------------------------------------------------------ */
+
+/* returns the number of bytes written to the writebuf */
+size_t
+asspf_printf_int8least(
+	struct ASSPF_WriteBuf *writebuf, const char *format,
+	uint_least8_t value
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+{
+	return printf_int(writebuf, format, (uintmax_t) value, sizeof value);
+}
+
+#ifdef X_ASSPS_U16LEAST_NEEDED
+/* returns the number of bytes written to the writebuf */
+size_t
+asspf_printf_int16least(
+	struct ASSPF_WriteBuf *writebuf, const char *format,
+	uint_least16_t value
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+{
+	return printf_int(writebuf, format, (uintmax_t) value, sizeof value);
+}
+#endif	/* X_ASSPS_U16LEAST_NEEDED */
+
+#ifdef X_ASSPS_U32LEAST_NEEDED
+/* returns the number of bytes written to the writebuf */
+size_t
+asspf_printf_int32least(
+	struct ASSPF_WriteBuf *writebuf, const char *format,
+	uint_least32_t value
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+{
+	return printf_int(writebuf, format, (uintmax_t) value, sizeof value);
+}
+#endif	/* X_ASSPS_U32LEAST_NEEDED */
+
+#ifdef X_ASSPS_U64LEAST_NEEDED
+/* returns the number of bytes written to the writebuf */
+size_t
+asspf_printf_int64least(
+	struct ASSPF_WriteBuf *writebuf, const char *format,
+	uint_least64_t value
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+{
+	return printf_int(writebuf, format, (uintmax_t) value, sizeof value);
+}
+#endif	/* X_ASSPS_U64LEAST_NEEDED */
+
+#ifdef X_ASSPS_UINTMAX_NEEDED
+/* returns the number of bytes written to the writebuf */
+size_t
+asspf_printf_intmax(
+	struct ASSPF_WriteBuf *writebuf, const char *format, uintmax_t value
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+{
+	return printf_int(writebuf, format, (uintmax_t) value, sizeof value);
+}
+#endif /* X_ASSPS_UINTMAX_NEEDED */
+
+#ifdef X_ASSPS_UINTPTR_NEEDED
+/* returns the number of bytes written to the writebuf */
+size_t
+asspf_printf_intptr(
+	struct ASSPF_WriteBuf *writebuf, const char *format, uintptr_t value
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+{
+	return printf_int(writebuf, format, (uintmax_t) value, sizeof value);
+}
+#endif /* X_ASSPS_UINTPTR_NEEDED */
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/* checks if the targeted arch has an arithmetic (signed) right shift */
+#define HAS_ASR(Xtype)	( \
+	/*@-shiftimplementation@*/ \
+	(Xtype) (((Xtype) UINTMAX_MAX) >> 1u) == (Xtype) UINTMAX_MAX \
+	/*@=shiftimplementation@*/ \
+)
+
+/* returns 'value' arithmetically shifted 'count' bits right */
+ALWAYS_INLINE CONST intmax_t
+asr_imax(intmax_t x, uint_fast8_t k)
+/*@*/
+{
+	assert((size_t) k < (sizeof x) * CHAR_BIT);
+
+	if ( HAS_ASR(intmax_t) ){
+		/*@-shiftimplementation@*/
+		return (intmax_t) (x >> k);
+		/*@=shiftimplementation@*/
+	}
+	else {	return (x < 0
+			? (intmax_t) ~((~((uintmax_t) x)) >> k)
+			: (intmax_t) (((uintmax_t) x) >> k)
+		);
+	}
+}
+
+/* returns 'value' arithmetically shifted 'count' bits left */
+ALWAYS_INLINE CONST intmax_t
+asl_imax(intmax_t x, uint_fast8_t k)
+/*@*/
+{
+	assert((size_t) k < (sizeof x) * CHAR_BIT);
+
+	return (intmax_t) (((uintmax_t) x) << k);
+}
+
+/* returns the absolute value of an integer */
+ALWAYS_INLINE CONST uintmax_t
+abs_imax(intmax_t x)
+/*@*/
+{
+	/* the compiler does better with this than imaxabs() or bit-tricks */
+	return (x < 0 ? -((uintmax_t) x) : (uintmax_t) x);
+}
+
+/* returns the 'ilog10 + 1' of an integer */
+/* only used on pre-defined values (like a constexpr) */
+ALWAYS_INLINE CONST size_t
+ilog10p1(uintmax_t limit)
+/*@*/
+{	size_t retval = (size_t) 1u;
+
+	while ( (limit /= 10u) != 0 ){
+		++retval;
+	}
+	return retval;
+}
+
+/* returns the number of chars read from 'str' and sets '*dest' on success */
+/* returns 0 on error */
+/* @note atoi() is not on the whitelist */
+static size_t
+ascii_a2uint(const char *str, size_t limit, /*@out@*/ unsigned int *dest)
+/*@modifies	*dest@*/
+{
+	const size_t ndigits_max = ilog10p1((uintmax_t) UINT_MAX);
+	uintmax_t number;
+	size_t ndigits;
+	int overflow;
+
+	ndigits = ascii_a2umax(
+		str, limit, 10u, (uintmax_t) UINT_MAX, 0, &number, &overflow
+	);
+	if ( (ndigits == 0) || (ndigits > ndigits_max) ){
+		/*@-mustmod@*/ /*@-mustdefine@*/
+		return 0;
+		/*@=mustmod@*/ /*@=mustdefine@*/
+	}
+
+	*dest = (unsigned int) number;
+	return ndigits;
+}
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/* asspf.hpp compiles formats itself, so it mirrors these (keep in sync) */
+
+#define FORMATFLAG_NONE			0x00u
+#define FORMATFLAG_ALTFORM_C		0x01u
+#define FORMATFLAG_ALTFORM_M		0x02u
+#define FORMATFLAG_ZERO_PAD		0x04u
+#define FORMATFLAG_LEFT_ADJUST		0x08u
+#define FORMATFLAG_BLANK_SIGN		0x10u
+#define FORMATFLAG_ALWAYS_SIGN		0x20u
+
+#define FORMATFLAG_ALTFORM_ALL		\
+	(FORMATFLAG_ALTFORM_C | FORMATFLAG_ALTFORM_M)
+
+#define FORMATFIELDWIDTH_UNSET		0u
+
+#define FORMATPRECISION_UNSET		1u
+#define FORMATPRECISION_NATURAL		0u
+
+#define FORMATSCALE_UNSET		0u
+#define FORMATSCALE_MAX			19u	/* 10^19 < 2^64 */
+
+enum FormatConvSpec_Int {
+	FORMATCONVSPEC_INT_UNSET,
+	FORMATCONVSPEC_INT_d,
+	FORMATCONVSPEC_INT_u,
+	FORMATCONVSPEC_INT_b,
+	FORMATCONVSPEC_INT_o,
+	FORMATCONVSPEC_INT_x,
+	FORMATCONVSPEC_INT_X
+};
+
+/* ======================================================================== */
+
+struct ItemFormat_Int {
+	unsigned int		flags;
+	unsigned int		fieldwidth;
+	unsigned int		precision;
+	unsigned int		scale;	/* number of decimal places */
+	enum FormatConvSpec_Int	convspec;
+};
+
+/* ------------------------------------------------------------------------ */
+
+/* returns a defined struct */
+ALWAYS_INLINE CONST struct ItemFormat_Int
+itemformat_int_get(
+	unsigned int flags, unsigned int fieldwidth, unsigned int precision,
+	unsigned int scale, enum FormatConvSpec_Int convspec
+)
+/*@*/
+{
+	struct ItemFormat_Int retval;
+
+	retval.flags		= flags;
+	retval.fieldwidth	= fieldwidth;
+	retval.precision	= precision;
+	retval.scale		= scale;
+	retval.convspec		= convspec;
+
+	return retval;
+}
+
+/* ======================================================================== */
+
+#define FORMATREAD_ERROR { \
+	if UNLIKELY ( TRUE ) { \
+		/*@-mustmod@*/ /*@-mustdefine@*/\
+		return SIZE_MAX; \
+		/*@=mustmod@*/ /*@=mustdefine@*/\
+	} \
+}
+#define CHECK_FORMATBUF { \
+	if UNLIKELY ( format_idx == format_len ){ \
+		FORMATREAD_ERROR; \
+	} \
+}
+#define SET_FORMATFIELD_A2INT(Xfield){ \
+	size_t x_setffa2int_ndigits; \
+	x_setffa2int_ndigits = ascii_a2uint( \
+		&format[format_idx], format_len - format_idx, \
+		&Xfield \
+	); \
+	if ( (x_setffa2int_ndigits == 0) \
+	    || \
+	     (Xfield > (unsigned int) INT_MAX) \
+	){ \
+		FORMATREAD_ERROR; \
+	} \
+	format_idx += x_setffa2int_ndigits; \
+}
+
+/* returns the number of bytes processed, or SIZE_MAX on error */
+static size_t
+format_scan_flags(
+	/*@out@*/ unsigned int *flags_out, const char *format,
+	size_t format_len
+)
+/*@modifies	*flags_out@*/
+{
+	size_t       format_idx		= 0;
+	unsigned int format_flags	= FORMATFLAG_NONE;
+
+	#define SET_FORMATFLAG(Xflag) { \
+		if UNLIKELY ( (format_flags & Xflag) != 0 ){ \
+			FORMATREAD_ERROR; \
+		} \
+		format_flags |= Xflag; \
+		format_idx   += 1u; \
+	}
+
+	get_flag:
+	CHECK_FORMATBUF;
+	switch ( format[format_idx] ){
+	case '#':
+		SET_FORMATFLAG(FORMATFLAG_ALTFORM_C);
+		goto get_flag;
+	case '$':
+		SET_FORMATFLAG(FORMATFLAG_ALTFORM_M);
+		goto get_flag;
+	case '0':
+		SET_FORMATFLAG(FORMATFLAG_ZERO_PAD);
+		goto get_flag;
+	case '-':
+		SET_FORMATFLAG(FORMATFLAG_LEFT_ADJUST);
+		goto get_flag;
+	case ' ':
+		SET_FORMATFLAG(FORMATFLAG_BLANK_SIGN);
+		goto get_flag;
+	case '+':
+		SET_FORMATFLAG(FORMATFLAG_ALWAYS_SIGN);
+		goto get_flag;
+	default:
+		break;
+	}
+
+	*flags_out = format_flags;
+	return format_idx;
+}
+
+/* returns the number of bytes processed, or SIZE_MAX on error */
+static size_t
+format_scan_fieldwidth(
+	/*@out@*/ unsigned int *fieldwidth_out, const char *format,
+	size_t format_len
+)
+/*@modifies	*fieldwidth_out@*/
+{
+	size_t       format_idx		= 0;
+	unsigned int format_fieldwidth	= FORMATFIELDWIDTH_UNSET;
+
+	CHECK_FORMATBUF;
+	if ( ascii_isdigit(format[format_idx]) != 0 ){
+		SET_FORMATFIELD_A2INT(format_fieldwidth);
+	}
+
+	*fieldwidth_out = format_fieldwidth;
+	return format_idx;
+}
+
+/* returns the number of bytes processed, or SIZE_MAX on error */
+static size_t
+format_scan_precision(
+	/*@out@*/ unsigned int *precision_out, const char *format,
+	size_t format_len
+)
+/*@modifies	*precision_out@*/
+{
+	size_t       format_idx		= 0;
+	unsigned int format_precision	= FORMATPRECISION_UNSET;
+
+	CHECK_FORMATBUF;
+	if ( format[format_idx] == '.' ){
+		format_idx += 1u;
+		CHECK_FORMATBUF;
+		if ( ascii_isdigit(format[format_idx]) != 0 ){
+			SET_FORMATFIELD_A2INT(format_precision);
+		}
+		else {	FORMATREAD_ERROR; }
+	}
+
+	*precision_out = format_precision;
+	return format_idx;
+}
+
+/* returns the number of bytes processed, or SIZE_MAX on error */
+static size_t
+format_scan_scale(
+	/*@out@*/ unsigned int *scale_out, const char *format,
+	size_t format_len
+)
+/*@modifies	*scale_out@*/
+{
+	size_t       format_idx		= 0;
+	unsigned int format_scale	= FORMATSCALE_UNSET;
+
+	CHECK_FORMATBUF;
+	if ( format[format_idx] == ',' ){
+		format_idx += 1u;
+		CHECK_FORMATBUF;
+		if ( ascii_isdigit(format[format_idx]) != 0 ){
+			SET_FORMATFIELD_A2INT(format_scale);
+		}
+		else {	FORMATREAD_ERROR; }
+		if UNLIKELY ( format_scale > FORMATSCALE_MAX ){
+			FORMATREAD_ERROR;
+		}
+	}
+
+	*scale_out = format_scale;
+	return format_idx;
+}
+
+/* returns the number of bytes processed, or SIZE_MAX on error */
+static size_t
+format_scan_convspec_int(
+	/*@out@*/ enum FormatConvSpec_Int *convspec_out, const char *format,
+	size_t format_len
+)
+/*@modifies	*convspec_out@*/
+{
+	size_t                  format_idx	= 0;
+	enum FormatConvSpec_Int format_convspec	= FORMATCONVSPEC_INT_UNSET;
+
+	CHECK_FORMATBUF;
+	switch ( format[format_idx] ){
+	case 'd':
+		format_convspec = FORMATCONVSPEC_INT_d;
+		break;
+	case 'u':
+		format_convspec = FORMATCONVSPEC_INT_u;
+		break;
+	case 'b':
+		format_convspec = FORMATCONVSPEC_INT_b;
+		break;
+	case 'o':
+		format_convspec = FORMATCONVSPEC_INT_o;
+		break;
+	case 'x':
+		format_convspec = FORMATCONVSPEC_INT_x;
+		break;
+	case 'X':
+		format_convspec = FORMATCONVSPEC_INT_X;
+		break;
+	default:
+		FORMATREAD_ERROR;
+	}
+	format_idx += 1u;
+
+	*convspec_out = format_convspec;
+	return format_idx;
+}
+
+/* ======================================================================== */
+
+#define FORMATSCAN(Xfn, Xvar){ \
+	size_t x_formatscan_nbytesread; \
+	x_formatscan_nbytesread = Xfn( \
+		&Xvar, &format[format_idx], format_len - format_idx \
+	); \
+	if UNLIKELY ( x_formatscan_nbytesread == SIZE_MAX ){ \
+		FORMATREAD_ERROR; \
+	} \
+	format_idx += x_formatscan_nbytesread; \
+}
+
+/* returns the number of bytes processed, or SIZE_MAX on error */
+/* stops after the conversion specifier */
+static size_t
+format_scan_int_prefix(
+	/*@out@*/ struct ItemFormat_Int *itemfmt, const char *format,
+	size_t format_len
+)
+/*@modifies	*itemfmt@*/
+{
+	size_t                  format_idx        = 0;
+	unsigned int            format_flags      = FORMATFLAG_NONE;
+	unsigned int            format_fieldwidth = FORMATFIELDWIDTH_UNSET;
+	unsigned int            format_precision  = FORMATPRECISION_UNSET;
+	unsigned int            format_scale      = FORMATSCALE_UNSET;
+	enum FormatConvSpec_Int format_convspec   = FORMATCONVSPEC_INT_UNSET;
+
+	FORMATSCAN(format_scan_flags, format_flags);
+	FORMATSCAN(format_scan_fieldwidth, format_fieldwidth);
+	FORMATSCAN(format_scan_precision, format_precision);
+	FORMATSCAN(format_scan_scale, format_scale);
+	FORMATSCAN(format_scan_convspec_int, format_convspec);
+
+	/* fixed-point is decimal only */
+	if UNLIKELY (
+		(format_scale != FORMATSCALE_UNSET)
+	&&
+		(format_convspec != FORMATCONVSPEC_INT_d)
+	&&
+		(format_convspec != FORMATCONVSPEC_INT_u)
+	){
+		FORMATREAD_ERROR;
+	}
+
+	*itemfmt = itemformat_int_get(
+		format_flags, format_fieldwidth, format_precision,
+		format_scale, format_convspec
+	);
+	return format_idx;
+}
+
+/* returns 0 on success */
+static int
+format_scan_int(/*@out@*/ struct ItemFormat_Int *itemfmt, const char *format)
+/*@modifies	*itemfmt@*/
+{
+	const size_t format_len = strlen(format);
+	size_t       format_idx;
+
+	format_idx = format_scan_int_prefix(itemfmt, format, format_len);
+	if UNLIKELY ( format_idx != format_len ){
+		return 1;
+	}
+	return 0;
+}
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/* a format string scanned ahead of time (see asspf_format_compile()) */
+struct ASSPF_Format {
+	struct ItemFormat_Int	itemfmt;
+	unsigned int		id;	/* for binary mode */
+};
+
+#define FORMAT_ID_NONE	0xFFFFu
+
+/* ------------------------------------------------------------------------ */
+
+#undef writebuf
+static size_t printf_int_item(
+	struct ASSPF_WriteBuf *writebuf, const struct ItemFormat_Int *,
+	uintmax_t, size_t
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+;
+
+/* ------------------------------------------------------------------------ */
+
+/* returns the number of bytes written to the writebuf */
+/* binary mode: an 'I' record, if the format has an id */
+static size_t
+printfc_int(
+	struct ASSPF_WriteBuf *writebuf, const struct ASSPF_Format *fmt,
+	uintmax_t value, size_t value_size
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+{
+	char *dest;
+	size_t size;
+
+	if UNLIKELY (
+		((writebuf->flags & WRITEBUF_FLAG_BINARY) != 0)
+	&&
+		(fmt->id != FORMAT_ID_NONE)
+	){
+		dest = writebuf_reserve(writebuf, 4u + value_size);
+		if UNLIKELY ( dest == NULL ){
+			return 0;
+		}
+		dest[0] = BINREC_INT_ID;
+		size    = 1u;
+		size   += binrec_le(
+			&dest[size], (uintmax_t) fmt->id, (size_t) 2u
+		);
+		dest[size++] = (char) value_size;
+		size   += binrec_le(&dest[size], value, value_size);
+		writebuf->nmemb += size;
+		return size;
+	}
+
+	return printf_int_item(writebuf, &fmt->itemfmt, value, value_size);
+}
+
+/* ======================================================================== */
+
+/* returns 0 on success */
+/* on error, 'fmt' is still defined, but prints nothing */
+int
+asspf_format_compile(
+	/*@out@*/ struct ASSPF_Format *fmt, const char *format
+)
+/*@modifies	*fmt@*/
+{
+	int err;
+
+	err = format_scan_int(&fmt->itemfmt, format);
+	if UNLIKELY ( err != 0 ){
+		fmt->itemfmt = itemformat_int_get(
+			FORMATFLAG_NONE, FORMATFIELDWIDTH_UNSET,
+			FORMATPRECISION_UNSET, FORMATSCALE_UNSET,
+			FORMATCONVSPEC_INT_UNSET
+		);
+	}
+	fmt->id = FORMAT_ID_NONE;
+	return err;
+}
+
+/* returns 0 on success */
+/* like asspf_format_compile(), but binary mode writes 'id' in place of
+   the formatted text (0xFFFF means no id) */
+int
+asspf_format_compile_id(
+	/*@out@*/ struct ASSPF_Format *fmt, const char *format,
+	unsigned short id
+)
+/*@modifies	*fmt@*/
+{
+	int err;
+
+	err = asspf_format_compile(fmt, format);
+	fmt->id = (unsigned int) id;
+	return err;
+}
+
+/* ------------------------------------------------------------------------ */
+
+/* returns the number of bytes written to the writebuf */
+size_t
+asspf_printfc_int8least(
+	struct ASSPF_WriteBuf *writebuf, const struct ASSPF_Format *fmt,
+	uint_least8_t value
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+{
+	return printfc_int(writebuf, fmt, (uintmax_t) value, sizeof value);
+}
+
+#ifdef X_ASSPS_U16LEAST_NEEDED
+/* returns the number of bytes written to the writebuf */
+size_t
+asspf_printfc_int16least(
+	struct ASSPF_WriteBuf *writebuf, const struct ASSPF_Format *fmt,
+	uint_least16_t value
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+{
+	return printfc_int(writebuf, fmt, (uintmax_t) value, sizeof value);
+}
+#endif	/* X_ASSPS_U16LEAST_NEEDED */
+
+#ifdef X_ASSPS_U32LEAST_NEEDED
+/* returns the number of bytes written to the writebuf */
+size_t
+asspf_printfc_int32least(
+	struct ASSPF_WriteBuf *writebuf, const struct ASSPF_Format *fmt,
+	uint_least32_t value
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+{
+	return printfc_int(writebuf, fmt, (uintmax_t) value, sizeof value);
+}
+#endif	/* X_ASSPS_U32LEAST_NEEDED */
+
+#ifdef X_ASSPS_U64LEAST_NEEDED
+/* returns the number of bytes written to the writebuf */
+size_t
+asspf_printfc_int64least(
+	struct ASSPF_WriteBuf *writebuf, const struct ASSPF_Format *fmt,
+	uint_least64_t value
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+{
+	return printfc_int(writebuf, fmt, (uintmax_t) value, sizeof value);
+}
+#endif	/* X_ASSPS_U64LEAST_NEEDED */
+
+#ifdef X_ASSPS_UINTMAX_NEEDED
+/* returns the number of bytes written to the writebuf */
+size_t
+asspf_printfc_intmax(
+	struct ASSPF_WriteBuf *writebuf, const struct ASSPF_Format *fmt,
+	uintmax_t value
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+{
+	return printfc_int(writebuf, fmt, (uintmax_t) value, sizeof value);
+}
+#endif	/* X_ASSPS_UINTMAX_NEEDED */
+
+#ifdef X_ASSPS_UINTPTR_NEEDED
+/* returns the number of bytes written to the writebuf */
+size_t
+asspf_printfc_intptr(
+	struct ASSPF_WriteBuf *writebuf, const struct ASSPF_Format *fmt,
+	uintptr_t value
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+{
+	return printfc_int(writebuf, fmt, (uintmax_t) value, sizeof value);
+}
+#endif	/* X_ASSPS_UINTPTR_NEEDED */
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+#undef writebuf
+static size_t printf_int_body(
+	struct ASSPF_WriteBuf *writebuf, const struct ItemFormat_Int *,
+	uintmax_t, size_t
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+;
+
+/* ------------------------------------------------------------------------ */
+
+/* returns the number of bytes written to the writebuf */
+/* an 'F' record: the format string goes along with the raw value */
+static size_t
+printf_int_binrec(
+	struct ASSPF_WriteBuf *writebuf, const char *format, uintmax_t value,
+	size_t value_size
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+{
+	const size_t format_len = strlen(format);
+	char *dest;
+	size_t size;
+
+	if UNLIKELY ( format_len > (size_t) UCHAR_MAX ){
+		STATS_ADD(writebuf, nformat_errors, 1u);
+		return 0;
+	}
+
+	dest = writebuf_reserve(writebuf, 3u + format_len + value_size);
+	if UNLIKELY ( dest == NULL ){
+		return 0;
+	}
+	dest[0] = BINREC_INT_FORMAT;
+	dest[1] = (char) format_len;
+	size    = 2u;
+	(void) memcpy(&dest[size], format, format_len);
+	size   += format_len;
+	dest[size++] = (char) value_size;
+	size   += binrec_le(&dest[size], value, value_size);
+	writebuf->nmemb += size;
+	return size;
+}
+
+/* returns the number of bytes written to the writebuf */
+static NOINLINE size_t
+printf_int(
+	struct ASSPF_WriteBuf *writebuf, const char *format, uintmax_t value,
+	size_t value_size
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+{
+	struct ItemFormat_Int itemfmt;
+	int err;
+
+	if UNLIKELY ( (writebuf->flags & WRITEBUF_FLAG_BINARY) != 0 ){
+		return printf_int_binrec(writebuf, format, value, value_size);
+	}
+
+	/* scan the format string */
+	err = format_scan_int(&itemfmt, format);
+	if ( err != 0 ){
+		STATS_ADD(writebuf, nformat_errors, 1u);
+		return 0;
+	}
+
+	/* format and print */
+	return printf_int_item(writebuf, &itemfmt, value, value_size);
+}
+
+/* returns the number of bytes written to the writebuf */
+static size_t
+printf_int_item(
+	struct ASSPF_WriteBuf *writebuf, const struct ItemFormat_Int *itemfmt,
+	uintmax_t value, size_t value_size
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+{
+	size_t retval = 0;
+
+	switch ( itemfmt->convspec ){
+	case FORMATCONVSPEC_INT_UNSET:
+		/* a compiled format that failed to compile */
+		STATS_ADD(writebuf, nformat_errors, 1u);
+		break;
+	case FORMATCONVSPEC_INT_d:
+	case FORMATCONVSPEC_INT_u:
+	case FORMATCONVSPEC_INT_b:
+	case FORMATCONVSPEC_INT_o:
+	case FORMATCONVSPEC_INT_x:
+	case FORMATCONVSPEC_INT_X:
+		retval = printf_int_body(
+			writebuf, itemfmt, value, value_size
+		);
+		break;
+	}
+
+	return retval;
+}
+
+/* ======================================================================== */
+
+/* returns value converted to a signed integer */
+/* only works with 2's-complement */
+static CONST intmax_t
+printf_read_raw_d(uintmax_t value, size_t value_size)
+/*@*/
+{
+	const uint_fast8_t shift_cnt = (uint_fast8_t) (
+		((sizeof value) - value_size) * CHAR_BIT
+	);
+
+	assert((value_size != 0) && (value_size <= sizeof value));
+
+	return asr_imax(asl_imax((intmax_t) value, shift_cnt), shift_cnt);
+}
+
+#if (UINTMAX_MAX == UINT64_MAX) && HAS_BUILTIN(__builtin_clzll)
+#define HAVE_NDIGITS_DEC_CLZ
+#endif
+
+/* returns the number of decimal digits in 'value' */
+ALWAYS_INLINE CONST size_t
+ndigits_dec(uintmax_t value)
+/*@*/
+{
+#ifdef HAVE_NDIGITS_DEC_CLZ
+	static const uintmax_t pow10[20u] = {
+		UINTMAX_C(1),
+		UINTMAX_C(10),
+		UINTMAX_C(100),
+		UINTMAX_C(1000),
+		UINTMAX_C(10000),
+		UINTMAX_C(100000),
+		UINTMAX_C(1000000),
+		UINTMAX_C(10000000),
+		UINTMAX_C(100000000),
+		UINTMAX_C(1000000000),
+		UINTMAX_C(10000000000),
+		UINTMAX_C(100000000000),
+		UINTMAX_C(1000000000000),
+		UINTMAX_C(10000000000000),
+		UINTMAX_C(100000000000000),
+		UINTMAX_C(1000000000000000),
+		UINTMAX_C(10000000000000000),
+		UINTMAX_C(100000000000000000),
+		UINTMAX_C(1000000000000000000),
+		UINTMAX_C(10000000000000000000)
+	};
+	uint_fast8_t nbits, t;
+
+	/* 'value | 1' cannot cross a power of ten, and makes 0 count as 1 */
+	value |= 1u;
+	nbits  = (uint_fast8_t) (64u - (unsigned int) __builtin_clzll(value));
+	t      = (uint_fast8_t) ((nbits * 1233u) >> 12u);	/* ~log10(2) */
+	return (size_t) t + (size_t) (value >= pow10[t]);
+#else
+	size_t retval = (size_t) 1u;
+
+	while ( value >= 10u ){
+		value  /= 10u;
+		retval += 1u;
+	}
+	return retval;
+#endif
+}
+
+/* returns the number of characters written to the end of 'dest' */
+/* only writes the significant digits */
+static size_t
+printf_w2b_u(/*@out@*/ char dest[], size_t dest_size, uintmax_t value)
+/*@modifies	*dest@*/
+{
+	size_t ndigits = ndigits_dec(value);
+	size_t nleft;
+	unsigned int r;
+
+	assert(ndigits <= dest_size);
+	/* the same bound, for when NDEBUG drops the assert; with it, and the
+	   indices counted up from 'dest_size - ndigits', gcc -O3 can see
+	   that the unrolled copies stay inside 'dest' (-Wstringop-overflow) */
+	ndigits = (ndigits > dest_size ? dest_size : ndigits);
+
+	/* two digits at a time */
+	for ( nleft = ndigits; nleft >= 2u; nleft -= 2u ){
+		r      = (unsigned int) (value % 100u);
+		value /= 100u;
+		(void) memcpy(
+			&dest[dest_size - ndigits + nleft - 2u],
+			&digit_pairs[2u * r], (size_t) 2u
+		);
+	}
+	if ( nleft != 0 ){
+		dest[dest_size - ndigits] = (char) ('0' + (char) value);
+	}
+	return ndigits;
+}
+
+/* returns the number of significant bits in 'value' (at least 1) */
+ALWAYS_INLINE CONST size_t
+nbits_umax(uintmax_t value)
+/*@*/
+{
+#if (UINTMAX_MAX == UINT64_MAX) && HAS_BUILTIN(__builtin_clzll)
+	return (size_t) (64u - (unsigned int) __builtin_clzll(value | 1u));
+#else
+	size_t retval = (size_t) 1u;
+
+	while ( (value >>= 1u) != 0 ){
+		retval += 1u;
+	}
+	return retval;
+#endif
+}
+
+/* returns the number of base-(2^'k') digits in 'value' (at least 1) */
+ALWAYS_INLINE CONST size_t
+ndigits_pow2(uintmax_t value, uint_fast8_t k)
+/*@*/
+{
+	return (nbits_umax(value) + (k - 1u)) / k;
+}
+
+/* ------------------------------------------------------------------------ */
+
+/* the SIMD digit kernels work on a uintmax_t as 8 big-endian bytes */
+#if defined(HAVE_SIMD_SSE2) && (UINTMAX_MAX == UINT64_MAX)
+#define HAVE_SIMD_W2B
+#endif
+
+/* ======================================================================== */
+
+#ifdef HAVE_SIMD_SSE2
+
+/* writes 2 * 'src_size' hex digits to 'dest' */
+/* 'alpha_off' is 'a' - '0' - 10 (lowercase) or 'A' - '0' - 10 (uppercase) */
+static void
+simd_w2b_hex(
+	/*@out@*/ char dest[], const unsigned char src[], size_t src_size,
+	char alpha_off
+)
+/*@modifies	dest[]@*/
+{
+	unsigned char src_buf[16u];
+	char          dest_buf[32u];
+	__m128i x, nib_hi, nib_lo, digits_lo, digits_hi;
+	const __m128i mask_lo = _mm_set1_epi8(0x0F);
+	const __m128i nine    = _mm_set1_epi8(9);
+	const __m128i zero_c  = _mm_set1_epi8('0');
+	const __m128i alpha_c = _mm_set1_epi8(alpha_off);
+
+	assert(src_size <= sizeof src_buf);
+
+	if ( src_size == sizeof src_buf ){
+		x = _mm_loadu_si128((const __m128i *) src);
+	}
+	else {	(void) memset(src_buf, 0, sizeof src_buf);
+		(void) memcpy(src_buf, src, src_size);
+		x = _mm_loadu_si128((const __m128i *) src_buf);
+	}
+
+	/* split into nibbles, high nibble first */
+	nib_hi    = _mm_and_si128(_mm_srli_epi16(x, 4), mask_lo);
+	nib_lo    = _mm_and_si128(x, mask_lo);
+	digits_lo = _mm_unpacklo_epi8(nib_hi, nib_lo);
+	digits_hi = _mm_unpackhi_epi8(nib_hi, nib_lo);
+
+#ifdef HAVE_SIMD_AVX2
+	{	__m256i d = _mm256_inserti128_si256(
+			_mm256_castsi128_si256(digits_lo), digits_hi, 1
+		);
+		const __m256i nine_y    = _mm256_set1_epi8(9);
+		const __m256i zero_c_y  = _mm256_set1_epi8('0');
+		const __m256i alpha_c_y = _mm256_set1_epi8(alpha_off);
+
+		d = _mm256_add_epi8(
+			_mm256_add_epi8(d, zero_c_y),
+			_mm256_and_si256(
+				_mm256_cmpgt_epi8(d, nine_y), alpha_c_y
+			)
+		);
+		_mm256_storeu_si256((__m256i *) dest_buf, d);
+	}
+	(void) nine; (void) zero_c; (void) alpha_c;
+#else
+	/* nibble -> ascii */
+	digits_lo = _mm_add_epi8(
+		_mm_add_epi8(digits_lo, zero_c),
+		_mm_and_si128(_mm_cmpgt_epi8(digits_lo, nine), alpha_c)
+	);
+	digits_hi = _mm_add_epi8(
+		_mm_add_epi8(digits_hi, zero_c),
+		_mm_and_si128(_mm_cmpgt_epi8(digits_hi, nine), alpha_c)
+	);
+	_mm_storeu_si128((__m128i *) &dest_buf[ 0u], digits_lo);
+	_mm_storeu_si128((__m128i *) &dest_buf[16u], digits_hi);
+#endif
+	(void) memcpy(dest, dest_buf, 2u * src_size);
+	return;
+}
+
+/* writes the 64 binary digits of 'src' to 'dest' */
+static void
+simd_w2b_bin8(/*@out@*/ char dest[STATIC(64u)], const unsigned char src[8u])
+/*@modifies	dest[]@*/
+{
+#ifdef HAVE_SIMD_AVX2
+	/* each byte gets spread over 8 lanes, then each lane tests its bit */
+	const __m256i bits = _mm256_setr_epi8(
+		(char) 0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01,
+		(char) 0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01,
+		(char) 0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01,
+		(char) 0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01
+	);
+	const __m256i spread_0 = _mm256_setr_epi8(
+		0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+		2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3
+	);
+	const __m256i spread_1 = _mm256_setr_epi8(
+		4, 4, 4, 4, 4, 4, 4, 4, 5, 5, 5, 5, 5, 5, 5, 5,
+		6, 6, 6, 6, 6, 6, 6, 6, 7, 7, 7, 7, 7, 7, 7, 7
+	);
+	const __m256i zero_c = _mm256_set1_epi8('0');
+	__m128i x8;
+	__m256i x, y;
+
+	x8 = _mm_loadl_epi64((const __m128i *) src);
+	x  = _mm256_inserti128_si256(_mm256_castsi128_si256(x8), x8, 1);
+
+	y = _mm256_shuffle_epi8(x, spread_0);
+	y = _mm256_cmpeq_epi8(_mm256_and_si256(y, bits), bits);
+	_mm256_storeu_si256(
+		(__m256i *) &dest[ 0u], _mm256_sub_epi8(zero_c, y)
+	);
+	y = _mm256_shuffle_epi8(x, spread_1);
+	y = _mm256_cmpeq_epi8(_mm256_and_si256(y, bits), bits);
+	_mm256_storeu_si256(
+		(__m256i *) &dest[32u], _mm256_sub_epi8(zero_c, y)
+	);
+#else
+	/* each byte gets spread over 8 lanes, then each lane tests its bit */
+	const __m128i bits = _mm_setr_epi8(
+		(char) 0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01,
+		(char) 0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01
+	);
+	const __m128i zero_c = _mm_set1_epi8('0');
+	__m128i x, x_2, x_4, y;
+
+	x   = _mm_loadl_epi64((const __m128i *) src);
+	x_2 = _mm_unpacklo_epi8(x, x);
+
+	#define SIMD_W2B_BIN_STORE(Xidx, Xvec) { \
+		y = _mm_cmpeq_epi8(_mm_and_si128(Xvec, bits), bits); \
+		_mm_storeu_si128( \
+			(__m128i *) &dest[Xidx], _mm_sub_epi8(zero_c, y) \
+		); \
+	}
+
+	x_4 = _mm_unpacklo_epi16(x_2, x_2);
+	SIMD_W2B_BIN_STORE( 0u, _mm_unpacklo_epi32(x_4, x_4));
+	SIMD_W2B_BIN_STORE(16u, _mm_unpackhi_epi32(x_4, x_4));
+	x_4 = _mm_unpackhi_epi16(x_2, x_2);
+	SIMD_W2B_BIN_STORE(32u, _mm_unpacklo_epi32(x_4, x_4));
+	SIMD_W2B_BIN_STORE(48u, _mm_unpackhi_epi32(x_4, x_4));
+#endif
+	return;
+}
+
+#endif	/* HAVE_SIMD_SSE2 */
+
+/* ------------------------------------------------------------------------ */
+
+#ifdef HAVE_SIMD_W2B
+/* writes 'value' as 8 big-endian bytes */
+ALWAYS_INLINE void
+u64_to_be(/*@out@*/ unsigned char dest[STATIC(8u)], uintmax_t value)
+/*@modifies	dest[]@*/
+{
+	size_t i;
+
+	for ( i = 0; i < (size_t) 8u; ++i ){
+		dest[7u - i] = (unsigned char) (value >> (8u * i));
+	}
+	return;
+}
+#endif	/* HAVE_SIMD_W2B */
+
+/* ======================================================================== */
+
+#ifndef HAVE_SIMD_W2B
+/* returns the number of bytes written to 'dest' */
+ALWAYS_INLINE size_t
+printf_w2b_b_nibble(/*@out@*/ char dest[STATIC(4u)], uint_fast8_t value)
+/*@modifies	dest[]@*/
+{
+	const char str[16u][4u] = {
+		{'0','0','0','0'}, {'0','0','0','1'},
+		{'0','0','1','0'}, {'0','0','1','1'},
+		{'0','1','0','0'}, {'0','1','0','1'},
+		{'0','1','1','0'}, {'0','1','1','1'},
+		{'1','0','0','0'}, {'1','0','0','1'},
+		{'1','0','1','0'}, {'1','0','1','1'},
+		{'1','1','0','0'}, {'1','1','0','1'},
+		{'1','1','1','0'}, {'1','1','1','1'}
+	};
+
+	(void) memcpy(dest, str[value & 0xFu], sizeof str[0]);
+	return sizeof str[0];
+}
+#endif	/* HAVE_SIMD_W2B */
+
+/* returns the number of characters written to the end of 'dest' */
+/* only writes the significant digits */
+static size_t
+printf_w2b_b(/*@out@*/ char dest[], size_t dest_size, uintmax_t value)
+/*@modifies	dest[]@*/
+{
+	size_t ndigits = nbits_umax(value);
+#ifdef HAVE_SIMD_W2B
+	unsigned char src[8u];
+	char          digits[64u];
+#else
+	char          nibble[4u];
+	size_t i;
+#endif
+
+	assert(ndigits <= dest_size);
+	ndigits = (ndigits > dest_size ? dest_size : ndigits);
+
+#ifdef HAVE_SIMD_W2B
+	u64_to_be(src, value);
+	simd_w2b_bin8(digits, src);
+	(void) memcpy(
+		&dest[dest_size - ndigits], &digits[(sizeof digits) - ndigits],
+		ndigits
+	);
+#else
+	for ( i = (size_t) 4u; i <= ndigits; i += 4u ){
+		(void) printf_w2b_b_nibble(
+			&dest[dest_size - i], (uint_fast8_t) value
+		);
+		value >>= 4u;
+	}
+	/* partial top nibble */
+	i -= 4u;
+	if ( i != ndigits ){
+		(void) printf_w2b_b_nibble(nibble, (uint_fast8_t) value);
+		(void) memcpy(
+			&dest[dest_size - ndigits],
+			&nibble[(sizeof nibble) - (ndigits - i)], ndigits - i
+		);
+	}
+#endif
+	return ndigits;
+}
+
+/* returns the number of characters written to the end of 'dest' */
+/* only writes the significant digits */
+static size_t
+printf_w2b_o(/*@out@*/ char dest[], size_t dest_size, uintmax_t value)
+/*@modifies	dest[]@*/
+{
+	size_t ndigits = ndigits_pow2(value, 3u);
+	unsigned char digit;
+	size_t i;
+
+	assert(ndigits <= dest_size);
+	ndigits = (ndigits > dest_size ? dest_size : ndigits);
+
+	for ( i = (size_t) 1u; i <= ndigits; ++i ){
+		digit   = (unsigned char) (value & 0x7u);
+		value >>= 3u;
+		dest[dest_size - i] = (char) ('0' + (char) digit);
+	}
+	return ndigits;
+}
+
+#ifndef HAVE_SIMD_W2B
+/* returns the number of characters written to 'dest' */
+ALWAYS_INLINE size_t
+printf_w2b_x_nibble(/*@out@*/ char dest[STATIC(1u)], uint_fast8_t value)
+/*@modifies	dest[]@*/
+{
+	const char c[16u] = {
+		'0','1','2','3','4','5','6','7',
+		'8','9','a','b','c','d','e','f'
+	};
+
+	dest[0] = c[value & 0xFu];
+	return sizeof c[0];
+}
+
+/* returns the number of characters written to 'dest' */
+ALWAYS_INLINE size_t
+printf_w2b_X_nibble(/*@out@*/ char dest[STATIC(1u)], uint_fast8_t value)
+/*@modifies	dest[]@*/
+{
+	const char c[16u] = {
+		'0','1','2','3','4','5','6','7',
+		'8','9','A','B','C','D','E','F'
+	};
+
+	dest[0] = c[value & 0xFu];
+	return sizeof c[0];
+}
+#endif	/* HAVE_SIMD_W2B */
+
+/* returns the number of characters written to the end of 'dest' */
+/* only writes the significant digits */
+ALWAYS_INLINE size_t
+printf_w2b_xX(
+	/*@out@*/ char dest[], size_t dest_size, uintmax_t value, int upper
+)
+/*@modifies	dest[]@*/
+{
+	size_t ndigits = ndigits_pow2(value, 4u);
+#ifdef HAVE_SIMD_W2B
+	unsigned char src[8u];
+	char          digits[16u];
+#else
+	size_t i;
+#endif
+
+	assert(ndigits <= dest_size);
+	ndigits = (ndigits > dest_size ? dest_size : ndigits);
+
+#ifdef HAVE_SIMD_W2B
+	u64_to_be(src, value);
+	simd_w2b_hex(
+		digits, src, sizeof src,
+		(upper == 0 ? 'a' - '0' - 10 : 'A' - '0' - 10)
+	);
+	(void) memcpy(
+		&dest[dest_size - ndigits], &digits[(sizeof digits) - ndigits],
+		ndigits
+	);
+#else
+	for ( i = (size_t) 1u; i <= ndigits; ++i ){
+		if ( upper == 0 ){
+			(void) printf_w2b_x_nibble(
+				&dest[dest_size - i], (uint_fast8_t) value
+			);
+		}
+		else {	(void) printf_w2b_X_nibble(
+				&dest[dest_size - i], (uint_fast8_t) value
+			);
+		}
+		value >>= 4u;
+	}
+#endif
+	return ndigits;
+}
+
+/* returns the number of characters written to the end of 'dest' */
+/* only writes the significant digits */
+static size_t
+printf_w2b_x(/*@out@*/ char dest[], size_t dest_size, uintmax_t value)
+/*@modifies	dest[]@*/
+{
+	return printf_w2b_xX(dest, dest_size, value, FALSE);
+}
+
+/* returns the number of characters written to the end of 'dest' */
+/* only writes the significant digits */
+static size_t
+printf_w2b_X(/*@out@*/ char dest[], size_t dest_size, uintmax_t value)
+/*@modifies	dest[]@*/
+{
+	return printf_w2b_xX(dest, dest_size, value, TRUE);
+}
+
+/* ------------------------------------------------------------------------ */
+
+/* returns the number of fraction digits ('scale') */
+/* splits '*value' into its integer part and '*fraction' */
+static size_t
+printf_fixed_split(
+	uintmax_t *value, /*@out@*/ uintmax_t *fraction, unsigned int scale
+)
+/*@modifies	*value,
+		*fraction
+@*/
+{
+	uintmax_t power = 1u;
+	unsigned int i;
+
+	assert(scale <= FORMATSCALE_MAX);
+
+	for ( i = 0; i < scale; ++i ){
+		power *= 10u;
+	}
+	*fraction = *value % power;
+	*value   /= power;
+	return (size_t) scale;
+}
+
+/* returns the maximum number of printable digits a value could need */
+static CONST size_t
+printf_ndigits_max(size_t value_size, enum FormatConvSpec_Int convspec)
+/*@*/
+{
+	size_t retval = 0;
+
+	switch ( convspec ){
+	case FORMATCONVSPEC_INT_UNSET:
+		assert(FALSE);
+		break;
+	case FORMATCONVSPEC_INT_d:
+		if ( value_size <= sizeof(int_least8_t) ){
+			retval = ilog10p1((uintmax_t) INT_LEAST8_MAX);
+		}
+		else if ( value_size <= sizeof(int_least16_t) ){
+			retval = ilog10p1((uintmax_t) INT_LEAST16_MAX);
+		}
+		else if ( value_size <= sizeof(int_least32_t) ){
+			retval = ilog10p1((uintmax_t) INT_LEAST32_MAX);
+		}
+		else if ( value_size <= sizeof(int_least64_t) ){
+			retval = ilog10p1((uintmax_t) INT_LEAST64_MAX);
+		}
+		else if ( value_size <= sizeof(intmax_t) ){
+			retval = ilog10p1((uintmax_t) INTMAX_MAX);
+		}
+		else {	retval = (size_t) 39u; }	/* 2^127 - 1 */
+		break;
+	case FORMATCONVSPEC_INT_u:
+		if ( value_size <= sizeof(uint_least8_t) ){
+			retval = ilog10p1((uintmax_t) UINT_LEAST8_MAX);
+		}
+		else if ( value_size <= sizeof(uint_least16_t) ){
+			retval = ilog10p1((uintmax_t) UINT_LEAST16_MAX);
+		}
+		else if ( value_size <= sizeof(uint_least32_t) ){
+			retval = ilog10p1((uintmax_t) UINT_LEAST32_MAX);
+		}
+		else if ( value_size <= sizeof(uint_least64_t) ){
+			retval = ilog10p1((uintmax_t) UINT_LEAST64_MAX);
+		}
+		else if ( value_size <= sizeof(uintmax_t) ){
+			retval = ilog10p1(UINTMAX_MAX);
+		}
+		else {	retval = (size_t) 39u; }	/* 2^128 - 1 */
+		break;
+	case FORMATCONVSPEC_INT_b:
+		retval = 8u * value_size;
+		break;
+	case FORMATCONVSPEC_INT_o:
+		retval = 3u * value_size;
+		break;
+	case FORMATCONVSPEC_INT_x:
+	case FORMATCONVSPEC_INT_X:
+		retval = 2u * value_size;
+		break;
+	}
+
+	return retval;
+}
+
+/* ------------------------------------------------------------------------ */
+
+/* returns the number of bytes written to dest */
+static size_t
+printf_flag_sigil_int_c(
+	/*@out@*/ char dest[STATIC(2u)], enum FormatConvSpec_Int convspec
+)
+/*@modifies	dest[]@*/
+{
+	/* const char sigil_d[0u] = {}; */
+	const char sigil_b[2u] = {'0','b'};
+	const char sigil_o[1u] = {'0'};
+	const char sigil_x[2u] = {'0','x'};
+
+	size_t retval = 0;
+
+	switch ( convspec ){
+	case FORMATCONVSPEC_INT_UNSET:
+		assert(FALSE);
+		break;
+	case FORMATCONVSPEC_INT_d:
+	case FORMATCONVSPEC_INT_u:
+		break;
+	case FORMATCONVSPEC_INT_b:
+		(void) memcpy(dest, sigil_b, sizeof sigil_b);
+		retval = sizeof sigil_b;
+		break;
+	case FORMATCONVSPEC_INT_o:
+		(void) memcpy(dest, sigil_o, sizeof sigil_o);
+		retval = sizeof sigil_o;
+		break;
+	case FORMATCONVSPEC_INT_x:
+	case FORMATCONVSPEC_INT_X:
+		(void) memcpy(dest, sigil_x, sizeof sigil_x);
+		retval = sizeof sigil_x;
+		break;
+	}
+
+	/*@-mustdefine@*/
+	return retval;
+	/*@-mustdefine@*/
+}
+
+/* returns the number of bytes written to dest */
+static size_t
+printf_flag_sigil_int_m(
+	/*@out@*/ char dest[STATIC(1u)], enum FormatConvSpec_Int convspec
+)
+/*@modifies	dest[]@*/
+{
+	const char sigil_d = '#';
+	const char sigil_b = '%';
+	const char sigil_o = '@';
+	const char sigil_x = '$';
+
+	size_t retval = 0;
+
+	switch ( convspec ){
+	case FORMATCONVSPEC_INT_UNSET:
+		assert(FALSE);
+		break;
+	case FORMATCONVSPEC_INT_d:
+	case FORMATCONVSPEC_INT_u:
+		dest[0] = sigil_d;
+		retval  = sizeof sigil_d;
+		break;
+	case FORMATCONVSPEC_INT_b:
+		dest[0] = sigil_b;
+		retval  = sizeof sigil_b;
+		break;
+	case FORMATCONVSPEC_INT_o:
+		dest[0] = sigil_o;
+		retval  = sizeof sigil_o;
+		break;
+	case FORMATCONVSPEC_INT_x:
+	case FORMATCONVSPEC_INT_X:
+		dest[0] = sigil_x;
+		retval  = sizeof sigil_x;
+		break;
+	}
+
+	/*@-mustdefine@*/
+	return retval;
+	/*@-mustdefine@*/
+}
+
+/* returns the number of bytes written to dest */
+static size_t
+printf_flag_sigil_int(
+	/*@out@*/ char dest[STATIC(2u)], const struct ItemFormat_Int *itemfmt
+)
+/*@modifies	dest[]@*/
+{
+	const unsigned int            flags    = itemfmt->flags;
+	const enum FormatConvSpec_Int convspec = itemfmt->convspec;
+
+	size_t retval = 0;
+
+	if ( (flags & FORMATFLAG_ALTFORM_C) != 0 ){
+		retval = printf_flag_sigil_int_c(dest, convspec);
+	}
+	else if ( (flags & FORMATFLAG_ALTFORM_M) != 0 ){
+		retval = printf_flag_sigil_int_m(dest, convspec);
+	}
+	else {	assert(FALSE); }
+
+	/*@-mustdefine@*/
+	return retval;
+	/*@-mustdefine@*/
+}
+
+/* ------------------------------------------------------------------------ */
+
+/* returns the number of bytes written to the buffer */
+static size_t
+printf_put_repchar(
+	struct ASSPF_WriteBuf *writebuf, char c, size_t count
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+{
+	const size_t hdr_size = ((writebuf->flags & WRITEBUF_FLAG_BINARY) != 0
+		? (size_t) BINREC_TEXT_HDR_SIZE : 0
+	);
+	char pad[16u];
+	size_t retval = 0;
+	size_t size;
+	char *dest;
+
+	while ( count != 0 ){
+		if UNLIKELY ( writebuf->limit <= hdr_size ){
+			/* no room to fill in place, it goes out from 'pad' */
+			size = (count > sizeof pad ? sizeof pad : count);
+			(void) memset(pad, (int) c, size);
+			size = asspf_write(writebuf, pad, size);
+			if UNLIKELY ( size == 0 ){
+				break;
+			}
+			retval += size;
+			count  -= size;
+			continue;
+		}
+
+		/* fill what is left of the buffer, or all of it after a flush */
+		size = writebuf->limit - writebuf->nmemb;
+		size = (size > hdr_size
+			? size - hdr_size : writebuf->limit - hdr_size
+		);
+		size = (count > size ? size : count);
+
+		dest = asspf_reserve(writebuf, size);
+		if UNLIKELY ( dest == NULL ){
+			break;
+		}
+		(void) memset(dest, (int) c, size);
+		retval += asspf_commit(writebuf, size);
+		count  -= size;
+	}
+
+	return retval;
+}
+
+/* ------------------------------------------------------------------------ */
+
+/* returns the number of significant digits in 'value' for 'convspec' */
+static size_t
+printf_ndigits(uintmax_t value, enum FormatConvSpec_Int convspec)
+/*@*/
+{
+	switch ( convspec ){
+	case FORMATCONVSPEC_INT_UNSET:
+		assert(FALSE);
+		break;
+	case FORMATCONVSPEC_INT_d:
+	case FORMATCONVSPEC_INT_u:
+		return ndigits_dec(value);
+	case FORMATCONVSPEC_INT_b:
+		return nbits_umax(value);
+	case FORMATCONVSPEC_INT_o:
+		return ndigits_pow2(value, 3u);
+	case FORMATCONVSPEC_INT_x:
+	case FORMATCONVSPEC_INT_X:
+		return ndigits_pow2(value, 4u);
+	}
+	return 0;
+}
+
+/* returns the number of characters written to the end of 'dest' */
+/* only writes the significant digits */
+static size_t
+printf_w2b(
+	/*@out@*/ char dest[], size_t dest_size, uintmax_t value,
+	enum FormatConvSpec_Int convspec
+)
+/*@modifies	dest[]@*/
+{
+	switch ( convspec ){
+	case FORMATCONVSPEC_INT_UNSET:
+		assert(FALSE);
+		break;
+	case FORMATCONVSPEC_INT_d:
+	case FORMATCONVSPEC_INT_u:
+		return printf_w2b_u(dest, dest_size, value);
+	case FORMATCONVSPEC_INT_b:
+		return printf_w2b_b(dest, dest_size, value);
+	case FORMATCONVSPEC_INT_o:
+		return printf_w2b_o(dest, dest_size, value);
+	case FORMATCONVSPEC_INT_x:
+		return printf_w2b_x(dest, dest_size, value);
+	case FORMATCONVSPEC_INT_X:
+		return printf_w2b_X(dest, dest_size, value);
+	}
+	return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+
+/* the widest value printf_int_layout() and co. take */
+#ifdef HAVE_PRINTF_INT128
+#define PRINTFINT_VALUE_SIZE_MAX	(sizeof(UInt128))
+#else
+#define PRINTFINT_VALUE_SIZE_MAX	(sizeof(uintmax_t))
+#endif
+
+struct PrintfInt_Layout {
+	char		digit_buf[CHAR_BIT * PRINTFINT_VALUE_SIZE_MAX];	/* %b */
+	size_t		digit_idx;
+	size_t		ndigits;
+	/* the last 'value_ndigits' of 'ndigits' are not in digit_buf, they
+	   are converted from 'value' straight into the destination */
+	uintmax_t	value;
+	size_t		value_ndigits;
+	enum FormatConvSpec_Int	value_convspec;
+	char		sigil_buf[2u];
+	size_t		sigil_size;
+	char		sign_c;
+	size_t		sign_size;
+	size_t		precision_pad;
+	int		adjust_type;	/* 0: none, >0: right <0: left */
+	size_t		adjust_size;
+	char		adjust_c;	/* only for right adjustment */
+};
+
+/* ------------------------------------------------------------------------ */
+
+/* returns the number of bytes the printf-integer will take up */
+/* the rest of the layout, once the base digits are at the end of
+   'digit_buf[0 .. ndigits_max)' (or only counted, see the caller) */
+static size_t
+printf_int_layout_finish(
+	struct PrintfInt_Layout *layout, const struct ItemFormat_Int *itemfmt,
+	size_t ndigits_max, size_t ndigits_base, char sign_c,
+	uintmax_t fraction, size_t fraction_size
+)
+/*@modifies	*layout@*/
+{
+	char   *const digit_buf = layout->digit_buf;
+	unsigned int ndigits;
+	size_t sigil_size = 0;
+	size_t sign_size = 0;
+	unsigned int precision_pad = 0;
+	size_t printed_size;
+
+	/* altform sigil */
+	if ( (itemfmt->flags & FORMATFLAG_ALTFORM_ALL) != 0 ){
+		sigil_size = printf_flag_sigil_int(layout->sigil_buf, itemfmt);
+	}
+
+	/* sign ('-', '+', or ' ') */
+	if ( itemfmt->convspec == FORMATCONVSPEC_INT_d ){
+		switch ( sign_c ){
+		default:
+			assert(FALSE);
+			break;
+		case '-':
+			sign_size = (size_t) 1u;
+			break;
+		case '+':
+			if ( (itemfmt->flags & FORMATFLAG_ALWAYS_SIGN) != 0 ){
+				sign_size = (size_t) 1u;
+				break;
+			}
+			if ( (itemfmt->flags & FORMATFLAG_BLANK_SIGN) != 0 ){
+				sign_c    = ' ';
+				sign_size = (size_t) 1u;
+				break;
+			}
+			break;
+		}
+	}
+
+	/* precision calculation (of the integer part, if fixed-point) */
+	ndigits = (unsigned int) ndigits_base;
+	if ( itemfmt->precision == FORMATPRECISION_NATURAL ){
+		ndigits = (unsigned int) (ndigits_max > fraction_size
+			? ndigits_max - fraction_size : (size_t) 1u
+		);
+	}
+	else if ( itemfmt->precision > ndigits ){
+		ndigits = itemfmt->precision;
+		if ( itemfmt->precision > (unsigned int) ndigits_max ){
+			ndigits       = (unsigned int) ndigits_max;
+			precision_pad =	itemfmt->precision - ndigits;
+		}
+	} else{;}
+
+	/* leading zeros inside of digit_buf */
+	if ( (size_t) ndigits > ndigits_base ){
+		(void) memset(
+			&digit_buf[ndigits_max - ndigits], (int) '0',
+			((size_t) ndigits) - ndigits_base
+		);
+	}
+
+	/* fixed-point fraction, right after the integer part */
+	if ( fraction_size != 0 ){
+		digit_buf[ndigits_max] = '.';
+		(void) memset(
+			&digit_buf[ndigits_max + 1u], (int) '0', fraction_size
+		);
+		(void) printf_w2b_u(
+			&digit_buf[ndigits_max + 1u], fraction_size, fraction
+		);
+		ndigits_max += 1u + fraction_size;
+	}
+
+	layout->digit_idx	= ndigits_max - fraction_size - ndigits
+				- (fraction_size != 0 ? 1u : 0u);
+	layout->ndigits		= ndigits_max - layout->digit_idx;
+	layout->sigil_size	= sigil_size;
+	layout->sign_c		= sign_c;
+	layout->sign_size	= sign_size;
+	layout->precision_pad	= (size_t) precision_pad;
+	layout->adjust_type	= 0;
+	layout->adjust_size	= 0;
+	layout->adjust_c	= '\0';
+	layout->value		= 0;
+	layout->value_ndigits	= 0;
+	layout->value_convspec	= itemfmt->convspec;
+
+	/* pre-adjustment calculations */
+	printed_size = sigil_size + sign_size + precision_pad
+		+ layout->ndigits;
+	if ( printed_size < (size_t) itemfmt->fieldwidth ){
+		layout->adjust_type = (
+			(itemfmt->flags & FORMATFLAG_LEFT_ADJUST) == 0 ? 1 : -1
+		);
+		layout->adjust_size = (
+			((size_t) itemfmt->fieldwidth) - printed_size
+		);
+		layout->adjust_c    = (
+			(itemfmt->flags & FORMATFLAG_ZERO_PAD) == 0 ? ' ' : '0'
+		);
+		printed_size = (size_t) itemfmt->fieldwidth;
+	}
+
+	return printed_size;
+}
+
+/* returns the number of bytes the printf-integer will take up */
+static size_t
+printf_int_layout(
+	/*@out@*/ struct PrintfInt_Layout *layout,
+	const struct ItemFormat_Int *itemfmt, uintmax_t value,
+	const size_t value_size
+)
+/*@modifies	*layout@*/
+{
+	char   *const digit_buf = layout->digit_buf;
+	size_t ndigits_max;
+	size_t ndigits_base = 0;
+	char   sign_c = '+';
+	size_t fraction_size = 0;
+	uintmax_t fraction = 0;
+	size_t size;
+
+	assert((value_size != 0) && (value_size <= sizeof value));
+
+	/* maximum number of digit_buf bytes to use */
+	ndigits_max = printf_ndigits_max(value_size, itemfmt->convspec);
+	assert(ndigits_max != 0);
+
+	/* base number */
+	switch ( itemfmt->convspec ){
+	case FORMATCONVSPEC_INT_UNSET:
+		assert(FALSE);
+		break;
+	case FORMATCONVSPEC_INT_d:
+		value  = (uintmax_t) printf_read_raw_d(value, value_size);
+		sign_c = ((intmax_t) value < 0 ? '-' : '+');
+		value  = abs_imax((intmax_t) value);
+		/*@fallthrough@*/
+	case FORMATCONVSPEC_INT_u:
+		if ( itemfmt->scale != FORMATSCALE_UNSET ){
+			fraction_size = printf_fixed_split(
+				&value, &fraction, itemfmt->scale
+			);
+		}
+		break;
+	case FORMATCONVSPEC_INT_b:
+	case FORMATCONVSPEC_INT_o:
+	case FORMATCONVSPEC_INT_x:
+	case FORMATCONVSPEC_INT_X:
+		break;
+	}
+
+	/* a fixed-point integer part goes in digit_buf, ahead of the '.',
+	   otherwise only the digit count is needed until printing */
+	if ( fraction_size != 0 ){
+		ndigits_base = printf_w2b(
+			digit_buf, ndigits_max, value, itemfmt->convspec
+		);
+		return printf_int_layout_finish(
+			layout, itemfmt, ndigits_max, ndigits_base, sign_c,
+			fraction, fraction_size
+		);
+	}
+	ndigits_base = printf_ndigits(value, itemfmt->convspec);
+	size = printf_int_layout_finish(
+		layout, itemfmt, ndigits_max, ndigits_base, sign_c, 0, 0
+	);
+	layout->value		= value;
+	layout->value_ndigits	= ndigits_base;
+	return size;
+}
+
+/* ------------------------------------------------------------------------ */
+
+/* returns the number of bytes written to 'dest' */
+/* 'dest' must have room for the size printf_int_layout() returned */
+static size_t
+printf_int_emit(
+	/*@out@*/ char *dest, const struct PrintfInt_Layout *layout
+)
+/*@modifies	*dest@*/
+{
+	size_t retval = 0;
+	size_t nbytes;
+
+	#define PRINTFINT_EMIT_SIGIL_SIGN { \
+		(void) memcpy( \
+			&dest[retval], layout->sigil_buf, layout->sigil_size \
+		); \
+		retval += layout->sigil_size; \
+		if ( layout->sign_size != 0 ){ \
+			dest[retval] = layout->sign_c; \
+			retval      += layout->sign_size; \
+		} \
+	}
+
+	/* sigil & sign 1 */
+	if ( (layout->adjust_type > 0) && (layout->adjust_c == '0') ){
+		PRINTFINT_EMIT_SIGIL_SIGN;
+	}
+	/* right adjustment */
+	if ( layout->adjust_type > 0 ){
+		(void) memset(
+			&dest[retval], (int) layout->adjust_c,
+			layout->adjust_size
+		);
+		retval += layout->adjust_size;
+	}
+	/* sigil & sign 2 */
+	if ( (layout->adjust_type <= 0) || (layout->adjust_c == ' ') ){
+		PRINTFINT_EMIT_SIGIL_SIGN;
+	}
+	/* precision padding */
+	(void) memset(&dest[retval], (int) '0', layout->precision_pad);
+	retval += layout->precision_pad;
+	/* base (leading zeros from digit_buf, then the deferred digits) */
+	nbytes = layout->ndigits - layout->value_ndigits;
+	(void) memcpy(
+		&dest[retval], &layout->digit_buf[layout->digit_idx], nbytes
+	);
+	retval += nbytes;
+	if ( layout->value_ndigits != 0 ){
+		retval += printf_w2b(
+			&dest[retval], layout->value_ndigits, layout->value,
+			layout->value_convspec
+		);
+	}
+	/* left adjustment */
+	if ( layout->adjust_type < 0 ){
+		(void) memset(&dest[retval], (int) ' ', layout->adjust_size);
+		retval += layout->adjust_size;
 	}
 
-	/* sum the digits */
-	number = 0, power = 1u;
-	for ( i = ndigits; i-- != 0; power *= 10u ){
-		temp = power * ((unsigned int) (str[i] - '0'));
-		if UNLIKELY ( UINT_MAX - number < temp ){
-			number  = UINT_MAX;
-			break;
-		}
-		else {	number += temp; }
+	/*@-mustdefine@*/
+	return retval;
+	/*@=mustdefine@*/
+}
+
+/* returns the number of bytes written to the writebuf */
+/* piecewise version of printf_int_emit(), for when it does not fit */
+static size_t
+printf_int_put(
+	struct ASSPF_WriteBuf *writebuf, const struct PrintfInt_Layout *layout
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+{
+	size_t retval = 0;
+	char   digits[CHAR_BIT * sizeof(uintmax_t)];	/* %b */
+	size_t nbytes;
+
+	#define PRINTFINT_PUT_SIGIL_SIGN { \
+		if ( layout->sigil_size != 0 ){ \
+			retval += asspf_write( \
+				writebuf, layout->sigil_buf, \
+				layout->sigil_size \
+			); \
+		} \
+		if ( layout->sign_size != 0 ){ \
+			retval += asspf_write( \
+				writebuf, &layout->sign_c, \
+				layout->sign_size \
+			); \
+		} \
 	}
 
-	*dest = number;
-	return ndigits;
+	/* sigil & sign 1 */
+	if ( (layout->adjust_type > 0) && (layout->adjust_c == '0') ){
+		PRINTFINT_PUT_SIGIL_SIGN;
+	}
+	/* right adjustment */
+	if ( layout->adjust_type > 0 ){
+		retval += printf_put_repchar(
+			writebuf, layout->adjust_c, layout->adjust_size
+		);
+	}
+	/* sigil & sign 2 */
+	if ( (layout->adjust_type <= 0) || (layout->adjust_c == ' ') ){
+		PRINTFINT_PUT_SIGIL_SIGN;
+	}
+	/* precision padding */
+	if ( layout->precision_pad != 0 ){
+		retval += printf_put_repchar(
+			writebuf, '0', layout->precision_pad
+		);
+	}
+	/* base */
+	nbytes = layout->ndigits - layout->value_ndigits;
+	if ( nbytes != 0 ){
+		retval += asspf_write(
+			writebuf, &layout->digit_buf[layout->digit_idx],
+			nbytes
+		);
+	}
+	if ( layout->value_ndigits != 0 ){
+		nbytes = printf_w2b(
+			digits, layout->value_ndigits, layout->value,
+			layout->value_convspec
+		);
+		retval += asspf_write(writebuf, digits, nbytes);
+	}
+	/* left adjustment */
+	if ( layout->adjust_type < 0 ){
+		retval += printf_put_repchar(
+			writebuf, ' ', layout->adjust_size
+		);
+	}
+
+	return retval;
 }
 
-/* //////////////////////////////////////////////////////////////////////// */
+/* ------------------------------------------------------------------------ */
 
-#define FORMATFLAG_NONE			0x00u
-#define FORMATFLAG_ALTFORM_C		0x01u
-#define FORMATFLAG_ALTFORM_M		0x02u
-#define FORMATFLAG_ZERO_PAD		0x04u
-#define FORMATFLAG_LEFT_ADJUST		0x08u
-#define FORMATFLAG_BLANK_SIGN		0x10u
-#define FORMATFLAG_ALWAYS_SIGN		0x20u
+/* returns the number of bytes written to the writebuf */
+/* 'size' is what the layout function returned */
+static size_t
+printf_int_write(
+	struct ASSPF_WriteBuf *writebuf, const struct PrintfInt_Layout *layout,
+	size_t size
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+{
+	char *dest;
 
-#define FORMATFLAG_ALTFORM_ALL		\
-	(FORMATFLAG_ALTFORM_C | FORMATFLAG_ALTFORM_M)
+	/* format in place if it can fit, otherwise a piece at a time */
+	dest = asspf_reserve(writebuf, size);
+	if LIKELY ( dest != NULL ){
+		size = printf_int_emit(dest, layout);
+		return asspf_commit(writebuf, size);
+	}
+	else {	return printf_int_put(writebuf, layout); }
+}
 
-#define FORMATFIELDWIDTH_UNSET		0u
+/* ------------------------------------------------------------------------ */
 
-#define FORMATPRECISION_UNSET		1u
-#define FORMATPRECISION_NATURAL		0u
+/* returns the number of bytes written to the writebuf */
+static size_t
+printf_int_body(
+	struct ASSPF_WriteBuf *writebuf, const struct ItemFormat_Int *itemfmt,
+	uintmax_t value, const size_t value_size
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+{
+	struct PrintfInt_Layout layout;
+	size_t size;
 
-enum FormatConvSpec_Int {
-	FORMATCONVSPEC_INT_UNSET,
-	FORMATCONVSPEC_INT_d,
-	FORMATCONVSPEC_INT_u,
-	FORMATCONVSPEC_INT_b,
-	FORMATCONVSPEC_INT_o,
-	FORMATCONVSPEC_INT_x,
-	FORMATCONVSPEC_INT_X
-};
+	size = printf_int_layout(&layout, itemfmt, value, value_size);
+	return printf_int_write(writebuf, &layout, size);
+}
 
-/* ======================================================================== */
+/* //////////////////////////////////////////////////////////////////////// */
 
-struct ItemFormat_Int {
-	unsigned int		flags;
-	unsigned int		fieldwidth;
-	unsigned int		precision;
-	enum FormatConvSpec_Int	convspec;
+/* an argument for asspf_printr() */
+struct ASSPF_Arg {
+	/*@null@*/ /*@temp@*/
+	const char	*str;
+	uintmax_t	 value;
+	size_t		 size;	/* 0 for 'str' */
+};
+
+enum PrintR_Mode {
+	PRINTR_MODE_MEASURE,
+	PRINTR_MODE_EMIT,	/* into reserved writebuf memory */
+	PRINTR_MODE_PUT		/* piecewise into the writebuf */
 };
 
 /* ------------------------------------------------------------------------ */
 
-/* returns a defined struct */
-ALWAYS_INLINE CONST struct ItemFormat_Int
-itemformat_int_get(
-	unsigned int flags, unsigned int fieldwidth, unsigned int precision,
-	enum FormatConvSpec_Int convspec
-)
+/* returns the integer argument truncated to its size */
+ALWAYS_INLINE CONST uintmax_t
+printr_arg_value(uintmax_t value, size_t size)
 /*@*/
 {
-	struct ItemFormat_Int retval;
+	const uint_fast8_t shift_cnt = (uint_fast8_t) (
+		((sizeof value) - size) * CHAR_BIT
+	);
 
-	retval.flags		= flags;
-	retval.fieldwidth	= fieldwidth;
-	retval.precision	= precision;
-	retval.convspec		= convspec;
+	assert((size != 0) && (size <= sizeof value));
 
-	return retval;
+	return (value << shift_cnt) >> shift_cnt;
 }
 
-/* ======================================================================== */
-
-#define FORMATREAD_ERROR { \
-	if UNLIKELY ( TRUE ) { \
-		/*@-mustmod@*/ /*@-mustdefine@*/\
-		return SIZE_MAX; \
-		/*@=mustmod@*/ /*@=mustdefine@*/\
-	} \
-}
-#define CHECK_FORMATBUF { \
-	if UNLIKELY ( format_idx == format_len ){ \
-		FORMATREAD_ERROR; \
-	} \
-}
-#define SET_FORMATFIELD_A2INT(Xfield){ \
-	size_t x_setffa2int_ndigits; \
-	x_setffa2int_ndigits = ascii_a2uint( \
-		&format[format_idx], format_len - format_idx, \
-		&Xfield \
-	); \
-	if ( (x_setffa2int_ndigits == 0) \
-	    || \
-	     (Xfield > (unsigned int) INT_MAX) \
-	){ \
-		FORMATREAD_ERROR; \
-	} \
-	format_idx += x_setffa2int_ndigits; \
-}
+/* ------------------------------------------------------------------------ */
 
-/* returns the number of bytes processed, or SIZE_MAX on error */
+/* returns the number of bytes measured or written, or SIZE_MAX on error */
+/* errors are only caught in PRINTR_MODE_MEASURE */
 static size_t
-format_scan_flags(
-	/*@out@*/ unsigned int *flags_out, const char *format,
-	size_t format_len
+printr_run(
+	/*@null@*/ struct ASSPF_WriteBuf *writebuf, /*@null@*/ char *dest,
+	const char *tmpl, size_t tmpl_len, const struct ASSPF_Arg args[],
+	size_t nargs, enum PrintR_Mode mode
 )
-/*@modifies	*flags_out@*/
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf,
+		*dest
+@*/
 {
-	size_t       format_idx		= 0;
-	unsigned int format_flags	= FORMATFLAG_NONE;
+	size_t retval = 0;
+	size_t tmpl_idx = 0, arg_idx = 0;
+	const char *lit;
+	size_t lit_size;
+	const char *pct;
+	struct ItemFormat_Int itemfmt;
+	struct PrintfInt_Layout layout;
+	size_t fmt_size, nbytes;
 
-	#define SET_FORMATFLAG(Xflag) { \
-		if UNLIKELY ( (format_flags & Xflag) != 0 ){ \
-			FORMATREAD_ERROR; \
+	#define PRINTR_ERROR { \
+		if UNLIKELY ( TRUE ) { \
+			return SIZE_MAX; \
+		} \
+	}
+	#define PRINTR_LITERAL(Xsrc, Xsize) { \
+		switch ( mode ){ \
+		case PRINTR_MODE_MEASURE: \
+			retval += (Xsize); \
+			break; \
+		case PRINTR_MODE_EMIT: \
+			assert(dest != NULL); \
+			(void) memcpy(&dest[retval], Xsrc, Xsize); \
+			retval += (Xsize); \
+			break; \
+		case PRINTR_MODE_PUT: \
+			assert(writebuf != NULL); \
+			retval += asspf_write(writebuf, Xsrc, Xsize); \
+			break; \
 		} \
-		format_flags |= Xflag; \
-		format_idx   += 1u; \
 	}
 
-	get_flag:
-	CHECK_FORMATBUF;
-	switch ( format[format_idx] ){
-	case '#':
-		SET_FORMATFLAG(FORMATFLAG_ALTFORM_C);
-		goto get_flag;
-	case '$':
-		SET_FORMATFLAG(FORMATFLAG_ALTFORM_M);
-		goto get_flag;
-	case '0':
-		SET_FORMATFLAG(FORMATFLAG_ZERO_PAD);
-		goto get_flag;
-	case '-':
-		SET_FORMATFLAG(FORMATFLAG_LEFT_ADJUST);
-		goto get_flag;
-	case ' ':
-		SET_FORMATFLAG(FORMATFLAG_BLANK_SIGN);
-		goto get_flag;
-	case '+':
-		SET_FORMATFLAG(FORMATFLAG_ALWAYS_SIGN);
-		goto get_flag;
-	default:
-		break;
+	while ( tmpl_idx < tmpl_len ){
+		/* literal text */
+		pct = memchr(&tmpl[tmpl_idx], '%', tmpl_len - tmpl_idx);
+		lit_size = (pct != NULL
+			? (size_t) (pct - &tmpl[tmpl_idx])
+			: tmpl_len - tmpl_idx
+		);
+		if ( lit_size != 0 ){
+			PRINTR_LITERAL(&tmpl[tmpl_idx], lit_size);
+			tmpl_idx += lit_size;
+			continue;
+		}
+
+		/* placeholder */
+		tmpl_idx += 1u;
+		if UNLIKELY ( tmpl_idx == tmpl_len ){
+			PRINTR_ERROR;
+		}
+		switch ( tmpl[tmpl_idx] ){
+		case '%':
+			PRINTR_LITERAL(&tmpl[tmpl_idx], (size_t) 1u);
+			tmpl_idx += 1u;
+			break;
+		case 's':
+			if UNLIKELY ( (arg_idx == nargs)
+			             ||
+			              (args[arg_idx].size != 0)
+			             ||
+			              (args[arg_idx].str == NULL)
+			){
+				PRINTR_ERROR;
+			}
+			lit = args[arg_idx].str;
+			lit_size = strlen(lit);
+			PRINTR_LITERAL(lit, lit_size);
+			tmpl_idx += 1u;
+			arg_idx  += 1u;
+			break;
+		default:
+			fmt_size = format_scan_int_prefix(
+				&itemfmt, &tmpl[tmpl_idx], tmpl_len - tmpl_idx
+			);
+			if UNLIKELY ( (fmt_size == SIZE_MAX)
+			             ||
+			              (arg_idx == nargs)
+			             ||
+			              (args[arg_idx].size == 0)
+			             ||
+			              (args[arg_idx].size > sizeof(uintmax_t))
+			){
+				PRINTR_ERROR;
+			}
+			nbytes = printf_int_layout(
+				&layout, &itemfmt,
+				printr_arg_value(
+					args[arg_idx].value, args[arg_idx].size
+				),
+				args[arg_idx].size
+			);
+			switch ( mode ){
+			case PRINTR_MODE_MEASURE:
+				break;
+			case PRINTR_MODE_EMIT:
+				assert(dest != NULL);
+				nbytes = printf_int_emit(&dest[retval], &layout);
+				break;
+			case PRINTR_MODE_PUT:
+				assert(writebuf != NULL);
+				nbytes = printf_int_put(writebuf, &layout);
+				break;
+			}
+			retval   += nbytes;
+			tmpl_idx += fmt_size;
+			arg_idx  += 1u;
+			break;
+		}
+	}
+	if UNLIKELY ( arg_idx != nargs ){
+		PRINTR_ERROR;
 	}
 
-	*flags_out = format_flags;
-	return format_idx;
+	return retval;
 }
 
-/* returns the number of bytes processed, or SIZE_MAX on error */
-static size_t
-format_scan_fieldwidth(
-	/*@out@*/ unsigned int *fieldwidth_out, const char *format,
-	size_t format_len
+/* ======================================================================== */
+
+/* returns the number of bytes written to the writebuf */
+/* returns 0 (and writes nothing) if 'tmpl' and 'args' do not match */
+size_t
+asspf_printr(
+	struct ASSPF_WriteBuf *writebuf, const char *tmpl,
+	const struct ASSPF_Arg args[], size_t nargs
 )
-/*@modifies	*fieldwidth_out@*/
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+{
+	const size_t tmpl_len = strlen(tmpl);
+	size_t size, retval;
+	char *dest;
+
+	/* check the whole record and total up its size */
+	size = printr_run(
+		NULL, NULL, tmpl, tmpl_len, args, nargs, PRINTR_MODE_MEASURE
+	);
+	if UNLIKELY ( size == SIZE_MAX ){
+		STATS_ADD(writebuf, nformat_errors, 1u);
+		return 0;
+	}
+
+	/* write it in one go if it can fit, otherwise a piece at a time */
+	dest = asspf_reserve(writebuf, size);
+	if LIKELY ( dest != NULL ){
+		retval = printr_run(
+			NULL, dest, tmpl, tmpl_len, args, nargs,
+			PRINTR_MODE_EMIT
+		);
+		assert(retval == size);
+		retval = asspf_commit(writebuf, retval);
+	}
+	else {	retval = printr_run(
+			writebuf, NULL, tmpl, tmpl_len, args, nargs,
+			PRINTR_MODE_PUT
+		);
+	}
+
+	return retval;
+}
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/* record output styles (matches ASSPF_RECORD_*) */
+enum Record_Style {
+	RECORD_STYLE_JSON,	/* {"key":value,...}\n */
+	RECORD_STYLE_LOGFMT	/* key=value ...\n */
+};
+
+enum Field_Type {
+	FIELD_TYPE_INT,		/* decimal signed */
+	FIELD_TYPE_UINT,	/* decimal unsigned */
+	FIELD_TYPE_HEX,		/* "0x" hexadecimal */
+	FIELD_TYPE_STR
+};
+
+/* a key/value pair of a record */
+struct ASSPF_Field {
+	/*@temp@*/
+	const char	*key;
+	/*@null@*/ /*@temp@*/
+	const char	*str;
+	uintmax_t	 value;	/* the size of 'str' for FIELD_TYPE_STR */
+	size_t		 key_size;
+	enum Field_Type	 type;
+};
+
+/* a record being built (fields are only gathered until the end) */
+struct ASSPF_Record {
+	/*@temp@*/
+	struct ASSPF_Field	*fields;
+	size_t			nfields_max;
+	size_t			nfields;
+	enum Record_Style	style;
+	int			error;	/* bad style or key, too many fields */
+};
+
+/* ------------------------------------------------------------------------ */
+
+/* returns whether a logfmt string can go without quotes */
+/* (a key has to, since logfmt has no quoted keys) */
+static int
+record_logfmt_bare(const char *str, size_t size)
+/*@*/
 {
-	size_t       format_idx		= 0;
-	unsigned int format_fieldwidth	= FORMATFIELDWIDTH_UNSET;
+	size_t i;
 
-	CHECK_FORMATBUF;
-	if ( ascii_isdigit(format[format_idx]) != 0 ){
-		SET_FORMATFIELD_A2INT(format_fieldwidth);
+	if ( size == 0 ){
+		return FALSE;
 	}
-
-	*fieldwidth_out = format_fieldwidth;
-	return format_idx;
+	for ( i = 0; i < size; ++i ){
+		if (
+			((unsigned char) str[i] <= (unsigned char) ' ')
+		||
+			(str[i] == '=') || (str[i] == '"') || (str[i] == '\\')
+		){
+			return FALSE;
+		}
+	}
+	return TRUE;
 }
 
-/* returns the number of bytes processed, or SIZE_MAX on error */
+/* returns the number of chars 'src' takes up escaped */
 static size_t
-format_scan_precision(
-	/*@out@*/ unsigned int *precision_out, const char *format,
-	size_t format_len
-)
-/*@modifies	*precision_out@*/
+escape_measure(const char *src, size_t size, int mode)
+/*@*/
 {
-	size_t       format_idx		= 0;
-	unsigned int format_precision	= FORMATPRECISION_UNSET;
-
-	CHECK_FORMATBUF;
-	if ( format[format_idx] == '.' ){
-		format_idx += 1u;
-		CHECK_FORMATBUF;
-		if ( ascii_isdigit(format[format_idx]) != 0 ){
-			SET_FORMATFIELD_A2INT(format_precision);
+	char tmp[ESCAPE_SIZE_MAX];
+	size_t retval = size;
+	size_t i = 0;
+
+	for (;;){
+		i += escape_scan(&src[i], size - i, mode);
+		if ( i == size ){
+			return retval;
 		}
-		else {	FORMATREAD_ERROR; }
+		retval += escape_put_char(tmp, src[i++], mode) - 1u;
 	}
-
-	*precision_out = format_precision;
-	return format_idx;
 }
 
-/* returns the number of bytes processed, or SIZE_MAX on error */
+/* returns the number of bytes measured or written */
+/* (PRINTR_LITERAL, with printr_run()'s variables, is reused for the text) */
 static size_t
-format_scan_convspec_int(
-	/*@out@*/ enum FormatConvSpec_Int *convspec_out, const char *format,
-	size_t format_len
+record_run(
+	/*@null@*/ struct ASSPF_WriteBuf *writebuf, /*@null@*/ char *dest,
+	const struct ASSPF_Record *rec, enum PrintR_Mode mode
 )
-/*@modifies	*convspec_out@*/
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf,
+		*dest
+@*/
 {
-	size_t                  format_idx	= 0;
-	enum FormatConvSpec_Int format_convspec	= FORMATCONVSPEC_INT_UNSET;
+	const int json = (int) (rec->style == RECORD_STYLE_JSON);
+	size_t retval = 0;
+	const struct ASSPF_Field *field;
+	struct ItemFormat_Int itemfmt;
+	struct PrintfInt_Layout layout;
+	size_t i, idx, nbytes;
+	int quote;
+
+	#define RECORD_ESCAPED(Xsrc, Xsize) { \
+		switch ( mode ){ \
+		case PRINTR_MODE_MEASURE: \
+			retval += escape_measure( \
+				Xsrc, Xsize, ESCAPE_MODE_JSON \
+			); \
+			break; \
+		case PRINTR_MODE_EMIT: \
+			/* the room was measured already */ \
+			assert(dest != NULL); \
+			idx     = 0; \
+			retval += escape_fill( \
+				&dest[retval], SIZE_MAX, Xsrc, Xsize, &idx, \
+				ESCAPE_MODE_JSON \
+			); \
+			break; \
+		case PRINTR_MODE_PUT: \
+			assert(writebuf != NULL); \
+			retval += escape_write( \
+				writebuf, Xsrc, Xsize, ESCAPE_MODE_JSON \
+			); \
+			break; \
+		} \
+	}
 
-	CHECK_FORMATBUF;
-	switch ( format[format_idx] ){
-	case 'd':
-		format_convspec = FORMATCONVSPEC_INT_d;
-		break;
-	case 'u':
-		format_convspec = FORMATCONVSPEC_INT_u;
-		break;
-	case 'b':
-		format_convspec = FORMATCONVSPEC_INT_b;
-		break;
-	case 'o':
-		format_convspec = FORMATCONVSPEC_INT_o;
-		break;
-	case 'x':
-		format_convspec = FORMATCONVSPEC_INT_x;
-		break;
-	case 'X':
-		format_convspec = FORMATCONVSPEC_INT_X;
-		break;
-	default:
-		FORMATREAD_ERROR;
+	if ( json ){
+		PRINTR_LITERAL("{", (size_t) 1u);
 	}
-	format_idx += 1u;
+	for ( i = 0; i < rec->nfields; ++i ){
+		field = &rec->fields[i];
 
-	*convspec_out = format_convspec;
-	return format_idx;
-}
+		/* separator and key */
+		if ( json ){
+			if ( i != 0 ){
+				PRINTR_LITERAL(",", (size_t) 1u);
+			}
+			PRINTR_LITERAL("\"", (size_t) 1u);
+			RECORD_ESCAPED(field->key, field->key_size);
+			PRINTR_LITERAL("\":", (size_t) 2u);
+		}
+		else {	if ( i != 0 ){
+				PRINTR_LITERAL(" ", (size_t) 1u);
+			}
+			PRINTR_LITERAL(field->key, field->key_size);
+			PRINTR_LITERAL("=", (size_t) 1u);
+		}
 
-/* ======================================================================== */
+		/* value */
+		if ( field->type == FIELD_TYPE_STR ){
+			assert(field->str != NULL);
+			quote = (json
+				|| ! record_logfmt_bare(
+					field->str, (size_t) field->value
+				)
+			);
+			if ( quote ){
+				PRINTR_LITERAL("\"", (size_t) 1u);
+			}
+			RECORD_ESCAPED(field->str, (size_t) field->value);
+			if ( quote ){
+				PRINTR_LITERAL("\"", (size_t) 1u);
+			}
+			continue;
+		}
 
-#define FORMATSCAN(Xfn, Xvar){ \
-	size_t x_formatscan_nbytesread; \
-	x_formatscan_nbytesread = Xfn( \
-		&Xvar, &format[format_idx], format_len - format_idx \
-	); \
-	if UNLIKELY ( x_formatscan_nbytesread == SIZE_MAX ){ \
-		return 1; \
-	} \
-	format_idx += x_formatscan_nbytesread; \
+		/* JSON has no hex numbers, so those are strings */
+		quote = (int) (json && (field->type == FIELD_TYPE_HEX));
+		if ( quote ){
+			PRINTR_LITERAL("\"", (size_t) 1u);
+		}
+		itemfmt = itemformat_int_get(
+			(field->type == FIELD_TYPE_HEX
+				? FORMATFLAG_ALTFORM_C : FORMATFLAG_NONE
+			),
+			FORMATFIELDWIDTH_UNSET, FORMATPRECISION_UNSET,
+			FORMATSCALE_UNSET,
+			(field->type == FIELD_TYPE_INT ? FORMATCONVSPEC_INT_d
+				: field->type == FIELD_TYPE_UINT
+					? FORMATCONVSPEC_INT_u
+					: FORMATCONVSPEC_INT_x
+			)
+		);
+		nbytes = printf_int_layout(
+			&layout, &itemfmt, field->value, sizeof field->value
+		);
+		switch ( mode ){
+		case PRINTR_MODE_MEASURE:
+			break;
+		case PRINTR_MODE_EMIT:
+			assert(dest != NULL);
+			nbytes = printf_int_emit(&dest[retval], &layout);
+			break;
+		case PRINTR_MODE_PUT:
+			assert(writebuf != NULL);
+			nbytes = printf_int_put(writebuf, &layout);
+			break;
+		}
+		retval += nbytes;
+		if ( quote ){
+			PRINTR_LITERAL("\"", (size_t) 1u);
+		}
+	}
+	if ( json ){
+		PRINTR_LITERAL("}", (size_t) 1u);
+	}
+	PRINTR_LITERAL("\n", (size_t) 1u);
+
+	return retval;
 }
 
 /* returns 0 on success */
+/* returns 1 if the record has no room left for another field,
+   or 'key' cannot be a logfmt key */
 static int
-format_scan_int(/*@out@*/ struct ItemFormat_Int *itemfmt, const char *format)
-/*@modifies	*itemfmt@*/
+record_add(
+	struct ASSPF_Record *rec, const char *key, enum Field_Type type,
+	/*@null@*/ const char *str, uintmax_t value
+)
+/*@modifies	*rec@*/
 {
-	const size_t            format_len        = strlen(format);
-	size_t                  format_idx        = 0;
-	unsigned int            format_flags      = FORMATFLAG_NONE;
-	unsigned int            format_fieldwidth = FORMATFIELDWIDTH_UNSET;
-	unsigned int            format_precision  = FORMATPRECISION_UNSET;
-	enum FormatConvSpec_Int format_convspec   = FORMATCONVSPEC_INT_UNSET;
-
-	FORMATSCAN(format_scan_flags, format_flags);
-	FORMATSCAN(format_scan_fieldwidth, format_fieldwidth);
-	FORMATSCAN(format_scan_precision, format_precision);
-	FORMATSCAN(format_scan_convspec_int, format_convspec);
-
-	if UNLIKELY ( format_idx != format_len ){
+	struct ASSPF_Field *field;
+
+	const size_t key_size = strlen(key);
+
+	if UNLIKELY (
+		(rec->nfields == rec->nfields_max)
+	||
+		(
+			(rec->style == RECORD_STYLE_LOGFMT)
+		&&
+			(! record_logfmt_bare(key, key_size))
+		)
+	){
+		rec->error = TRUE;
 		return 1;
 	}
-	*itemfmt = itemformat_int_get(
-		format_flags, format_fieldwidth, format_precision,
-		format_convspec
-	);
+	field = &rec->fields[rec->nfields++];
+	field->key	= key;
+	field->str	= str;
+	field->value	= value;
+	field->key_size	= key_size;
+	field->type	= type;
 	return 0;
 }
 
-/* //////////////////////////////////////////////////////////////////////// */
+/* ======================================================================== */
 
-#undef writebuf
-static size_t printf_int_body(
-	struct ASSPF_WriteBuf *writebuf, const struct ItemFormat_Int *,
-	uintmax_t, size_t
+/* returns 0 on success */
+/* returns 1 if 'style' is not one of ASSPF_RECORD_* (the record then
+   prints nothing) */
+/* starts a record, whose fields go into 'fields' (until the end) */
+int
+asspf_record_begin(
+	/*@out@*/ struct ASSPF_Record *rec, struct ASSPF_Field fields[],
+	size_t nfields_max, int style
 )
-/*@globals	fileSystem@*/
-/*@modifies	fileSystem,
-		*writebuf
-@*/
-;
+/*@modifies	*rec@*/
+{
+	rec->fields	 = fields;
+	rec->nfields_max = nfields_max;
+	rec->nfields	 = 0;
+	rec->style	 = RECORD_STYLE_JSON;
+	rec->error	 = FALSE;
+
+	switch ( style ){
+	case (int) RECORD_STYLE_JSON:
+	case (int) RECORD_STYLE_LOGFMT:
+		rec->style = (enum Record_Style) style;
+		return 0;
+	default:
+		rec->error = TRUE;
+		return 1;
+	}
+}
 
-/* ------------------------------------------------------------------------ */
+/* returns 0 on success */
+/* returns 1 if the record is full or the key is bad (then prints nothing) */
+int
+asspf_record_int(struct ASSPF_Record *rec, const char *key, intmax_t value)
+/*@modifies	*rec@*/
+{
+	return record_add(rec, key, FIELD_TYPE_INT, NULL, (uintmax_t) value);
+}
+
+/* returns 0 on success */
+/* returns 1 if the record is full or the key is bad (then prints nothing) */
+int
+asspf_record_uint(struct ASSPF_Record *rec, const char *key, uintmax_t value)
+/*@modifies	*rec@*/
+{
+	return record_add(rec, key, FIELD_TYPE_UINT, NULL, value);
+}
+
+/* returns 0 on success */
+/* returns 1 if the record is full or the key is bad (then prints nothing) */
+int
+asspf_record_hex(struct ASSPF_Record *rec, const char *key, uintmax_t value)
+/*@modifies	*rec@*/
+{
+	return record_add(rec, key, FIELD_TYPE_HEX, NULL, value);
+}
+
+/* returns 0 on success */
+/* returns 1 if the record is full or the key is bad (then prints nothing) */
+/* 'str' is not copied, so it has to last until the end of the record */
+int
+asspf_record_str(struct ASSPF_Record *rec, const char *key, const char *str)
+/*@modifies	*rec@*/
+{
+	return record_add(
+		rec, key, FIELD_TYPE_STR, str, (uintmax_t) strlen(str)
+	);
+}
 
 /* returns the number of bytes written to the writebuf */
-static NOINLINE size_t
-printf_int(
-	struct ASSPF_WriteBuf *writebuf, const char *format, uintmax_t value,
-	size_t value_size
+/* returns 0 (and writes nothing) if the record had an error */
+/* writes out the record and its newline */
+size_t
+asspf_record_end(
+	const struct ASSPF_Record *rec, struct ASSPF_WriteBuf *writebuf
 )
 /*@globals	fileSystem@*/
 /*@modifies	fileSystem,
 		*writebuf
 @*/
 {
-	size_t retval = 0;
-	struct ItemFormat_Int itemfmt;
-	int err;
+	size_t size, retval;
+	char *dest;
 
-	/* scan the format string */
-	err = format_scan_int(&itemfmt, format);
-	if ( err != 0 ){
+	if UNLIKELY ( rec->error != 0 ){
+		STATS_ADD(writebuf, nformat_errors, 1u);
 		return 0;
 	}
 
-	/* format and print */
-	switch ( itemfmt.convspec ){
-	case FORMATCONVSPEC_INT_UNSET:
-		assert(FALSE);
-		break;
-	case FORMATCONVSPEC_INT_d:
-	case FORMATCONVSPEC_INT_u:
-	case FORMATCONVSPEC_INT_b:
-	case FORMATCONVSPEC_INT_o:
-	case FORMATCONVSPEC_INT_x:
-	case FORMATCONVSPEC_INT_X:
-		retval = printf_int_body(
-			writebuf, &itemfmt, value, value_size
-		);
-		break;
+	/* total up the record's size */
+	size = record_run(NULL, NULL, rec, PRINTR_MODE_MEASURE);
+
+	/* write it in one go if it can fit, otherwise a piece at a time */
+	dest = asspf_reserve(writebuf, size);
+	if LIKELY ( dest != NULL ){
+		retval = record_run(NULL, dest, rec, PRINTR_MODE_EMIT);
+		assert(retval == size);
+		retval = asspf_commit(writebuf, retval);
 	}
+	else {	retval = record_run(writebuf, NULL, rec, PRINTR_MODE_PUT); }
 
 	return retval;
 }
 
-/* ======================================================================== */
+#ifdef ASSPF_OPT_STATS
 
-/* returns value converted to a signed integer */
-/* only works with 2's-complement */
-static CONST intmax_t
-printf_read_raw_d(uintmax_t value, size_t value_size)
-/*@*/
+/* returns the number of bytes written to the writebuf */
+/* writes 'stats' out as a record ('style' is one of ASSPF_RECORD_*) */
+size_t
+asspf_stats_dump(
+	struct ASSPF_WriteBuf *writebuf, const struct ASSPF_Stats *stats,
+	int style
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
 {
-	const uint_fast8_t shift_cnt = (uint_fast8_t) (
-		((sizeof value) - value_size) * CHAR_BIT
+	struct ASSPF_Field fields[8u];
+	struct ASSPF_Record rec;
+
+	(void) asspf_record_begin(
+		&rec, fields, (sizeof fields) / (sizeof *fields), style
+	);
+	(void) asspf_record_uint(
+		&rec, "bytes_buffered", (uintmax_t) stats->bytes_buffered
+	);
+	(void) asspf_record_uint(
+		&rec, "bytes_written", (uintmax_t) stats->bytes_written
+	);
+	(void) asspf_record_uint(
+		&rec, "bytes_dropped", (uintmax_t) stats->bytes_dropped
+	);
+	(void) asspf_record_uint(
+		&rec, "syscalls", (uintmax_t) stats->syscalls
+	);
+	(void) asspf_record_uint(
+		&rec, "partial_writes", (uintmax_t) stats->partial_writes
 	);
+	(void) asspf_record_uint(
+		&rec, "retries", (uintmax_t) stats->retries
+	);
+	(void) asspf_record_uint(
+		&rec, "bypass_writes", (uintmax_t) stats->bypass_writes
+	);
+	(void) asspf_record_uint(
+		&rec, "format_errors", (uintmax_t) stats->format_errors
+	);
+	return asspf_record_end(&rec, writebuf);
+}
 
-	assert((value_size != 0) && (value_size <= sizeof value));
+#endif	/* ASSPF_OPT_STATS */
 
-	return asr_imax(asl_imax((intmax_t) value, shift_cnt), shift_cnt);
-}
+/* //////////////////////////////////////////////////////////////////////// */
 
-/* returns the number of characters written to 'dest' */
-static size_t
-printf_w2b_u(/*@out@*/ char dest[], size_t dest_size, uintmax_t value)
-/*@modifies	*dest@*/
-{
-	size_t retval = 0;
-	unsigned char digit;
-	size_t i;
+#define HEXDUMP_FLAG_UPPER		0x01u
+#define HEXDUMP_FLAG_NO_ASCII		0x02u
+#define HEXDUMP_FLAG_ADDR		0x04u
 
-	for ( i = (size_t) 1u; i <= dest_size; ++i ){
-		digit   = (unsigned char) (value % 10u);
-		value  /= 10u;
-		dest[dest_size - i] = (char) ('0' + (char) digit);
-		retval += 1u;
-	}
-	return retval;
-}
+#define HEXDUMP_GROUP_SHIFT		8u
+#define HEXDUMP_GROUP_MASK		0x1Fu
+#define HEXDUMP_GROUP_DEFAULT		2u
 
-/* returns the number of bytes written to 'dest' */
-ALWAYS_INLINE size_t
-printf_w2b_b_nibble(/*@out@*/ char dest[STATIC(4u)], uint_fast8_t value)
+#define HEXDUMP_LINE_NBYTES		16u
+
+/* offset + ": " + hex digits and spaces + "  " + ascii + '\n' */
+#define HEXDUMP_LINE_SIZE_MAX		( \
+	(2u * (sizeof(uintmax_t))) + 2u \
+	+ (3u * HEXDUMP_LINE_NBYTES) - 1u \
+	+ 2u + HEXDUMP_LINE_NBYTES + 1u \
+)
+
+/* ------------------------------------------------------------------------ */
+
+/* writes 2 * 'src_size' hex digits to 'dest' */
+static void
+hexdump_w2b_bytes(
+	/*@out@*/ char dest[], const unsigned char src[], size_t src_size,
+	int upper
+)
 /*@modifies	dest[]@*/
 {
-	const char str[16u][4u] = {
-		{'0','0','0','0'}, {'0','0','0','1'},
-		{'0','0','1','0'}, {'0','0','1','1'},
-		{'0','1','0','0'}, {'0','1','0','1'},
-		{'0','1','1','0'}, {'0','1','1','1'},
-		{'1','0','0','0'}, {'1','0','0','1'},
-		{'1','0','1','0'}, {'1','0','1','1'},
-		{'1','1','0','0'}, {'1','1','0','1'},
-		{'1','1','1','0'}, {'1','1','1','1'}
-	};
-
-	(void) memcpy(dest, str[value & 0xFu], sizeof str[0]);
-	return sizeof str[0];
+#ifdef HAVE_SIMD_SSE2
+	simd_w2b_hex(
+		dest, src, src_size,
+		(upper == 0 ? 'a' - '0' - 10 : 'A' - '0' - 10)
+	);
+#else
+	const char *const c = (upper == 0
+		? "0123456789abcdef" : "0123456789ABCDEF"
+	);
+	size_t i;
+
+	for ( i = 0; i < src_size; ++i ){
+		dest[(2u * i)     ] = c[src[i] >> 4u];
+		dest[(2u * i) + 1u] = c[src[i] & 0xFu];
+	}
+#endif
+	return;
 }
 
 /* returns the number of bytes written to 'dest' */
 static size_t
-printf_w2b_b(/*@out@*/ char dest[], size_t dest_size, uintmax_t value)
+hexdump_line(
+	/*@out@*/ char dest[], uintmax_t offset, size_t offset_width,
+	const unsigned char src[], size_t src_size, size_t group,
+	unsigned int flags
+)
 /*@modifies	dest[]@*/
 {
+	const int upper = (int) ((flags & HEXDUMP_FLAG_UPPER) != 0);
+	const char *const c = (upper == 0
+		? "0123456789abcdef" : "0123456789ABCDEF"
+	);
+	char   hex[2u * HEXDUMP_LINE_NBYTES];
 	size_t retval = 0;
+	size_t hex_size, col_size;
 	size_t i;
 
-	for ( i = (size_t) 4u; i <= dest_size; i += 4u ){
-		retval += printf_w2b_b_nibble(
-			&dest[dest_size - i], (uint_fast8_t) value
+	/* offset */
+	for ( i = offset_width; i-- != 0; offset >>= 4u ){
+		dest[i] = c[offset & 0xFu];
+	}
+	retval += offset_width;
+	dest[retval++] = ':';
+	dest[retval++] = ' ';
+
+	/* hex bytes, in groups */
+	hexdump_w2b_bytes(hex, src, src_size, upper);
+	for ( i = 0; i < src_size; i += group ){
+		hex_size = 2u * (src_size - i < group ? src_size - i : group);
+		(void) memcpy(&dest[retval], &hex[2u * i], hex_size);
+		retval += hex_size;
+		if ( i + group < src_size ){
+			dest[retval++] = ' ';
+		}
+	}
+
+	/* ascii column, lined up with the full lines above it */
+	if ( (flags & HEXDUMP_FLAG_NO_ASCII) == 0 ){
+		col_size = (
+			(2u * HEXDUMP_LINE_NBYTES)
+			+ (((HEXDUMP_LINE_NBYTES + group - 1u) / group) - 1u)
 		);
-		value >>= 4u;
+		hex_size = (
+			(2u * src_size)
+			+ (((src_size + group - 1u) / group) - 1u)
+		);
+		(void) memset(&dest[retval], (int) ' ', col_size - hex_size + 2u);
+		retval += col_size - hex_size + 2u;
+		for ( i = 0; i < src_size; ++i ){
+			dest[retval++] = (((src[i] >= 0x20u) && (src[i] < 0x7Fu))
+				? (char) src[i] : '.'
+			);
+		}
 	}
+
+	dest[retval++] = '\n';
 	return retval;
 }
 
-/* returns the number of bytes written to 'dest' */
-static size_t
-printf_w2b_o(/*@out@*/ char dest[], size_t dest_size, uintmax_t value)
-/*@modifies	dest[]@*/
+/* ======================================================================== */
+
+/* returns the number of bytes written to the writebuf */
+size_t
+asspf_hexdump(
+	struct ASSPF_WriteBuf *writebuf, const void *ptr, size_t size,
+	unsigned int flags
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
 {
+	const unsigned char *const src = ptr;
+	char   line_buf[HEXDUMP_LINE_SIZE_MAX];
 	size_t retval = 0;
-	unsigned char digit;
+	size_t group, offset_width, line_size, nbytes;
+	uintmax_t offset_base;
+	char   *dest;
 	size_t i;
 
-	for ( i = (size_t) 1u; i <= dest_size; ++i ){
-		digit   = (unsigned char) (value & 0x7u);
-		value >>= 3u;
-		dest[dest_size - i] = (char) ('0' + (char) digit);
-		retval += 1u;
+	group = (size_t) ((flags >> HEXDUMP_GROUP_SHIFT) & HEXDUMP_GROUP_MASK);
+	if ( (group == 0) || (group > HEXDUMP_LINE_NBYTES) ){
+		group = (size_t) HEXDUMP_GROUP_DEFAULT;
+	}
+
+	if ( (flags & HEXDUMP_FLAG_ADDR) != 0 ){
+		offset_base  = (uintmax_t) (uintptr_t) ptr;
+		offset_width = 2u * (sizeof(uintptr_t));
+	}
+	else {	offset_base  = 0;
+		offset_width = (size_t) (((uintmax_t) size > 0xFFFFFFFFu)
+			? 2u * (sizeof(uintmax_t)) : 8u
+		);
+	}
+
+	for ( i = 0; i < size; i += nbytes ){
+		nbytes = (size - i < (size_t) HEXDUMP_LINE_NBYTES
+			? size - i : (size_t) HEXDUMP_LINE_NBYTES
+		);
+
+		/* a whole line at a time, in place if it fits */
+		dest = asspf_reserve(writebuf, sizeof line_buf);
+		if UNLIKELY ( dest == NULL ){
+			dest = line_buf;
+		}
+		line_size = hexdump_line(
+			dest, offset_base + (uintmax_t) i, offset_width,
+			&src[i], nbytes, group, flags
+		);
+		assert(line_size <= sizeof line_buf);
+		if LIKELY ( dest != line_buf ){
+			retval += asspf_commit(writebuf, line_size);
+		}
+		else {	retval += asspf_write(writebuf, line_buf, line_size); }
 	}
+
 	return retval;
 }
 
-/* returns the number of characters written to 'dest' */
-ALWAYS_INLINE size_t
-printf_w2b_x_nibble(/*@out@*/ char dest[STATIC(1u)], uint_fast8_t value)
-/*@modifies	dest[]@*/
+/* //////////////////////////////////////////////////////////////////////// */
+
+#ifdef HAVE_PRINTF_INT128
+
+/* 128-bit integers, as two uintmax_t halves where the radix allows it */
+
+#define INT128_CHUNK_POW10	UINTMAX_C(10000000000000000000)	/* 10^19 */
+#define INT128_CHUNK_NDIGITS	((size_t) 19u)
+/* floor((2^128 - 1) / 10^19) - 2^64 */
+#define INT128_CHUNK_RECIP	UINTMAX_C(0xD83C94FB6D2AC34A)
+
+/* returns the number of bytes written to 'dest' */
+static size_t
+binrec_le128(/*@out@*/ char *dest, UInt128 value)
+/*@modifies	*dest@*/
 {
-	const char c[16u] = {
-		'0','1','2','3','4','5','6','7',
-		'8','9','a','b','c','d','e','f'
-	};
+	(void) binrec_le(dest, (uintmax_t) value, (size_t) 8u);
+	(void) binrec_le(&dest[8u], (uintmax_t) (value >> 64u), (size_t) 8u);
+	return sizeof value;
+}
 
-	dest[0] = c[value & 0xFu];
-	return sizeof c[0];
+/* ------------------------------------------------------------------------ */
+
+/* returns '*value % 10^19', and sets '*value' to '*value / 10^19' */
+/* 10^19 has its top bit set, so this is a 2-by-1 division with a
+   precomputed reciprocal (N. Moller, T. Granlund, "Improved division by
+   invariant integers", 2011), not a __udivti3() call */
+static uintmax_t
+int128_divmod_chunk(UInt128 *value)
+/*@modifies	*value@*/
+{
+	const uintmax_t divisor = INT128_CHUNK_POW10;
+	const uintmax_t lo = (uintmax_t) *value;
+	uintmax_t hi       = (uintmax_t) (*value >> 64u);
+	uintmax_t q_hi     = 0;
+	uintmax_t q_lo, rem;
+	UInt128 q;
+
+	/* the high half's quotient is 0 or 1 */
+	if ( hi >= divisor ){
+		q_hi = 1u;
+		hi  -= divisor;
+	}
+
+	q    = ((UInt128) INT128_CHUNK_RECIP) * hi;
+	q   += (((UInt128) hi) << 64u) | lo;
+	q_lo = ((uintmax_t) (q >> 64u)) + 1u;
+	rem  = lo - (q_lo * divisor);
+	if ( rem > (uintmax_t) q ){
+		q_lo -= 1u;
+		rem  += divisor;
+	}
+	if UNLIKELY ( rem >= divisor ){
+		q_lo += 1u;
+		rem  -= divisor;
+	}
+
+	*value = (((UInt128) q_hi) << 64u) | q_lo;
+	return rem;
 }
 
-/* returns the number of characters written to 'dest' */
+/* returns the number of characters written to the end of 'dest' */
+/* only writes the significant digits */
 static size_t
-printf_w2b_x(/*@out@*/ char dest[], size_t dest_size, uintmax_t value)
+printf_w2b_u128(/*@out@*/ char dest[], size_t dest_size, UInt128 value)
 /*@modifies	dest[]@*/
 {
-	size_t retval = 0;
-	size_t i;
-
-	for ( i = (size_t) 1u; i <= dest_size; ++i ){
-		retval += printf_w2b_x_nibble(
-			&dest[dest_size - i], (uint_fast8_t) value
-		);
-		value >>= 4u;
+	size_t i = dest_size;
+	uintmax_t chunk;
+
+	/* 19 digits per chunk, until the rest fits a uintmax_t */
+	while ( (value >> 64u) != 0 ){
+		chunk = int128_divmod_chunk(&value);
+		i    -= INT128_CHUNK_NDIGITS;
+		(void) memset(&dest[i], (int) '0', INT128_CHUNK_NDIGITS);
+		(void) printf_w2b_u(&dest[i], INT128_CHUNK_NDIGITS, chunk);
 	}
-	return retval;
+	i -= printf_w2b_u(dest, i, (uintmax_t) value);
+
+	return dest_size - i;
 }
 
-/* returns the number of characters written to 'dest' */
-ALWAYS_INLINE size_t
-printf_w2b_X_nibble(/*@out@*/ char dest[STATIC(1u)], uint_fast8_t value)
+/* returns the number of characters written to the end of 'dest' */
+/* only writes the significant digits */
+static size_t
+printf_w2b_o128(/*@out@*/ char dest[], size_t dest_size, UInt128 value)
 /*@modifies	dest[]@*/
 {
-	const char c[16u] = {
-		'0','1','2','3','4','5','6','7',
-		'8','9','A','B','C','D','E','F'
-	};
+	const uintmax_t hi = (uintmax_t) (value >> 64u);
+	size_t          ndigits = (
+		(hi != 0 ? 64u + nbits_umax(hi) : nbits_umax((uintmax_t) value))
+		+ 2u
+	) / 3u;
+	size_t i;
 
-	dest[0] = c[value & 0xFu];
-	return sizeof c[0];
+	assert(ndigits <= dest_size);
+	ndigits = (ndigits > dest_size ? dest_size : ndigits);
+
+	/* 3 does not divide 64, so no halves here */
+	for ( i = (size_t) 1u; i <= ndigits; ++i ){
+		dest[dest_size - i] = (char) ('0' + (char) (value & 0x7u));
+		value >>= 3u;
+	}
+	return ndigits;
 }
 
-/* returns the number of characters written to 'dest' */
+/* returns the number of characters written to the end of 'dest' */
+/* only writes the significant digits */
+/* for %b, %x, and %X: the low half gets all its digits, zeros included */
 static size_t
-printf_w2b_X(/*@out@*/ char dest[], size_t dest_size, uintmax_t value)
+printf_w2b_pow2_128(
+	/*@out@*/ char dest[], size_t dest_size, UInt128 value,
+	enum FormatConvSpec_Int convspec
+)
 /*@modifies	dest[]@*/
 {
-	size_t retval = 0;
-	size_t i;
+	const uintmax_t hi = (uintmax_t) (value >> 64u);
+	const uintmax_t lo = (uintmax_t) value;
+	size_t (*w2b)(/*@out@*/ char [], size_t, uintmax_t);
+	size_t ndigits_lo;
 
-	for ( i = (size_t) 1u; i <= dest_size; ++i ){
-		retval += printf_w2b_X_nibble(
-			&dest[dest_size - i], (uint_fast8_t) value
-		);
-		value >>= 4u;
+	switch ( convspec ){
+	default:
+		assert(FALSE);
+		/*@fallthrough@*/
+	case FORMATCONVSPEC_INT_b:
+		w2b        = printf_w2b_b;
+		ndigits_lo = (size_t) 64u;
+		break;
+	case FORMATCONVSPEC_INT_x:
+		w2b        = printf_w2b_x;
+		ndigits_lo = (size_t) 16u;
+		break;
+	case FORMATCONVSPEC_INT_X:
+		w2b        = printf_w2b_X;
+		ndigits_lo = (size_t) 16u;
+		break;
 	}
-	return retval;
+
+	if ( hi == 0 ){
+		return w2b(dest, dest_size, lo);
+	}
+
+	(void) memset(&dest[dest_size - ndigits_lo], (int) '0', ndigits_lo);
+	(void) w2b(dest, dest_size, lo);
+	return ndigits_lo + w2b(dest, dest_size - ndigits_lo, hi);
 }
 
 /* ------------------------------------------------------------------------ */
 
-/* returns the maximum number of printable digits a value could need */
-static CONST size_t
-printf_ndigits_max(size_t value_size, enum FormatConvSpec_Int convspec)
-/*@*/
+/* returns the number of bytes the printf-integer will take up */
+/* like printf_int_layout(), for a 128-bit value */
+static size_t
+printf_int128_layout(
+	/*@out@*/ struct PrintfInt_Layout *layout,
+	const struct ItemFormat_Int *itemfmt, UInt128 value
+)
+/*@modifies	*layout@*/
 {
-	size_t retval = 0;
+	char   *const digit_buf = layout->digit_buf;
+	size_t ndigits_max;
+	size_t ndigits_base = 0;
+	char   sign_c = '+';
+	size_t fraction_size = 0;
+	uintmax_t fraction = 0;
+	uintmax_t power = 1u;
+	UInt128 quotient;
+	unsigned int i;
+
+	ndigits_max = printf_ndigits_max(sizeof value, itemfmt->convspec);
+	assert(ndigits_max != 0);
 
-	switch ( convspec ){
+	switch ( itemfmt->convspec ){
 	case FORMATCONVSPEC_INT_UNSET:
 		assert(FALSE);
 		break;
 	case FORMATCONVSPEC_INT_d:
-		if ( value_size <= sizeof(int_least8_t) ){
-			retval = ilog10p1((uintmax_t) INT_LEAST8_MAX);
-		}
-		else if ( value_size <= sizeof(int_least16_t) ){
-			retval = ilog10p1((uintmax_t) INT_LEAST16_MAX);
+		if ( (value >> 127u) != 0 ){
+			sign_c = '-';
+			value  = 0u - value;
 		}
-		else if ( value_size <= sizeof(int_least32_t) ){
-			retval = ilog10p1((uintmax_t) INT_LEAST32_MAX);
-		}
-		else if ( value_size <= sizeof(int_least64_t) ){
-			retval = ilog10p1((uintmax_t) INT_LEAST64_MAX);
-		}
-		else {	retval = ilog10p1((uintmax_t) INTMAX_MAX); }
-		break;
+		/*@fallthrough@*/
 	case FORMATCONVSPEC_INT_u:
-		if ( value_size <= sizeof(uint_least8_t) ){
-			retval = ilog10p1((uintmax_t) UINT_LEAST8_MAX);
-		}
-		else if ( value_size <= sizeof(uint_least16_t) ){
-			retval = ilog10p1((uintmax_t) UINT_LEAST16_MAX);
-		}
-		else if ( value_size <= sizeof(uint_least32_t) ){
-			retval = ilog10p1((uintmax_t) UINT_LEAST32_MAX);
-		}
-		else if ( value_size <= sizeof(uint_least64_t) ){
-			retval = ilog10p1((uintmax_t) UINT_LEAST64_MAX);
+		if ( itemfmt->scale != FORMATSCALE_UNSET ){
+			for ( i = 0; i < itemfmt->scale; ++i ){
+				power *= 10u;
+			}
+			quotient      = value / power;
+			fraction      = (uintmax_t) (value - quotient * power);
+			value         = quotient;
+			fraction_size = (size_t) itemfmt->scale;
 		}
-		else {	retval = ilog10p1(UINTMAX_MAX); }
-		break;
-	case FORMATCONVSPEC_INT_b:
-		retval = 8u * value_size;
+		ndigits_base = printf_w2b_u128(digit_buf, ndigits_max, value);
 		break;
 	case FORMATCONVSPEC_INT_o:
-		retval = 3u * value_size;
+		ndigits_base = printf_w2b_o128(digit_buf, ndigits_max, value);
 		break;
+	case FORMATCONVSPEC_INT_b:
 	case FORMATCONVSPEC_INT_x:
 	case FORMATCONVSPEC_INT_X:
-		retval = 2u * value_size;
+		ndigits_base = printf_w2b_pow2_128(
+			digit_buf, ndigits_max, value, itemfmt->convspec
+		);
 		break;
 	}
 
-	return retval;
+	return printf_int_layout_finish(
+		layout, itemfmt, ndigits_max, ndigits_base, sign_c,
+		fraction, fraction_size
+	);
 }
 
-/* returns the base number of digits for a printf-integer */
-static PURE size_t
-printf_ndigits_base(const char buf[], size_t buf_size)
-/*@*/
+/* returns the number of bytes written to the writebuf */
+static size_t
+printf_int128_item(
+	struct ASSPF_WriteBuf *writebuf, const struct ItemFormat_Int *itemfmt,
+	UInt128 value
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
 {
-	size_t i;
+	struct PrintfInt_Layout layout;
+	size_t size;
 
-	for ( i = 0; i < buf_size; ++i ){
-		if ( buf[i] != '0' ){
-			break;
-		}
+	/* a compiled format that failed to compile */
+	if UNLIKELY ( itemfmt->convspec == FORMATCONVSPEC_INT_UNSET ){
+		STATS_ADD(writebuf, nformat_errors, 1u);
+		return 0;
 	}
-	return (i != buf_size ? buf_size - i : (size_t) 1u);
+
+	size = printf_int128_layout(&layout, itemfmt, value);
+	return printf_int_write(writebuf, &layout, size);
 }
 
-/* ------------------------------------------------------------------------ */
+/* ======================================================================== */
 
-/* returns the number of bytes written to dest */
-static size_t
-printf_flag_sigil_int_c(
-	/*@out@*/ char dest[STATIC(2u)], enum FormatConvSpec_Int convspec
+/* returns the number of bytes written to the writebuf */
+size_t
+asspf_printf_int128(
+	struct ASSPF_WriteBuf *writebuf, const char *format, UInt128 value
 )
-/*@modifies	dest[]@*/
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
 {
-	/* const char sigil_d[0u] = {}; */
-	const char sigil_b[2u] = {'0','b'};
-	const char sigil_o[1u] = {'0'};
-	const char sigil_x[2u] = {'0','x'};
+	const size_t format_len = strlen(format);
+	struct ItemFormat_Int itemfmt;
+	char *dest;
+	size_t size;
 
-	size_t retval = 0;
+	/* an 'F' record, as in printf_int_binrec() */
+	if UNLIKELY ( (writebuf->flags & WRITEBUF_FLAG_BINARY) != 0 ){
+		if UNLIKELY ( format_len > (size_t) UCHAR_MAX ){
+			STATS_ADD(writebuf, nformat_errors, 1u);
+			return 0;
+		}
+		dest = writebuf_reserve(
+			writebuf, 3u + format_len + sizeof value
+		);
+		if UNLIKELY ( dest == NULL ){
+			return 0;
+		}
+		dest[0] = BINREC_INT_FORMAT;
+		dest[1] = (char) format_len;
+		size    = 2u;
+		(void) memcpy(&dest[size], format, format_len);
+		size   += format_len;
+		dest[size++] = (char) sizeof value;
+		size   += binrec_le128(&dest[size], value);
+		writebuf->nmemb += size;
+		return size;
+	}
 
-	switch ( convspec ){
-	case FORMATCONVSPEC_INT_UNSET:
-		assert(FALSE);
-		break;
-	case FORMATCONVSPEC_INT_d:
-	case FORMATCONVSPEC_INT_u:
-		break;
-	case FORMATCONVSPEC_INT_b:
-		(void) memcpy(dest, sigil_b, sizeof sigil_b);
-		retval = sizeof sigil_b;
-		break;
-	case FORMATCONVSPEC_INT_o:
-		(void) memcpy(dest, sigil_o, sizeof sigil_o);
-		retval = sizeof sigil_o;
-		break;
-	case FORMATCONVSPEC_INT_x:
-	case FORMATCONVSPEC_INT_X:
-		(void) memcpy(dest, sigil_x, sizeof sigil_x);
-		retval = sizeof sigil_x;
-		break;
+	if ( format_scan_int(&itemfmt, format) != 0 ){
+		STATS_ADD(writebuf, nformat_errors, 1u);
+		return 0;
+	}
+	return printf_int128_item(writebuf, &itemfmt, value);
+}
+
+/* returns the number of bytes written to the writebuf */
+size_t
+asspf_printfc_int128(
+	struct ASSPF_WriteBuf *writebuf, const struct ASSPF_Format *fmt,
+	UInt128 value
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+{
+	char *dest;
+	size_t size;
+
+	/* an 'I' record, as in printfc_int() */
+	if UNLIKELY (
+		((writebuf->flags & WRITEBUF_FLAG_BINARY) != 0)
+	&&
+		(fmt->id != FORMAT_ID_NONE)
+	){
+		dest = writebuf_reserve(writebuf, 4u + sizeof value);
+		if UNLIKELY ( dest == NULL ){
+			return 0;
+		}
+		dest[0] = BINREC_INT_ID;
+		size    = 1u;
+		size   += binrec_le(
+			&dest[size], (uintmax_t) fmt->id, (size_t) 2u
+		);
+		dest[size++] = (char) sizeof value;
+		size   += binrec_le128(&dest[size], value);
+		writebuf->nmemb += size;
+		return size;
 	}
 
-	/*@-mustdefine@*/
-	return retval;
-	/*@-mustdefine@*/
+	return printf_int128_item(writebuf, &fmt->itemfmt, value);
+}
+
+#endif	/* HAVE_PRINTF_INT128 */
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+#ifndef ASSPF_OPT_NO_FLOAT
+
+#if FLT_RADIX != 2 || DBL_MANT_DIG != 53 || DBL_MAX_EXP != 1024
+#error "double is not IEEE-754 binary64 (define ASSPF_OPT_NO_FLOAT)"
+#endif
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/* shortest round-trip doubles, after Ryu
+   (U. Adams, "Ryu: Fast Float-to-String Conversion", PLDI 2018) */
+/* @note snprintf() is not on the whitelist */
+
+#define D2S_MANTISSA_BITS	52u
+#define D2S_EXPONENT_MASK	0x7FFu
+#define D2S_BIAS		1023
+#define D2S_POW5_INV_BITCOUNT	125
+#define D2S_POW5_BITCOUNT	125
+
+/* ------------------------------------------------------------------------ */
+
+/* floor(2^(pow5bits(q) - 1 + 125) / 5^q) + 1, as {low, high} */
+static const uint64_t d2s_pow5_inv_split[291u][2u] = {
+	{UINT64_C(0x0000000000000001), UINT64_C(0x2000000000000000)},
+	{UINT64_C(0x999999999999999a), UINT64_C(0x1999999999999999)},
+	{UINT64_C(0x47ae147ae147ae15), UINT64_C(0x147ae147ae147ae1)},
+	{UINT64_C(0x6c8b4395810624de), UINT64_C(0x10624dd2f1a9fbe7)},
+	{UINT64_C(0x7a786c226809d496), UINT64_C(0x1a36e2eb1c432ca5)},
+	{UINT64_C(0x61f9f01b866e43ab), UINT64_C(0x14f8b588e368f084)},
+	{UINT64_C(0xb4c7f34938583622), UINT64_C(0x10c6f7a0b5ed8d36)},
+	{UINT64_C(0x87a6520ec08d236a), UINT64_C(0x1ad7f29abcaf4857)},
+	{UINT64_C(0x9fb841a566d74f88), UINT64_C(0x15798ee2308c39df)},
+	{UINT64_C(0xe62d01511f12a607), UINT64_C(0x112e0be826d694b2)},
+	{UINT64_C(0xd6ae6881cb5109a4), UINT64_C(0x1b7cdfd9d7bdbab7)},
+	{UINT64_C(0xdef1ed34a2a73aea), UINT64_C(0x15fd7fe17964955f)},
+	{UINT64_C(0x7f27f0f6e885c8bb), UINT64_C(0x119799812dea1119)},
+	{UINT64_C(0x650cb4be40d60df8), UINT64_C(0x1c25c268497681c2)},
+	{UINT64_C(0xea70909833de7193), UINT64_C(0x16849b86a12b9b01)},
+	{UINT64_C(0x21f3a6e0297ec143), UINT64_C(0x1203af9ee756159b)},
+	{UINT64_C(0x6985d7cd0f313537), UINT64_C(0x1cd2b297d889bc2b)},
+	{UINT64_C(0x2137dfd73f5a90f9), UINT64_C(0x170ef54646d49689)},
+	{UINT64_C(0xe75fe645cc4873fa), UINT64_C(0x12725dd1d243aba0)},
+	{UINT64_C(0xa5663d3c7a0d865d), UINT64_C(0x1d83c94fb6d2ac34)},
+	{UINT64_C(0x511e976394d79eb1), UINT64_C(0x179ca10c9242235d)},
+	{UINT64_C(0xda7edf82dd794bc1), UINT64_C(0x12e3b40a0e9b4f7d)},
+	{UINT64_C(0x2a6498d1625bac68), UINT64_C(0x1e392010175ee596)},
+	{UINT64_C(0xeeb6e0a781e2f053), UINT64_C(0x182db34012b25144)},
+	{UINT64_C(0x58924d52ce4f26a9), UINT64_C(0x1357c299a88ea76a)},
+	{UINT64_C(0x27507bb7b07ea441), UINT64_C(0x1ef2d0f5da7dd8aa)},
+	{UINT64_C(0x52a6c95fc0655034), UINT64_C(0x18c240c4aecb13bb)},
+	{UINT64_C(0x0eebd44c99eaa690), UINT64_C(0x13ce9a36f23c0fc9)},
+	{UINT64_C(0xb17953adc3110a80), UINT64_C(0x1fb0f6be50601941)},
+	{UINT64_C(0xc12ddc8b02740867), UINT64_C(0x195a5efea6b34767)},
+	{UINT64_C(0x3424b06f3529a052), UINT64_C(0x14484bfeebc29f86)},
+	{UINT64_C(0x901d59f290ee19db), UINT64_C(0x1039d66589687f9e)},
+	{UINT64_C(0x4cfbc31db4b0295f), UINT64_C(0x19f623d5a8a73297)},
+	{UINT64_C(0x3d9635b15d59bab2), UINT64_C(0x14c4e977ba1f5bac)},
+	{UINT64_C(0x97ab5e277de16228), UINT64_C(0x109d8792fb4c4956)},
+	{UINT64_C(0xf2abc9d8c9689d0d), UINT64_C(0x1a95a5b7f87a0ef0)},
+	{UINT64_C(0x5bbca17a3aba173e), UINT64_C(0x154484932d2e725a)},
+	{UINT64_C(0xafca1ac82efb45cb), UINT64_C(0x11039d428a8b8eae)},
+	{UINT64_C(0xb2dcf7a6b1920945), UINT64_C(0x1b38fb9daa78e44a)},
+	{UINT64_C(0xf57d92ebc141a104), UINT64_C(0x15c72fb1552d836e)},
+	{UINT64_C(0xc46475896767b403), UINT64_C(0x116c262777579c58)},
+	{UINT64_C(0x6d6d88dbd8a5ecd2), UINT64_C(0x1be03d0bf225c6f4)},
+	{UINT64_C(0x8abe071646eb23db), UINT64_C(0x164cfda3281e38c3)},
+	{UINT64_C(0x6efe6c11d255b649), UINT64_C(0x11d7314f534b609c)},
+	{UINT64_C(0xb197134fb6ef8a0e), UINT64_C(0x1c8b821885456760)},
+	{UINT64_C(0x27ac0f72f8bfa1a5), UINT64_C(0x16d601ad376ab91a)},
+	{UINT64_C(0xb95672c260994e1e), UINT64_C(0x1244ce242c5560e1)},
+	{UINT64_C(0xf5571e03cdc21695), UINT64_C(0x1d3ae36d13bbce35)},
+	{UINT64_C(0x2aac18030b01abab), UINT64_C(0x17624f8a762fd82b)},
+	{UINT64_C(0xbbbce0026f348956), UINT64_C(0x12b50c6ec4f31355)},
+	{UINT64_C(0x92c7ccd0b1eda889), UINT64_C(0x1dee7a4ad4b81eef)},
+	{UINT64_C(0xdbd30a408e57ba07), UINT64_C(0x17f1fb6f10934bf2)},
+	{UINT64_C(0x7ca8d50071dfc806), UINT64_C(0x1327fc58da0f6ff5)},
+	{UINT64_C(0xfaa7bb33e9660cd6), UINT64_C(0x1ea6608e29b24cbb)},
+	{UINT64_C(0x9552fc298784d711), UINT64_C(0x18851a0b548ea3c9)},
+	{UINT64_C(0xaaa8c9bad2d0ac0e), UINT64_C(0x139dae6f76d88307)},
+	{UINT64_C(0xdddadc5e1e1aace3), UINT64_C(0x1f62b0b257c0d1a5)},
+	{UINT64_C(0x7e48b04b4b488a4f), UINT64_C(0x191bc08eac9a4151)},
+	{UINT64_C(0xcb6d59d5d5d3a1d9), UINT64_C(0x141633a556e1cdda)},
+	{UINT64_C(0x3c577b1177dc817b), UINT64_C(0x1011c2eaabe7d7e2)},
+	{UINT64_C(0xc6f25e825960cf2a), UINT64_C(0x19b604aaaca62636)},
+	{UINT64_C(0x6bf518684780a5bb), UINT64_C(0x14919d5556eb51c5)},
+	{UINT64_C(0x232a79ed06008496), UINT64_C(0x10747ddddf22a7d1)},
+	{UINT64_C(0xd1dd8fe1a3340756), UINT64_C(0x1a53fc9631d10c81)},
+	{UINT64_C(0xa7e4731ae8f66c45), UINT64_C(0x150ffd44f4a73d34)},
+	{UINT64_C(0x531d28e253f8569e), UINT64_C(0x10d9976a5d52975d)},
+	{UINT64_C(0xeb61db03b98d5762), UINT64_C(0x1af5bf109550f22e)},
+	{UINT64_C(0xbc4e48cfc7a445e8), UINT64_C(0x159165a6ddda5b58)},
+	{UINT64_C(0x6371d3d96c836b20), UINT64_C(0x11411e1f17e1e2ad)},
+	{UINT64_C(0x9f1c8628ad9f11cd), UINT64_C(0x1b9b6364f3030448)},
+	{UINT64_C(0xe5b06b53be18db0b), UINT64_C(0x1615e91d8f359d06)},
+	{UINT64_C(0xeaf3890fcb4715a2), UINT64_C(0x11ab20e472914a6b)},
+	{UINT64_C(0x44b8db4c7871bc37), UINT64_C(0x1c45016d841baa46)},
+	{UINT64_C(0x03c715d6c6c1635f), UINT64_C(0x169d9abe03495505)},
+	{UINT64_C(0x3638de456bcde919), UINT64_C(0x1217aefe69077737)},
+	{UINT64_C(0x56c163a2461641c1), UINT64_C(0x1cf2b1970e725858)},
+	{UINT64_C(0xdf011c81d1ab67ce), UINT64_C(0x17288e1271f51379)},
+	{UINT64_C(0x7f3416ce4155eca5), UINT64_C(0x1286d80ec190dc61)},
+	{UINT64_C(0x6520247d3556476e), UINT64_C(0x1da48ce468e7c702)},
+	{UINT64_C(0xea801d30f7783925), UINT64_C(0x17b6d71d20b96c01)},
+	{UINT64_C(0xbb99b0f3f92cfa84), UINT64_C(0x12f8ac174d612334)},
+	{UINT64_C(0x5f5c4e532847f739), UINT64_C(0x1e5aacf215683854)},
+	{UINT64_C(0x7f7d0b75b9d32c2e), UINT64_C(0x18488a5b44536043)},
+	{UINT64_C(0x9930d5f7c7dc2358), UINT64_C(0x136d3b7c36a919cf)},
+	{UINT64_C(0x8eb4898c72f9d226), UINT64_C(0x1f152bf9f10e8fb2)},
+	{UINT64_C(0x722a07a38f2e41b8), UINT64_C(0x18ddbcc7f40ba628)},
+	{UINT64_C(0xc1bb394fa5be9afa), UINT64_C(0x13e497065cd61e86)},
+	{UINT64_C(0x9c5ec2190930f7f6), UINT64_C(0x1fd424d6faf030d7)},
+	{UINT64_C(0x49e56814075a5ff8), UINT64_C(0x197683df2f268d79)},
+	{UINT64_C(0x6e51201005e1e660), UINT64_C(0x145ecfe5bf520ac7)},
+	{UINT64_C(0xf1da800cd181851a), UINT64_C(0x104bd984990e6f05)},
+	{UINT64_C(0x4fc400148268d4f5), UINT64_C(0x1a12f5a0f4e3e4d6)},
+	{UINT64_C(0xd96999aa01ed772b), UINT64_C(0x14dbf7b3f71cb711)},
+	{UINT64_C(0xadee1488018ac5bc), UINT64_C(0x10aff95cc5b09274)},
+	{UINT64_C(0x497ceda668de092c), UINT64_C(0x1ab328946f80ea54)},
+	{UINT64_C(0x3aca57b853e4d424), UINT64_C(0x155c2076bf9a5510)},
+	{UINT64_C(0x623b7960431d7683), UINT64_C(0x1116805effaeaa73)},
+	{UINT64_C(0x9d2bf566d1c8bd9e), UINT64_C(0x1b5733cb32b110b8)},
+	{UINT64_C(0x7dbcc452416d647f), UINT64_C(0x15df5ca28ef40d60)},
+	{UINT64_C(0xcafd69db678ab6cc), UINT64_C(0x117f7d4ed8c33de6)},
+	{UINT64_C(0xab2f0fc572778adf), UINT64_C(0x1bff2ee48e052fd7)},
+	{UINT64_C(0x88f273045b92d580), UINT64_C(0x1665bf1d3e6a8cac)},
+	{UINT64_C(0xd3f528d049424466), UINT64_C(0x11eaff4a98553d56)},
+	{UINT64_C(0xb988414d4203a0a3), UINT64_C(0x1cab3210f3bb9557)},
+	{UINT64_C(0x6139cdd76802e6e9), UINT64_C(0x16ef5b40c2fc7779)},
+	{UINT64_C(0xe761717920025254), UINT64_C(0x125915cd68c9f92d)},
+	{UINT64_C(0xa568b58e999d5086), UINT64_C(0x1d5b561574765b7c)},
+	{UINT64_C(0x5120913ee14aa6d2), UINT64_C(0x177c44ddf6c515fd)},
+	{UINT64_C(0xa74d40ff1aa21f0e), UINT64_C(0x12c9d0b1923744ca)},
+	{UINT64_C(0x0baece64f769cb4a), UINT64_C(0x1e0fb44f50586e11)},
+	{UINT64_C(0x3c8bd850c5ee3c3b), UINT64_C(0x180c903f7379f1a7)},
+	{UINT64_C(0xca0979da37f1c9c9), UINT64_C(0x133d4032c2c7f485)},
+	{UINT64_C(0xa9a8c2f6bfe942db), UINT64_C(0x1ec866b79e0cba6f)},
+	{UINT64_C(0x2153cf2bccba9be3), UINT64_C(0x18a0522c7e709526)},
+	{UINT64_C(0x1aa9728970954982), UINT64_C(0x13b374f06526ddb8)},
+	{UINT64_C(0xf775840f1a88759d), UINT64_C(0x1f8587e7083e2f8c)},
+	{UINT64_C(0x5f9136727ba05e17), UINT64_C(0x19379fec0698260a)},
+	{UINT64_C(0x1940f85b9619e4df), UINT64_C(0x142c7ff0054684d5)},
+	{UINT64_C(0xe100c6afab47ea4c), UINT64_C(0x1023998cd1053710)},
+	{UINT64_C(0xce67a44c453fdd47), UINT64_C(0x19d28f47b4d524e7)},
+	{UINT64_C(0xd852e9d69dccb106), UINT64_C(0x14a8729fc3ddb71f)},
+	{UINT64_C(0x79dbee454b0a2738), UINT64_C(0x1086c219697e2c19)},
+	{UINT64_C(0x295fe3a211a9d859), UINT64_C(0x1a71368f0f30468f)},
+	{UINT64_C(0xbab31c81a7bb137a), UINT64_C(0x15275ed8d8f36ba5)},
+	{UINT64_C(0x6228e39aec95a92f), UINT64_C(0x10ec4be0ad8f8951)},
+	{UINT64_C(0x9d0e38f7e0ef7517), UINT64_C(0x1b13ac9aaf4c0ee8)},
+	{UINT64_C(0xb0d82d931a592a79), UINT64_C(0x15a956e225d67253)},
+	{UINT64_C(0x8d79be0f4847552e), UINT64_C(0x11544581b7dec1dc)},
+	{UINT64_C(0x158f967eda0bbb7c), UINT64_C(0x1bba08cf8c979c94)},
+	{UINT64_C(0x77a611ff14d62f97), UINT64_C(0x162e6d72d6dfb076)},
+	{UINT64_C(0xf951a7ff43de8c79), UINT64_C(0x11bebdf578b2f391)},
+	{UINT64_C(0xc21c3ffed2fdad8e), UINT64_C(0x1c6463225ab7ec1c)},
+	{UINT64_C(0x01b0333242648ad8), UINT64_C(0x16b6b5b5155ff017)},
+	{UINT64_C(0x0159c28e9b83a246), UINT64_C(0x122bc490dde659ac)},
+	{UINT64_C(0xcef604175f3903a3), UINT64_C(0x1d12d41afca3c2ac)},
+	{UINT64_C(0x725e69ac4c2d9c83), UINT64_C(0x17424348ca1c9bbd)},
+	{UINT64_C(0xf5185489d68ae39c), UINT64_C(0x129b69070816e2fd)},
+	{UINT64_C(0xee8d540fbdab05c6), UINT64_C(0x1dc574d80cf16b2f)},
+	{UINT64_C(0xbed77672fe226b05), UINT64_C(0x17d12a4670c1228c)},
+	{UINT64_C(0xff12c528cb4ebc04), UINT64_C(0x130dbb6b8d674ed6)},
+	{UINT64_C(0xcb513b74787df9a0), UINT64_C(0x1e7c5f127bd87e24)},
+	{UINT64_C(0x090dc929f9fe614d), UINT64_C(0x18637f41fcad31b7)},
+	{UINT64_C(0xa0d7d42194cb810a), UINT64_C(0x1382cc34ca2427c5)},
+	{UINT64_C(0x67bfb9cf5478ce77), UINT64_C(0x1f37ad21436d0c6f)},
+	{UINT64_C(0x1fcc94a5dd2d71f9), UINT64_C(0x18f9574dcf8a7059)},
+	{UINT64_C(0x7fd6dd517dbdf4c7), UINT64_C(0x13faac3e3fa1f37a)},
+	{UINT64_C(0xffbe2ee8c92fee0b), UINT64_C(0x1ff779fd329cb8c3)},
+	{UINT64_C(0x6631bf20a0f324d6), UINT64_C(0x1992c7fdc216fa36)},
+	{UINT64_C(0xb827cc1a1a5c1d78), UINT64_C(0x14756ccb01abfb5e)},
+	{UINT64_C(0x935309ae7b7ce460), UINT64_C(0x105df0a267bcc918)},
+	{UINT64_C(0x1eeb42b0c594a099), UINT64_C(0x1a2fe76a3f9474f4)},
+	{UINT64_C(0xe58902270476e6e1), UINT64_C(0x14f31f8832dd2a5c)},
+	{UINT64_C(0xb7a0ce859d2bebe7), UINT64_C(0x10c27fa028b0eeb0)},
+	{UINT64_C(0x59014a6f61dfdfd8), UINT64_C(0x1ad0cc33744e4ab4)},
+	{UINT64_C(0xe0cdd525e7e64cad), UINT64_C(0x1573d68f903ea229)},
+	{UINT64_C(0x4d7177518651d6f1), UINT64_C(0x11297872d9cbb4ee)},
+	{UINT64_C(0x7be8bee8d6e957e8), UINT64_C(0x1b758d848fac54b0)},
+	{UINT64_C(0xfcba3253df211320), UINT64_C(0x15f7a46a0c89dd59)},
+	{UINT64_C(0x63c8284318e74280), UINT64_C(0x1192e9ee706e4aae)},
+	{UINT64_C(0x060d0d3827d86a66), UINT64_C(0x1c1e43171a4a1117)},
+	{UINT64_C(0x6b3da42cecad21eb), UINT64_C(0x167e9c127b6e7412)},
+	{UINT64_C(0x88fe1cf0bd574e56), UINT64_C(0x11fee341fc585cdb)},
+	{UINT64_C(0x419694b462254a23), UINT64_C(0x1ccb0536608d615f)},
+	{UINT64_C(0x67abaa29e81dd4e9), UINT64_C(0x1708d0f84d3de77f)},
+	{UINT64_C(0xb95621bb2017dd87), UINT64_C(0x126d73f9d764b932)},
+	{UINT64_C(0xc223692b668c95a5), UINT64_C(0x1d7becc2f23ac1ea)},
+	{UINT64_C(0xce82ba891ed6de1d), UINT64_C(0x179657025b6234bb)},
+	{UINT64_C(0xa53562074bdf1818), UINT64_C(0x12deac01e2b4f6fc)},
+	{UINT64_C(0x3b889cd87964f359), UINT64_C(0x1e3113363787f194)},
+	{UINT64_C(0xfc6d4a46c783f5e1), UINT64_C(0x18274291c6065adc)},
+	{UINT64_C(0x30576e9f06032b1a), UINT64_C(0x13529ba7d19eaf17)},
+	{UINT64_C(0x1a257dcb3cd1de90), UINT64_C(0x1eea92a61c311825)},
+	{UINT64_C(0x481dfe3c30a7e540), UINT64_C(0x18bba884e35a79b7)},
+	{UINT64_C(0xd34b31c9c0865100), UINT64_C(0x13c9539d82aec7c5)},
+	{UINT64_C(0x5211e942cda3b4cd), UINT64_C(0x1fa885c8d117a609)},
+	{UINT64_C(0x74db21023e1c90a4), UINT64_C(0x19539e3a40dfb807)},
+	{UINT64_C(0xf715b401cb4a0d50), UINT64_C(0x1442e4fb67196005)},
+	{UINT64_C(0xf8de299b09080aa7), UINT64_C(0x103583fc527ab337)},
+	{UINT64_C(0x8e304291a80cddd7), UINT64_C(0x19ef3993b72ab859)},
+	{UINT64_C(0x3e8d020e200a4b13), UINT64_C(0x14bf6142f8eef9e1)},
+	{UINT64_C(0x653d9b3e80083c0f), UINT64_C(0x10991a9bfa58c7e7)},
+	{UINT64_C(0x6ec8f864000d2ce4), UINT64_C(0x1a8e90f9908e0ca5)},
+	{UINT64_C(0x8bd3f9e999a423ea), UINT64_C(0x153eda614071a3b7)},
+	{UINT64_C(0x3ca994bae1501cbb), UINT64_C(0x10ff151a99f482f9)},
+	{UINT64_C(0xc775bac49bb3612b), UINT64_C(0x1b31bb5dc320d18e)},
+	{UINT64_C(0xd2c4956a16291a89), UINT64_C(0x15c162b168e70e0b)},
+	{UINT64_C(0xdbd0778811ba7ba1), UINT64_C(0x11678227871f3e6f)},
+	{UINT64_C(0x2c80bf401c5d929b), UINT64_C(0x1bd8d03f3e9863e6)},
+	{UINT64_C(0xbd33cc3349e47549), UINT64_C(0x16470cff6546b651)},
+	{UINT64_C(0xca8fd68f6e505dd4), UINT64_C(0x11d270cc51055ea7)},
+	{UINT64_C(0x4419574be3b3c953), UINT64_C(0x1c83e7ad4e6efdd9)},
+	{UINT64_C(0x0347790982f63aa9), UINT64_C(0x16cfec8aa52597e1)},
+	{UINT64_C(0xcf6c60d468c4fbba), UINT64_C(0x123ff06eea847980)},
+	{UINT64_C(0xe57a34870e07f92a), UINT64_C(0x1d331a4b10d3f59a)},
+	{UINT64_C(0x512e906c0b399422), UINT64_C(0x175c1508da432ae2)},
+	{UINT64_C(0xda8ba6bcd5c7a9b5), UINT64_C(0x12b010d3e1cf5581)},
+	{UINT64_C(0x90df712e22d90f87), UINT64_C(0x1de6815302e5559c)},
+	{UINT64_C(0xda4c5a8b4f140c6c), UINT64_C(0x17eb9aa8cf1dde16)},
+	{UINT64_C(0xaea37ba2a5a9a38a), UINT64_C(0x1322e220a5b17e78)},
+	{UINT64_C(0x7dd25f6aa2a905a9), UINT64_C(0x1e9e369aa2b59727)},
+	{UINT64_C(0x97db7f888220d154), UINT64_C(0x187e92154ef7ac1f)},
+	{UINT64_C(0x797c6606ce80a777), UINT64_C(0x139874ddd8c6234c)},
+	{UINT64_C(0x8f2d700ae4010bf1), UINT64_C(0x1f5a549627a36bad)},
+	{UINT64_C(0x0c2459a25000d65a), UINT64_C(0x191510781fb5efbe)},
+	{UINT64_C(0x701d1481d99a4515), UINT64_C(0x1410d9f9b2f7f2fe)},
+	{UINT64_C(0xc017439b147b6a77), UINT64_C(0x100d7b2e28c65bfe)},
+	{UINT64_C(0xccf205c4ed9243f2), UINT64_C(0x19af2b7d0e0a2cca)},
+	{UINT64_C(0x0a5b37d0be0e9cc2), UINT64_C(0x148c22ca71a1bd6f)},
+	{UINT64_C(0x0848f973cb3ee3ce), UINT64_C(0x10701bd527b4978c)},
+	{UINT64_C(0xda0e5bec78649fb0), UINT64_C(0x1a4cf9550c5425ac)},
+	{UINT64_C(0x7b3eaff060507fc0), UINT64_C(0x150a6110d6a9b7bd)},
+	{UINT64_C(0x95cbbff380406633), UINT64_C(0x10d51a73deee2c97)},
+	{UINT64_C(0xefac665266cd7052), UINT64_C(0x1aee90b964b04758)},
+	{UINT64_C(0x2623850eb8a459db), UINT64_C(0x158ba6fab6f36c47)},
+	{UINT64_C(0x1e82d0d893b6ae49), UINT64_C(0x113c85955f29236c)},
+	{UINT64_C(0xfd9e1af41f8ab075), UINT64_C(0x1b9408eefea838ac)},
+	{UINT64_C(0x97b1af29b2d559f7), UINT64_C(0x16100725988693bd)},
+	{UINT64_C(0xac8e25baf5777b2c), UINT64_C(0x11a66c1e139edc97)},
+	{UINT64_C(0x7a7d092b2258c513), UINT64_C(0x1c3d79c9b8fe2dbf)},
+	{UINT64_C(0x61fda0ef4ead6a76), UINT64_C(0x169794a160cb57cc)},
+	{UINT64_C(0xe7fe1a590bbdeec5), UINT64_C(0x1212dd4de7091309)},
+	{UINT64_C(0xa6635d5b45fcb13a), UINT64_C(0x1ceafbafd80e84dc)},
+	{UINT64_C(0x851c4aaf6b308dc8), UINT64_C(0x172262f3133ed0b0)},
+	{UINT64_C(0xd0e36ef2bc26d7d4), UINT64_C(0x1281e8c275cbda26)},
+	{UINT64_C(0xb49f17eac6a48c86), UINT64_C(0x1d9ca79d894629d7)},
+	{UINT64_C(0x2a18dfef0550706b), UINT64_C(0x17b08617a104ee46)},
+	{UINT64_C(0x54e0b3259dd9f389), UINT64_C(0x12f39e794d9d8b6b)},
+	{UINT64_C(0x87cdeb6f62f65274), UINT64_C(0x1e5297287c2f4578)},
+	{UINT64_C(0xd30b22bf825ea85d), UINT64_C(0x18421286c9bf6ac6)},
+	{UINT64_C(0x0f3c1bcc684bb9e4), UINT64_C(0x13680ed23aff889f)},
+	{UINT64_C(0x18602c7a4079296d), UINT64_C(0x1f0ce4839198da98)},
+	{UINT64_C(0x46b356c833942124), UINT64_C(0x18d71d360e13e213)},
+	{UINT64_C(0x388f78a029434db6), UINT64_C(0x13df4a91a4dcb4dc)},
+	{UINT64_C(0x5a7f2766a86baf8a), UINT64_C(0x1fcbaa82a1612160)},
+	{UINT64_C(0x153285ebb9efbfa2), UINT64_C(0x196fbb9bb44db44d)},
+	{UINT64_C(0xaa8ed189618c994e), UINT64_C(0x145962e2f6a4903d)},
+	{UINT64_C(0xeed8a7a11ad6e10c), UINT64_C(0x1047824f2bb6d9ca)},
+	{UINT64_C(0x7e27729b5e249b45), UINT64_C(0x1a0c03b1df8af611)},
+	{UINT64_C(0xfe85f549181d4904), UINT64_C(0x14d6695b193bf80d)},
+	{UINT64_C(0xcb9e5dd4134aa0d0), UINT64_C(0x10ab877c142ff9a4)},
+	{UINT64_C(0xdf63c9535211014d), UINT64_C(0x1aac0bf9b9e65c3a)},
+	{UINT64_C(0x191ca10f74da6771), UINT64_C(0x15566ffafb1eb02f)},
+	{UINT64_C(0xadb080d92a4852c1), UINT64_C(0x1111f32f2f4bc025)},
+	{UINT64_C(0x15e7348eaa0d5134), UINT64_C(0x1b4feb7eb212cd09)},
+	{UINT64_C(0xab1f5d3eee710dc4), UINT64_C(0x15d98932280f0a6d)},
+	{UINT64_C(0xbc1917658b8da49d), UINT64_C(0x117ad428200c0857)},
+	{UINT64_C(0x2cf4f23c127c3a94), UINT64_C(0x1bf7b9d9cce00d59)},
+	{UINT64_C(0xf0c3f4fcdb969543), UINT64_C(0x165fc7e170b33de0)},
+	{UINT64_C(0x5a365d9716121103), UINT64_C(0x11e6398126f5cb1a)},
+	{UINT64_C(0x9056fc24f01ce804), UINT64_C(0x1ca38f350b22de90)},
+	{UINT64_C(0xd9df301d8ce3ecd0), UINT64_C(0x16e93f5da2824ba6)},
+	{UINT64_C(0xe17f59b13d8323da), UINT64_C(0x125432b14ecea2eb)},
+	{UINT64_C(0x68cbc2b52f38395c), UINT64_C(0x1d53844ee47dd179)},
+	{UINT64_C(0x53d6355dbf602de3), UINT64_C(0x177603725064a794)},
+	{UINT64_C(0xa9782ab165e68b1c), UINT64_C(0x12c4cf8ea6b6ec76)},
+	{UINT64_C(0x0f26aab56fd744fa), UINT64_C(0x1e07b27dd78b13f1)},
+	{UINT64_C(0x3f52222abfdf6a62), UINT64_C(0x18062864ac6f4327)},
+	{UINT64_C(0x65db4e88997f884e), UINT64_C(0x1338205089f29c1f)},
+	{UINT64_C(0x6fc54a7428cc0d4a), UINT64_C(0x1ec033b40fea9365)},
+	{UINT64_C(0x596aa1f68709a43b), UINT64_C(0x1899c2f673220f84)},
+	{UINT64_C(0xadeee7f86c07b696), UINT64_C(0x13ae3591f5b4d936)},
+	{UINT64_C(0x497e3ff3e00c5756), UINT64_C(0x1f7d228322baf524)},
+	{UINT64_C(0xd464fff64cd6ac45), UINT64_C(0x1930e868e89590e9)},
+	{UINT64_C(0x4383fff83d7889d1), UINT64_C(0x14272053ed4473ee)},
+	{UINT64_C(0xcf9cccc69793a174), UINT64_C(0x101f4d0ff1038ff1)},
+	{UINT64_C(0x7f6147a425b90252), UINT64_C(0x19cbae7fe805b31c)},
+	{UINT64_C(0xcc4dd2e9b7c7350f), UINT64_C(0x14a2f1ffecd15c16)},
+	{UINT64_C(0x3d0b0f215fd290d9), UINT64_C(0x10825b3323dab012)},
+	{UINT64_C(0x61ab4b689950e7c1), UINT64_C(0x1a6a2b85062ab350)},
+	{UINT64_C(0x4e22a2ba1440b967), UINT64_C(0x1521bc6a6b555c40)},
+	{UINT64_C(0x0b4ee894dd009453), UINT64_C(0x10e7c9eebc4449cd)},
+	{UINT64_C(0x1217da87c800ed51), UINT64_C(0x1b0c764ac6d3a948)},
+	{UINT64_C(0xdb46486ca000bdda), UINT64_C(0x15a391d56bdc876c)},
+	{UINT64_C(0x490506bd4ccd64af), UINT64_C(0x114fa7ddefe39f8a)},
+	{UINT64_C(0xa8080ac87ae23ab1), UINT64_C(0x1bb2a62fe638ff43)},
+	{UINT64_C(0x5339a239fbe82ef4), UINT64_C(0x162884f31e93ff69)},
+	{UINT64_C(0x75c7b4fb2fecf25d), UINT64_C(0x11ba03f5b20fff87)},
+	{UINT64_C(0x22d92191e647ea2e), UINT64_C(0x1c5cd322b67fff3f)},
+	{UINT64_C(0xb57a8141850654f2), UINT64_C(0x16b0a8e891ffff65)},
+	{UINT64_C(0xc4620101373843f5), UINT64_C(0x1226ed86db3332b7)},
+	{UINT64_C(0x3a366801f1f39fee), UINT64_C(0x1d0b15a491eb8459)},
+	{UINT64_C(0xfb5eb99b27f6198b), UINT64_C(0x173c115074bc69e0)},
+	{UINT64_C(0x2f7efae2865e7ad6), UINT64_C(0x129674405d6387e7)},
+	{UINT64_C(0xe597f7d0d6fd9156), UINT64_C(0x1dbd86cd6238d971)},
+	{UINT64_C(0x8479930d78cadaab), UINT64_C(0x17cad23de82d7ac1)},
+	{UINT64_C(0xd06142712d6f1556), UINT64_C(0x1308a831868ac89a)},
+	{UINT64_C(0x4d686a4eaf182222), UINT64_C(0x1e74404f3daada91)},
+	{UINT64_C(0xa453883ef279b4e8), UINT64_C(0x185d003f6488aeda)},
+	{UINT64_C(0xe9dc6cff28615d87), UINT64_C(0x137d99cc506d58ae)},
+	{UINT64_C(0xa960ae650d6895a4), UINT64_C(0x1f2f5c7a1a488de4)},
+	{UINT64_C(0xbab3beb73ded4483), UINT64_C(0x18f2b061aea07183)}
+};
+
+/* 5^i, shifted to be 125 bits long, as {low, high} */
+static const uint64_t d2s_pow5_split[326u][2u] = {
+	{UINT64_C(0x0000000000000000), UINT64_C(0x1000000000000000)},
+	{UINT64_C(0x0000000000000000), UINT64_C(0x1400000000000000)},
+	{UINT64_C(0x0000000000000000), UINT64_C(0x1900000000000000)},
+	{UINT64_C(0x0000000000000000), UINT64_C(0x1f40000000000000)},
+	{UINT64_C(0x0000000000000000), UINT64_C(0x1388000000000000)},
+	{UINT64_C(0x0000000000000000), UINT64_C(0x186a000000000000)},
+	{UINT64_C(0x0000000000000000), UINT64_C(0x1e84800000000000)},
+	{UINT64_C(0x0000000000000000), UINT64_C(0x1312d00000000000)},
+	{UINT64_C(0x0000000000000000), UINT64_C(0x17d7840000000000)},
+	{UINT64_C(0x0000000000000000), UINT64_C(0x1dcd650000000000)},
+	{UINT64_C(0x0000000000000000), UINT64_C(0x12a05f2000000000)},
+	{UINT64_C(0x0000000000000000), UINT64_C(0x174876e800000000)},
+	{UINT64_C(0x0000000000000000), UINT64_C(0x1d1a94a200000000)},
+	{UINT64_C(0x0000000000000000), UINT64_C(0x12309ce540000000)},
+	{UINT64_C(0x0000000000000000), UINT64_C(0x16bcc41e90000000)},
+	{UINT64_C(0x0000000000000000), UINT64_C(0x1c6bf52634000000)},
+	{UINT64_C(0x0000000000000000), UINT64_C(0x11c37937e0800000)},
+	{UINT64_C(0x0000000000000000), UINT64_C(0x16345785d8a00000)},
+	{UINT64_C(0x0000000000000000), UINT64_C(0x1bc16d674ec80000)},
+	{UINT64_C(0x0000000000000000), UINT64_C(0x1158e460913d0000)},
+	{UINT64_C(0x0000000000000000), UINT64_C(0x15af1d78b58c4000)},
+	{UINT64_C(0x0000000000000000), UINT64_C(0x1b1ae4d6e2ef5000)},
+	{UINT64_C(0x0000000000000000), UINT64_C(0x10f0cf064dd59200)},
+	{UINT64_C(0x0000000000000000), UINT64_C(0x152d02c7e14af680)},
+	{UINT64_C(0x0000000000000000), UINT64_C(0x1a784379d99db420)},
+	{UINT64_C(0x0000000000000000), UINT64_C(0x108b2a2c28029094)},
+	{UINT64_C(0x0000000000000000), UINT64_C(0x14adf4b7320334b9)},
+	{UINT64_C(0x4000000000000000), UINT64_C(0x19d971e4fe8401e7)},
+	{UINT64_C(0x8800000000000000), UINT64_C(0x1027e72f1f128130)},
+	{UINT64_C(0xaa00000000000000), UINT64_C(0x1431e0fae6d7217c)},
+	{UINT64_C(0xd480000000000000), UINT64_C(0x193e5939a08ce9db)},
+	{UINT64_C(0xc9a0000000000000), UINT64_C(0x1f8def8808b02452)},
+	{UINT64_C(0xbe04000000000000), UINT64_C(0x13b8b5b5056e16b3)},
+	{UINT64_C(0xad85000000000000), UINT64_C(0x18a6e32246c99c60)},
+	{UINT64_C(0xd8e6400000000000), UINT64_C(0x1ed09bead87c0378)},
+	{UINT64_C(0x878fe80000000000), UINT64_C(0x13426172c74d822b)},
+	{UINT64_C(0x6973e20000000000), UINT64_C(0x1812f9cf7920e2b6)},
+	{UINT64_C(0x03d0da8000000000), UINT64_C(0x1e17b84357691b64)},
+	{UINT64_C(0x8262889000000000), UINT64_C(0x12ced32a16a1b11e)},
+	{UINT64_C(0x22fb2ab400000000), UINT64_C(0x178287f49c4a1d66)},
+	{UINT64_C(0xabb9f56100000000), UINT64_C(0x1d6329f1c35ca4bf)},
+	{UINT64_C(0xcb54395ca0000000), UINT64_C(0x125dfa371a19e6f7)},
+	{UINT64_C(0xbe2947b3c8000000), UINT64_C(0x16f578c4e0a060b5)},
+	{UINT64_C(0x2db399a0ba000000), UINT64_C(0x1cb2d6f618c878e3)},
+	{UINT64_C(0xfc90400474400000), UINT64_C(0x11efc659cf7d4b8d)},
+	{UINT64_C(0x7bb4500591500000), UINT64_C(0x166bb7f0435c9e71)},
+	{UINT64_C(0xdaa16406f5a40000), UINT64_C(0x1c06a5ec5433c60d)},
+	{UINT64_C(0xa8a4de8459868000), UINT64_C(0x118427b3b4a05bc8)},
+	{UINT64_C(0xd2ce16256fe82000), UINT64_C(0x15e531a0a1c872ba)},
+	{UINT64_C(0x87819baecbe22800), UINT64_C(0x1b5e7e08ca3a8f69)},
+	{UINT64_C(0xf4b1014d3f6d5900), UINT64_C(0x111b0ec57e6499a1)},
+	{UINT64_C(0x71dd41a08f48af40), UINT64_C(0x1561d276ddfdc00a)},
+	{UINT64_C(0x0e549208b31adb10), UINT64_C(0x1aba4714957d300d)},
+	{UINT64_C(0x28f4db456ff0c8ea), UINT64_C(0x10b46c6cdd6e3e08)},
+	{UINT64_C(0x33321216cbecfb24), UINT64_C(0x14e1878814c9cd8a)},
+	{UINT64_C(0xbffe969c7ee839ed), UINT64_C(0x1a19e96a19fc40ec)},
+	{UINT64_C(0xf7ff1e21cf512434), UINT64_C(0x105031e2503da893)},
+	{UINT64_C(0xf5fee5aa43256d41), UINT64_C(0x14643e5ae44d12b8)},
+	{UINT64_C(0x337e9f14d3eec892), UINT64_C(0x197d4df19d605767)},
+	{UINT64_C(0x005e46da08ea7ab6), UINT64_C(0x1fdca16e04b86d41)},
+	{UINT64_C(0xa03aec4845928cb2), UINT64_C(0x13e9e4e4c2f34448)},
+	{UINT64_C(0xc849a75a56f72fde), UINT64_C(0x18e45e1df3b0155a)},
+	{UINT64_C(0x7a5c1130ecb4fbd6), UINT64_C(0x1f1d75a5709c1ab1)},
+	{UINT64_C(0xec798abe93f11d65), UINT64_C(0x13726987666190ae)},
+	{UINT64_C(0xa797ed6e38ed64bf), UINT64_C(0x184f03e93ff9f4da)},
+	{UINT64_C(0x517de8c9c728bdef), UINT64_C(0x1e62c4e38ff87211)},
+	{UINT64_C(0xd2eeb17e1c7976b5), UINT64_C(0x12fdbb0e39fb474a)},
+	{UINT64_C(0x87aa5ddda397d462), UINT64_C(0x17bd29d1c87a191d)},
+	{UINT64_C(0xe994f5550c7dc97b), UINT64_C(0x1dac74463a989f64)},
+	{UINT64_C(0x11fd195527ce9ded), UINT64_C(0x128bc8abe49f639f)},
+	{UINT64_C(0xd67c5faa71c24568), UINT64_C(0x172ebad6ddc73c86)},
+	{UINT64_C(0x8c1b77950e32d6c2), UINT64_C(0x1cfa698c95390ba8)},
+	{UINT64_C(0x57912abd28dfc639), UINT64_C(0x121c81f7dd43a749)},
+	{UINT64_C(0xad75756c7317b7c8), UINT64_C(0x16a3a275d494911b)},
+	{UINT64_C(0x98d2d2c78fdda5ba), UINT64_C(0x1c4c8b1349b9b562)},
+	{UINT64_C(0x9f83c3bcb9ea8794), UINT64_C(0x11afd6ec0e14115d)},
+	{UINT64_C(0x0764b4abe8652979), UINT64_C(0x161bcca7119915b5)},
+	{UINT64_C(0x493de1d6e27e73d7), UINT64_C(0x1ba2bfd0d5ff5b22)},
+	{UINT64_C(0x6dc6ad264d8f0866), UINT64_C(0x1145b7e285bf98f5)},
+	{UINT64_C(0xc938586fe0f2ca80), UINT64_C(0x159725db272f7f32)},
+	{UINT64_C(0x7b866e8bd92f7d20), UINT64_C(0x1afcef51f0fb5eff)},
+	{UINT64_C(0xad34051767bdae34), UINT64_C(0x10de1593369d1b5f)},
+	{UINT64_C(0x9881065d41ad19c1), UINT64_C(0x15159af804446237)},
+	{UINT64_C(0x7ea147f492186032), UINT64_C(0x1a5b01b605557ac5)},
+	{UINT64_C(0x6f24ccf8db4f3c1f), UINT64_C(0x1078e111c3556cbb)},
+	{UINT64_C(0x4aee003712230b27), UINT64_C(0x14971956342ac7ea)},
+	{UINT64_C(0xdda98044d6abcdf0), UINT64_C(0x19bcdfabc13579e4)},
+	{UINT64_C(0x0a89f02b062b60b6), UINT64_C(0x10160bcb58c16c2f)},
+	{UINT64_C(0xcd2c6c35c7b638e4), UINT64_C(0x141b8ebe2ef1c73a)},
+	{UINT64_C(0x8077874339a3c71d), UINT64_C(0x1922726dbaae3909)},
+	{UINT64_C(0xe0956914080cb8e4), UINT64_C(0x1f6b0f092959c74b)},
+	{UINT64_C(0x6c5d61ac8507f38e), UINT64_C(0x13a2e965b9d81c8f)},
+	{UINT64_C(0x4774ba17a649f072), UINT64_C(0x188ba3bf284e23b3)},
+	{UINT64_C(0x1951e89d8fdc6c8f), UINT64_C(0x1eae8caef261aca0)},
+	{UINT64_C(0x0fd3316279e9c3d9), UINT64_C(0x132d17ed577d0be4)},
+	{UINT64_C(0x13c7fdbb186434cf), UINT64_C(0x17f85de8ad5c4edd)},
+	{UINT64_C(0x58b9fd29de7d4203), UINT64_C(0x1df67562d8b36294)},
+	{UINT64_C(0xb7743e3a2b0e4942), UINT64_C(0x12ba095dc7701d9c)},
+	{UINT64_C(0xe5514dc8b5d1db92), UINT64_C(0x17688bb5394c2503)},
+	{UINT64_C(0xdea5a13ae3465277), UINT64_C(0x1d42aea2879f2e44)},
+	{UINT64_C(0x0b2784c4ce0bf38a), UINT64_C(0x1249ad2594c37ceb)},
+	{UINT64_C(0xcdf165f6018ef06d), UINT64_C(0x16dc186ef9f45c25)},
+	{UINT64_C(0x416dbf7381f2ac88), UINT64_C(0x1c931e8ab871732f)},
+	{UINT64_C(0x88e497a83137abd5), UINT64_C(0x11dbf316b346e7fd)},
+	{UINT64_C(0xeb1dbd923d8596ca), UINT64_C(0x1652efdc6018a1fc)},
+	{UINT64_C(0x25e52cf6cce6fc7d), UINT64_C(0x1be7abd3781eca7c)},
+	{UINT64_C(0x97af3c1a40105dce), UINT64_C(0x1170cb642b133e8d)},
+	{UINT64_C(0xfd9b0b20d0147542), UINT64_C(0x15ccfe3d35d80e30)},
+	{UINT64_C(0x3d01cde904199292), UINT64_C(0x1b403dcc834e11bd)},
+	{UINT64_C(0x462120b1a28ffb9b), UINT64_C(0x1108269fd210cb16)},
+	{UINT64_C(0xd7a968de0b33fa82), UINT64_C(0x154a3047c694fddb)},
+	{UINT64_C(0xcd93c3158e00f923), UINT64_C(0x1a9cbc59b83a3d52)},
+	{UINT64_C(0xc07c59ed78c09bb6), UINT64_C(0x10a1f5b813246653)},
+	{UINT64_C(0xb09b7068d6f0c2a3), UINT64_C(0x14ca732617ed7fe8)},
+	{UINT64_C(0xdcc24c830cacf34c), UINT64_C(0x19fd0fef9de8dfe2)},
+	{UINT64_C(0xc9f96fd1e7ec180f), UINT64_C(0x103e29f5c2b18bed)},
+	{UINT64_C(0x3c77cbc661e71e13), UINT64_C(0x144db473335deee9)},
+	{UINT64_C(0x8b95beb7fa60e598), UINT64_C(0x1961219000356aa3)},
+	{UINT64_C(0x6e7b2e65f8f91efe), UINT64_C(0x1fb969f40042c54c)},
+	{UINT64_C(0xc50cfcffbb9bb35f), UINT64_C(0x13d3e2388029bb4f)},
+	{UINT64_C(0xb6503c3faa82a037), UINT64_C(0x18c8dac6a0342a23)},
+	{UINT64_C(0xa3e44b4f95234844), UINT64_C(0x1efb1178484134ac)},
+	{UINT64_C(0xe66eaf11bd360d2b), UINT64_C(0x135ceaeb2d28c0eb)},
+	{UINT64_C(0xe00a5ad62c839075), UINT64_C(0x183425a5f872f126)},
+	{UINT64_C(0x980cf18bb7a47493), UINT64_C(0x1e412f0f768fad70)},
+	{UINT64_C(0x5f0816f752c6c8dc), UINT64_C(0x12e8bd69aa19cc66)},
+	{UINT64_C(0xf6ca1cb527787b13), UINT64_C(0x17a2ecc414a03f7f)},
+	{UINT64_C(0xf47ca3e2715699d7), UINT64_C(0x1d8ba7f519c84f5f)},
+	{UINT64_C(0xf8cde66d86d62026), UINT64_C(0x127748f9301d319b)},
+	{UINT64_C(0xf7016008e88ba830), UINT64_C(0x17151b377c247e02)},
+	{UINT64_C(0xb4c1b80b22ae923c), UINT64_C(0x1cda62055b2d9d83)},
+	{UINT64_C(0x50f91306f5ad1b65), UINT64_C(0x12087d4358fc8272)},
+	{UINT64_C(0xe53757c8b318623f), UINT64_C(0x168a9c942f3ba30e)},
+	{UINT64_C(0x9e852dbadfde7acf), UINT64_C(0x1c2d43b93b0a8bd2)},
+	{UINT64_C(0xa3133c94cbeb0cc1), UINT64_C(0x119c4a53c4e69763)},
+	{UINT64_C(0x8bd80bb9fee5cff1), UINT64_C(0x16035ce8b6203d3c)},
+	{UINT64_C(0xaece0ea87e9f43ee), UINT64_C(0x1b843422e3a84c8b)},
+	{UINT64_C(0x4d40c9294f238a75), UINT64_C(0x1132a095ce492fd7)},
+	{UINT64_C(0x2090fb73a2ec6d12), UINT64_C(0x157f48bb41db7bcd)},
+	{UINT64_C(0x68b53a508ba78856), UINT64_C(0x1adf1aea12525ac0)},
+	{UINT64_C(0x417144725748b536), UINT64_C(0x10cb70d24b7378b8)},
+	{UINT64_C(0x51cd958eed1ae283), UINT64_C(0x14fe4d06de5056e6)},
+	{UINT64_C(0xe640faf2a8619b24), UINT64_C(0x1a3de04895e46c9f)},
+	{UINT64_C(0xefe89cd7a93d00f7), UINT64_C(0x1066ac2d5daec3e3)},
+	{UINT64_C(0xebe2c40d938c4134), UINT64_C(0x14805738b51a74dc)},
+	{UINT64_C(0x26db7510f86f5181), UINT64_C(0x19a06d06e2611214)},
+	{UINT64_C(0x9849292a9b4592f1), UINT64_C(0x100444244d7cab4c)},
+	{UINT64_C(0xbe5b73754216f7ad), UINT64_C(0x1405552d60dbd61f)},
+	{UINT64_C(0xadf25052929cb598), UINT64_C(0x1906aa78b912cba7)},
+	{UINT64_C(0x996ee4673743e2ff), UINT64_C(0x1f485516e7577e91)},
+	{UINT64_C(0xffe54ec0828a6ddf), UINT64_C(0x138d352e5096af1a)},
+	{UINT64_C(0xbfdea270a32d0957), UINT64_C(0x18708279e4bc5ae1)},
+	{UINT64_C(0x2fd64b0ccbf84bad), UINT64_C(0x1e8ca3185deb719a)},
+	{UINT64_C(0x5de5eee7ff7b2f4c), UINT64_C(0x1317e5ef3ab32700)},
+	{UINT64_C(0x755f6aa1ff59fb1f), UINT64_C(0x17dddf6b095ff0c0)},
+	{UINT64_C(0x92b7454a7f3079e7), UINT64_C(0x1dd55745cbb7ecf0)},
+	{UINT64_C(0x5bb28b4e8f7e4c30), UINT64_C(0x12a5568b9f52f416)},
+	{UINT64_C(0xf29f2e22335ddf3c), UINT64_C(0x174eac2e8727b11b)},
+	{UINT64_C(0xef46f9aac035570b), UINT64_C(0x1d22573a28f19d62)},
+	{UINT64_C(0xd58c5c0ab8215667), UINT64_C(0x123576845997025d)},
+	{UINT64_C(0x4aef730d6629ac01), UINT64_C(0x16c2d4256ffcc2f5)},
+	{UINT64_C(0x9dab4fd0bfb41701), UINT64_C(0x1c73892ecbfbf3b2)},
+	{UINT64_C(0xa28b11e277d08e60), UINT64_C(0x11c835bd3f7d784f)},
+	{UINT64_C(0x8b2dd65b15c4b1f9), UINT64_C(0x163a432c8f5cd663)},
+	{UINT64_C(0x6df94bf1db35de77), UINT64_C(0x1bc8d3f7b3340bfc)},
+	{UINT64_C(0xc4bbcf772901ab0a), UINT64_C(0x115d847ad000877d)},
+	{UINT64_C(0x35eac354f34215cd), UINT64_C(0x15b4e5998400a95d)},
+	{UINT64_C(0x8365742a30129b40), UINT64_C(0x1b221effe500d3b4)},
+	{UINT64_C(0xd21f689a5e0ba108), UINT64_C(0x10f5535fef208450)},
+	{UINT64_C(0x06a742c0f58e894a), UINT64_C(0x1532a837eae8a565)},
+	{UINT64_C(0x4851137132f22b9d), UINT64_C(0x1a7f5245e5a2cebe)},
+	{UINT64_C(0xed32ac26bfd75b42), UINT64_C(0x108f936baf85c136)},
+	{UINT64_C(0xa87f57306fcd3212), UINT64_C(0x14b378469b673184)},
+	{UINT64_C(0xd29f2cfc8bc07e97), UINT64_C(0x19e056584240fde5)},
+	{UINT64_C(0xa3a37c1dd7584f1e), UINT64_C(0x102c35f729689eaf)},
+	{UINT64_C(0x8c8c5b254d2e62e6), UINT64_C(0x14374374f3c2c65b)},
+	{UINT64_C(0x6faf71eea079fb9f), UINT64_C(0x1945145230b377f2)},
+	{UINT64_C(0x0b9b4e6a48987a87), UINT64_C(0x1f965966bce055ef)},
+	{UINT64_C(0x674111026d5f4c94), UINT64_C(0x13bdf7e0360c35b5)},
+	{UINT64_C(0xc111554308b71fba), UINT64_C(0x18ad75d8438f4322)},
+	{UINT64_C(0x7155aa93cae4e7a8), UINT64_C(0x1ed8d34e547313eb)},
+	{UINT64_C(0x26d58a9c5ecf10c9), UINT64_C(0x13478410f4c7ec73)},
+	{UINT64_C(0xf08aed437682d4fb), UINT64_C(0x1819651531f9e78f)},
+	{UINT64_C(0xecada89454238a3a), UINT64_C(0x1e1fbe5a7e786173)},
+	{UINT64_C(0x73ec895cb4963664), UINT64_C(0x12d3d6f88f0b3ce8)},
+	{UINT64_C(0x90e7abb3e1bbc3fd), UINT64_C(0x1788ccb6b2ce0c22)},
+	{UINT64_C(0x352196a0da2ab4fd), UINT64_C(0x1d6affe45f818f2b)},
+	{UINT64_C(0x0134fe24885ab11e), UINT64_C(0x1262dfeebbb0f97b)},
+	{UINT64_C(0xc1823dadaa715d65), UINT64_C(0x16fb97ea6a9d37d9)},
+	{UINT64_C(0x31e2cd19150db4bf), UINT64_C(0x1cba7de5054485d0)},
+	{UINT64_C(0x1f2dc02fad2890f7), UINT64_C(0x11f48eaf234ad3a2)},
+	{UINT64_C(0xa6f9303b9872b535), UINT64_C(0x1671b25aec1d888a)},
+	{UINT64_C(0x50b77c4a7e8f6282), UINT64_C(0x1c0e1ef1a724eaad)},
+	{UINT64_C(0x5272adae8f199d91), UINT64_C(0x1188d357087712ac)},
+	{UINT64_C(0x670f591a32e004f6), UINT64_C(0x15eb082cca94d757)},
+	{UINT64_C(0x40d32f60bf980633), UINT64_C(0x1b65ca37fd3a0d2d)},
+	{UINT64_C(0x4883fd9c77bf03e0), UINT64_C(0x111f9e62fe44483c)},
+	{UINT64_C(0x5aa4fd0395aec4d8), UINT64_C(0x156785fbbdd55a4b)},
+	{UINT64_C(0x314e3c447b1a760e), UINT64_C(0x1ac1677aad4ab0de)},
+	{UINT64_C(0xded0e5aaccf089c9), UINT64_C(0x10b8e0acac4eae8a)},
+	{UINT64_C(0x96851f15802cac3b), UINT64_C(0x14e718d7d7625a2d)},
+	{UINT64_C(0xfc2666dae037d74a), UINT64_C(0x1a20df0dcd3af0b8)},
+	{UINT64_C(0x9d980048cc22e68e), UINT64_C(0x10548b68a044d673)},
+	{UINT64_C(0x84fe005aff2ba032), UINT64_C(0x1469ae42c8560c10)},
+	{UINT64_C(0xa63d8071bef6883e), UINT64_C(0x198419d37a6b8f14)},
+	{UINT64_C(0xcfcce08e2eb42a4e), UINT64_C(0x1fe52048590672d9)},
+	{UINT64_C(0x21e00c58dd309a70), UINT64_C(0x13ef342d37a407c8)},
+	{UINT64_C(0x2a580f6f147cc10d), UINT64_C(0x18eb0138858d09ba)},
+	{UINT64_C(0xb4ee134ad99bf150), UINT64_C(0x1f25c186a6f04c28)},
+	{UINT64_C(0x7114cc0ec80176d2), UINT64_C(0x137798f428562f99)},
+	{UINT64_C(0xcd59ff127a01d486), UINT64_C(0x18557f31326bbb7f)},
+	{UINT64_C(0xc0b07ed7188249a8), UINT64_C(0x1e6adefd7f06aa5f)},
+	{UINT64_C(0xd86e4f466f516e09), UINT64_C(0x1302cb5e6f642a7b)},
+	{UINT64_C(0xce89e3180b25c98b), UINT64_C(0x17c37e360b3d351a)},
+	{UINT64_C(0x822c5bde0def3bee), UINT64_C(0x1db45dc38e0c8261)},
+	{UINT64_C(0xf15bb96ac8b58575), UINT64_C(0x1290ba9a38c7d17c)},
+	{UINT64_C(0x2db2a7c57ae2e6d2), UINT64_C(0x1734e940c6f9c5dc)},
+	{UINT64_C(0x391f51b6d99ba086), UINT64_C(0x1d022390f8b83753)},
+	{UINT64_C(0x03b3931248014454), UINT64_C(0x1221563a9b732294)},
+	{UINT64_C(0x04a077d6da019569), UINT64_C(0x16a9abc9424feb39)},
+	{UINT64_C(0x45c895cc9081fac3), UINT64_C(0x1c5416bb92e3e607)},
+	{UINT64_C(0x8b9d5d9fda513cba), UINT64_C(0x11b48e353bce6fc4)},
+	{UINT64_C(0xae84b507d0e58be8), UINT64_C(0x1621b1c28ac20bb5)},
+	{UINT64_C(0x1a25e249c51eeee3), UINT64_C(0x1baa1e332d728ea3)},
+	{UINT64_C(0xf057ad6e1b33554d), UINT64_C(0x114a52dffc679925)},
+	{UINT64_C(0x6c6d98c9a2002aa1), UINT64_C(0x159ce797fb817f6f)},
+	{UINT64_C(0x4788fefc0a803549), UINT64_C(0x1b04217dfa61df4b)},
+	{UINT64_C(0x0cb59f5d8690214e), UINT64_C(0x10e294eebc7d2b8f)},
+	{UINT64_C(0xcfe30734e83429a1), UINT64_C(0x151b3a2a6b9c7672)},
+	{UINT64_C(0x83dbc9022241340a), UINT64_C(0x1a6208b50683940f)},
+	{UINT64_C(0xb2695da15568c086), UINT64_C(0x107d457124123c89)},
+	{UINT64_C(0x1f03b509aac2f0a7), UINT64_C(0x149c96cd6d16cbac)},
+	{UINT64_C(0x26c4a24c1573acd1), UINT64_C(0x19c3bc80c85c7e97)},
+	{UINT64_C(0x783ae56f8d684c03), UINT64_C(0x101a55d07d39cf1e)},
+	{UINT64_C(0x16499ecb70c25f03), UINT64_C(0x1420eb449c8842e6)},
+	{UINT64_C(0x9bdc067e4cf2f6c4), UINT64_C(0x19292615c3aa539f)},
+	{UINT64_C(0x82d3081de02fb476), UINT64_C(0x1f736f9b3494e887)},
+	{UINT64_C(0xb1c3e512ac1dd0c9), UINT64_C(0x13a825c100dd1154)},
+	{UINT64_C(0xde34de57572544fc), UINT64_C(0x18922f31411455a9)},
+	{UINT64_C(0x55c215ed2cee963b), UINT64_C(0x1eb6bafd91596b14)},
+	{UINT64_C(0xb5994db43c151de5), UINT64_C(0x133234de7ad7e2ec)},
+	{UINT64_C(0xe2ffa1214b1a655e), UINT64_C(0x17fec216198ddba7)},
+	{UINT64_C(0xdbbf89699de0feb6), UINT64_C(0x1dfe729b9ff15291)},
+	{UINT64_C(0x2957b5e202ac9f31), UINT64_C(0x12bf07a143f6d39b)},
+	{UINT64_C(0xf3ada35a8357c6fe), UINT64_C(0x176ec98994f48881)},
+	{UINT64_C(0x70990c31242db8bd), UINT64_C(0x1d4a7bebfa31aaa2)},
+	{UINT64_C(0x865fa79eb69c9376), UINT64_C(0x124e8d737c5f0aa5)},
+	{UINT64_C(0xe7f791866443b854), UINT64_C(0x16e230d05b76cd4e)},
+	{UINT64_C(0xa1f575e7fd54a669), UINT64_C(0x1c9abd04725480a2)},
+	{UINT64_C(0xa53969b0fe54e801), UINT64_C(0x11e0b622c774d065)},
+	{UINT64_C(0x0e87c41d3dea2202), UINT64_C(0x1658e3ab7952047f)},
+	{UINT64_C(0xd229b5248d64aa82), UINT64_C(0x1bef1c9657a6859e)},
+	{UINT64_C(0x435a1136d85eea91), UINT64_C(0x117571ddf6c81383)},
+	{UINT64_C(0x143095848e76a536), UINT64_C(0x15d2ce55747a1864)},
+	{UINT64_C(0x193cbae5b2144e83), UINT64_C(0x1b4781ead1989e7d)},
+	{UINT64_C(0x2fc5f4cf8f4cb112), UINT64_C(0x110cb132c2ff630e)},
+	{UINT64_C(0xbbb77203731fdd56), UINT64_C(0x154fdd7f73bf3bd1)},
+	{UINT64_C(0x2aa54e844fe7d4ac), UINT64_C(0x1aa3d4df50af0ac6)},
+	{UINT64_C(0xdaa75112b1f0e4eb), UINT64_C(0x10a6650b926d66bb)},
+	{UINT64_C(0xd15125575e6d1e26), UINT64_C(0x14cffe4e7708c06a)},
+	{UINT64_C(0x85a56ead360865b0), UINT64_C(0x1a03fde214caf085)},
+	{UINT64_C(0x7387652c41c53f8e), UINT64_C(0x10427ead4cfed653)},
+	{UINT64_C(0x50693e7752368f71), UINT64_C(0x14531e58a03e8be8)},
+	{UINT64_C(0x64838e1526c4334e), UINT64_C(0x1967e5eec84e2ee2)},
+	{UINT64_C(0xfda4719a70754022), UINT64_C(0x1fc1df6a7a61ba9a)},
+	{UINT64_C(0xde86c70086494815), UINT64_C(0x13d92ba28c7d14a0)},
+	{UINT64_C(0x162878c0a7db9a1a), UINT64_C(0x18cf768b2f9c59c9)},
+	{UINT64_C(0x5bb296f0d1d280a1), UINT64_C(0x1f03542dfb83703b)},
+	{UINT64_C(0x194f9e5683239064), UINT64_C(0x1362149cbd322625)},
+	{UINT64_C(0x5fa385ec23ec747e), UINT64_C(0x183a99c3ec7eafae)},
+	{UINT64_C(0xf78c67672ce7919d), UINT64_C(0x1e494034e79e5b99)},
+	{UINT64_C(0x3ab7c0a07c10bb02), UINT64_C(0x12edc82110c2f940)},
+	{UINT64_C(0x4965b0c89b14e9c3), UINT64_C(0x17a93a2954f3b790)},
+	{UINT64_C(0x5bbf1cfac1da2433), UINT64_C(0x1d9388b3aa30a574)},
+	{UINT64_C(0xb957721cb92856a0), UINT64_C(0x127c35704a5e6768)},
+	{UINT64_C(0xe7ad4ea3e7726c48), UINT64_C(0x171b42cc5cf60142)},
+	{UINT64_C(0xa198a24ce14f075a), UINT64_C(0x1ce2137f74338193)},
+	{UINT64_C(0x44ff65700cd16498), UINT64_C(0x120d4c2fa8a030fc)},
+	{UINT64_C(0x563f3ecc1005bdbe), UINT64_C(0x16909f3b92c83d3b)},
+	{UINT64_C(0x2bcf0e7f14072d2e), UINT64_C(0x1c34c70a777a4c8a)},
+	{UINT64_C(0x5b61690f6c847c3d), UINT64_C(0x11a0fc668aac6fd6)},
+	{UINT64_C(0xf239c35347a59b4c), UINT64_C(0x16093b802d578bcb)},
+	{UINT64_C(0xeec83428198f021f), UINT64_C(0x1b8b8a6038ad6ebe)},
+	{UINT64_C(0x553d20990ff96153), UINT64_C(0x1137367c236c6537)},
+	{UINT64_C(0x2a8c68bf53f7b9a8), UINT64_C(0x1585041b2c477e85)},
+	{UINT64_C(0x752f82ef28f5a812), UINT64_C(0x1ae64521f7595e26)},
+	{UINT64_C(0x093db1d57999890b), UINT64_C(0x10cfeb353a97dad8)},
+	{UINT64_C(0x0b8d1e4ad7ffeb4e), UINT64_C(0x1503e602893dd18e)},
+	{UINT64_C(0x8e7065dd8dffe622), UINT64_C(0x1a44df832b8d45f1)},
+	{UINT64_C(0xf9063faa78bfefd5), UINT64_C(0x106b0bb1fb384bb6)},
+	{UINT64_C(0xb747cf9516efebca), UINT64_C(0x1485ce9e7a065ea4)},
+	{UINT64_C(0xe519c37a5cabe6bd), UINT64_C(0x19a742461887f64d)},
+	{UINT64_C(0xaf301a2c79eb7036), UINT64_C(0x1008896bcf54f9f0)},
+	{UINT64_C(0xdafc20b798664c43), UINT64_C(0x140aabc6c32a386c)},
+	{UINT64_C(0x11bb28e57e7fdf54), UINT64_C(0x190d56b873f4c688)},
+	{UINT64_C(0x1629f31ede1fd72a), UINT64_C(0x1f50ac6690f1f82a)},
+	{UINT64_C(0x4dda37f34ad3e67a), UINT64_C(0x13926bc01a973b1a)},
+	{UINT64_C(0xe150c5f01d88e019), UINT64_C(0x187706b0213d09e0)},
+	{UINT64_C(0x19a4f76c24eb181f), UINT64_C(0x1e94c85c298c4c59)},
+	{UINT64_C(0xb0071aa39712ef13), UINT64_C(0x131cfd3999f7afb7)},
+	{UINT64_C(0x9c08e14c7cd7aad8), UINT64_C(0x17e43c8800759ba5)},
+	{UINT64_C(0x030b199f9c0d958e), UINT64_C(0x1ddd4baa0093028f)},
+	{UINT64_C(0x61e6f003c1887d79), UINT64_C(0x12aa4f4a405be199)},
+	{UINT64_C(0xba60ac04b1ea9cd7), UINT64_C(0x1754e31cd072d9ff)},
+	{UINT64_C(0xa8f8d705de65440d), UINT64_C(0x1d2a1be4048f907f)},
+	{UINT64_C(0xc99b8663aaff4a88), UINT64_C(0x123a516e82d9ba4f)},
+	{UINT64_C(0xbc0267fc95bf1d2a), UINT64_C(0x16c8e5ca239028e3)},
+	{UINT64_C(0xab0301fbbb2ee474), UINT64_C(0x1c7b1f3cac74331c)},
+	{UINT64_C(0xeae1e13d54fd4ec9), UINT64_C(0x11ccf385ebc89ff1)},
+	{UINT64_C(0x659a598caa3ca27b), UINT64_C(0x1640306766bac7ee)},
+	{UINT64_C(0xff00efefd4cbcb1a), UINT64_C(0x1bd03c81406979e9)},
+	{UINT64_C(0x3f6095f5e4ff5ef0), UINT64_C(0x116225d0c841ec32)},
+	{UINT64_C(0xcf38bb735e3f36ac), UINT64_C(0x15baaf44fa52673e)},
+	{UINT64_C(0x8306ea5035cf0457), UINT64_C(0x1b295b1638e7010e)},
+	{UINT64_C(0x11e4527221a162b6), UINT64_C(0x10f9d8ede39060a9)},
+	{UINT64_C(0x565d670eaa09bb64), UINT64_C(0x15384f295c7478d3)},
+	{UINT64_C(0x2bf4c0d2548c2a3d), UINT64_C(0x1a8662f3b3919708)},
+	{UINT64_C(0x1b78f88374d79a66), UINT64_C(0x1093fdd8503afe65)},
+	{UINT64_C(0x625736a4520d8100), UINT64_C(0x14b8fd4e6449bdfe)},
+	{UINT64_C(0xfaed044d6690e140), UINT64_C(0x19e73ca1fd5c2d7d)},
+	{UINT64_C(0xbcd422b0601a8cc8), UINT64_C(0x103085e53e599c6e)},
+	{UINT64_C(0x6c092b5c78212ffa), UINT64_C(0x143ca75e8df0038a)},
+	{UINT64_C(0x070b763396297bf8), UINT64_C(0x194bd136316c046d)},
+	{UINT64_C(0x48ce53c07bb3daf6), UINT64_C(0x1f9ec583bdc70588)},
+	{UINT64_C(0x2d80f4584d5068da), UINT64_C(0x13c33b72569c6375)},
+	{UINT64_C(0x78e1316e60a48310), UINT64_C(0x18b40a4eec437c52)}
+};
+
+/* ------------------------------------------------------------------------ */
+
+/* returns ceil(log2(5^e)), or 1 for 0 */
+ALWAYS_INLINE CONST int32_t
+d2s_pow5bits(int32_t e)
+/*@*/
+{
+	return (int32_t) (((uint32_t) e * 1217359u) >> 19u) + 1;
 }
 
-/* returns the number of bytes written to dest */
-static size_t
-printf_flag_sigil_int_m(
-	/*@out@*/ char dest[STATIC(1u)], enum FormatConvSpec_Int convspec
-)
-/*@modifies	dest[]@*/
+/* returns floor(log10(2^e)) */
+ALWAYS_INLINE CONST int32_t
+d2s_log10pow2(int32_t e)
+/*@*/
 {
-	const char sigil_d = '#';
-	const char sigil_b = '%';
-	const char sigil_o = '@';
-	const char sigil_x = '$';
+	return (int32_t) (((uint32_t) e * 78913u) >> 18u);
+}
 
-	size_t retval = 0;
+/* returns floor(log10(5^e)) */
+ALWAYS_INLINE CONST int32_t
+d2s_log10pow5(int32_t e)
+/*@*/
+{
+	return (int32_t) (((uint32_t) e * 732923u) >> 20u);
+}
 
-	switch ( convspec ){
-	case FORMATCONVSPEC_INT_UNSET:
-		assert(FALSE);
-		break;
-	case FORMATCONVSPEC_INT_d:
-	case FORMATCONVSPEC_INT_u:
-		dest[0] = sigil_d;
-		retval  = sizeof sigil_d;
-		break;
-	case FORMATCONVSPEC_INT_b:
-		dest[0] = sigil_b;
-		retval  = sizeof sigil_b;
-		break;
-	case FORMATCONVSPEC_INT_o:
-		dest[0] = sigil_o;
-		retval  = sizeof sigil_o;
-		break;
-	case FORMATCONVSPEC_INT_x:
-	case FORMATCONVSPEC_INT_X:
-		dest[0] = sigil_x;
-		retval  = sizeof sigil_x;
-		break;
+/* returns whether 'value' is divisible by 5^p */
+static CONST int
+d2s_multiple_of_pow5(uint64_t value, int32_t p)
+/*@*/
+{
+	int32_t count = 0;
+
+	while ( value % 5u == 0 ){
+		value /= 5u;
+		++count;
 	}
+	return (int) (count >= p);
+}
 
-	/*@-mustdefine@*/
-	return retval;
-	/*@-mustdefine@*/
+/* returns whether 'value' is divisible by 2^p */
+ALWAYS_INLINE CONST int
+d2s_multiple_of_pow2(uint64_t value, int32_t p)
+/*@*/
+{
+	return (int) ((value & ((UINT64_C(1) << (uint32_t) p) - 1u)) == 0);
 }
 
-/* returns the number of bytes written to dest */
-static size_t
-printf_flag_sigil_int(
-	/*@out@*/ char dest[STATIC(2u)], const struct ItemFormat_Int *itemfmt
-)
-/*@modifies	dest[]@*/
+#ifndef HAVE_UINT128
+/* returns the low half of 'a * b', and sets '*hi' to the high half */
+static uint64_t
+d2s_umul128(uint64_t a, uint64_t b, /*@out@*/ uint64_t *hi)
+/*@modifies	*hi@*/
 {
-	const unsigned int            flags    = itemfmt->flags;
-	const enum FormatConvSpec_Int convspec = itemfmt->convspec;
+	const uint64_t a_lo = a & 0xFFFFFFFFu;
+	const uint64_t a_hi = a >> 32u;
+	const uint64_t b_lo = b & 0xFFFFFFFFu;
+	const uint64_t b_hi = b >> 32u;
+	const uint64_t b00  = a_lo * b_lo;
+	const uint64_t mid  = a_hi * b_lo + (b00 >> 32u);
+	const uint64_t lo   = a_lo * b_hi + (mid & 0xFFFFFFFFu);
+
+	*hi = a_hi * b_hi + (mid >> 32u) + (lo >> 32u);
+	return (lo << 32u) | (b00 & 0xFFFFFFFFu);
+}
+#endif
 
-	size_t retval = 0;
+/* returns '(m * mul) >> j', where 'mul' is {low, high} and 64 < j < 128 */
+static uint64_t
+d2s_mulshift(uint64_t m, const uint64_t mul[2u], int32_t j)
+/*@*/
+{
+#ifdef HAVE_UINT128
+	const UInt128 b0 = (UInt128) m * mul[0u];
+	const UInt128 b2 = (UInt128) m * mul[1u];
 
-	if ( (flags & FORMATFLAG_ALTFORM_C) != 0 ){
-		retval = printf_flag_sigil_int_c(dest, convspec);
+	return (uint64_t) (((b0 >> 64u) + b2) >> (uint32_t) (j - 64));
+#else
+	uint64_t high0, low1, high1, sum;
+
+	(void) d2s_umul128(m, mul[0u], &high0);
+	low1 = d2s_umul128(m, mul[1u], &high1);
+
+	sum = high0 + low1;
+	if ( sum < high0 ){
+		++high1;
 	}
-	else if ( (flags & FORMATFLAG_ALTFORM_M) != 0 ){
-		retval = printf_flag_sigil_int_m(dest, convspec);
+	j -= 64;
+	return (high1 << (uint32_t) (64 - j)) | (sum >> (uint32_t) j);
+#endif
+}
+
+/* returns the shortest decimal significand that reads back as the double
+   with these fields, and sets '*exp10' to its power of ten */
+/* 'mantissa' and 'exponent' are for a finite, non-zero value */
+static uint64_t
+d2s_shortest(uint64_t mantissa, uint32_t exponent, /*@out@*/ int32_t *exp10)
+/*@modifies	*exp10@*/
+{
+	const uint64_t *mul;
+	uint64_t m2, mv, vr, vp, vm, output;
+	int32_t e2, q, k, i, removed = 0;
+	uint32_t mm_shift;
+	int accept_bounds, vm_zeros = FALSE, vr_zeros = FALSE, round_up;
+	unsigned int last_removed = 0;
+
+	if ( exponent == 0 ){
+		e2 = 1 - D2S_BIAS - (int32_t) D2S_MANTISSA_BITS - 2;
+		m2 = mantissa;
+	}
+	else {	e2 = (int32_t) exponent - D2S_BIAS
+			- (int32_t) D2S_MANTISSA_BITS - 2;
+		m2 = (UINT64_C(1) << D2S_MANTISSA_BITS) | mantissa;
+	}
+	accept_bounds = (int) ((m2 & 1u) == 0);
+
+	/* the value and the halfway points to its neighbors, times 4 */
+	mv       = 4u * m2;
+	mm_shift = (uint32_t) ((mantissa != 0) || (exponent <= 1u));
+
+	/* scale all three to decimal, keeping whether the (exact) products
+	   would have trailing zeros that got cut off */
+	if ( e2 >= 0 ){
+		q   = d2s_log10pow2(e2) - (int32_t) (e2 > 3);
+		*exp10 = q;
+		k   = D2S_POW5_INV_BITCOUNT + d2s_pow5bits(q) - 1;
+		i   = -e2 + q + k;
+		mul = d2s_pow5_inv_split[q];
+		vr  = d2s_mulshift(4u * m2, mul, i);
+		vp  = d2s_mulshift(4u * m2 + 2u, mul, i);
+		vm  = d2s_mulshift(4u * m2 - 1u - mm_shift, mul, i);
+		if ( q <= 21 ){
+			/* only one of mp, mv, and mm can be a multiple of 5 */
+			if ( mv % 5u == 0 ){
+				vr_zeros = d2s_multiple_of_pow5(mv, q);
+			}
+			else if ( accept_bounds != 0 ){
+				vm_zeros = d2s_multiple_of_pow5(
+					mv - 1u - mm_shift, q
+				);
+			}
+			else {	vp -= (uint64_t) d2s_multiple_of_pow5(
+					mv + 2u, q
+				);
+			}
+		}
+	}
+	else {	q   = d2s_log10pow5(-e2) - (int32_t) (-e2 > 1);
+		*exp10 = q + e2;
+		i   = -e2 - q;
+		k   = d2s_pow5bits(i) - D2S_POW5_BITCOUNT;
+		mul = d2s_pow5_split[i];
+		vr  = d2s_mulshift(4u * m2, mul, q - k);
+		vp  = d2s_mulshift(4u * m2 + 2u, mul, q - k);
+		vm  = d2s_mulshift(4u * m2 - 1u - mm_shift, mul, q - k);
+		if ( q <= 1 ){
+			/* mv has at least q trailing 0 bits (it is 4 * m2) */
+			vr_zeros = TRUE;
+			if ( accept_bounds != 0 ){
+				vm_zeros = (int) (mm_shift == 1u);
+			}
+			else {	--vp; }
+		}
+		else if ( q < 63 ){
+			vr_zeros = d2s_multiple_of_pow2(mv, q);
+		}
+		else {;}
 	}
-	else {	assert(FALSE); }
 
-	/*@-mustdefine@*/
-	return retval;
-	/*@-mustdefine@*/
+	/* drop digits while the interval still tells them apart */
+	if ( (vm_zeros != 0) || (vr_zeros != 0) ){
+		/* rare: exact ties */
+		while ( vp / 10u > vm / 10u ){
+			vm_zeros    &= (int) (vm % 10u == 0);
+			vr_zeros    &= (int) (last_removed == 0);
+			last_removed = (unsigned int) (vr % 10u);
+			vr /= 10u;
+			vp /= 10u;
+			vm /= 10u;
+			++removed;
+		}
+		if ( vm_zeros != 0 ){
+			while ( vm % 10u == 0 ){
+				vr_zeros    &= (int) (last_removed == 0);
+				last_removed = (unsigned int) (vr % 10u);
+				vr /= 10u;
+				vp /= 10u;
+				vm /= 10u;
+				++removed;
+			}
+		}
+		if ( (vr_zeros != 0) && (last_removed == 5u)
+		&&   (vr % 2u == 0)
+		){
+			last_removed = 4u;	/* round half to even */
+		}
+		output = vr + (uint64_t) (
+			(  (vr == vm)
+			 && ((accept_bounds == 0) || (vm_zeros == 0))
+			)
+		||
+			(last_removed >= 5u)
+		);
+	}
+	else {	/* common: no ties, so only the last removed digit matters */
+		round_up = FALSE;
+		if ( vp / 100u > vm / 100u ){
+			round_up = (int) (vr % 100u >= 50u);
+			vr /= 100u;
+			vp /= 100u;
+			vm /= 100u;
+			removed += 2;
+		}
+		while ( vp / 10u > vm / 10u ){
+			round_up = (int) (vr % 10u >= 5u);
+			vr /= 10u;
+			vp /= 10u;
+			vm /= 10u;
+			++removed;
+		}
+		output = vr + (uint64_t) ((vr == vm) || (round_up != 0));
+	}
+
+	*exp10 += removed;
+	return output;
 }
 
 /* ------------------------------------------------------------------------ */
 
-/* returns the number of bytes written to the buffer */
+/* returns the number of chars written to 'dest' */
+/* 'g': like %g's style, with Python's repr() cutoffs (1e-04 to 1e+15);
+   'e': always scientific */
 static size_t
-printf_put_repchar(
-	struct ASSPF_WriteBuf *writebuf, char c, size_t count
+d2s_format(
+	/*@out@*/ char *dest, uint64_t significand, int32_t exp10,
+	int scientific
 )
-/*@globals	fileSystem@*/
-/*@modifies	fileSystem,
-		*writebuf
-@*/
+/*@modifies	*dest@*/
 {
-	char cbuf[64u];
-	size_t size = sizeof cbuf;
-	size_t retval = 0;
-
-	memset(cbuf, (int) c, sizeof cbuf);
-
-	do {	size = (count > size ? size : count);
-		for ( ; count >= size; count -= size ){
-			retval += asspf_write(writebuf, cbuf, size);
+	const size_t n = ndigits_dec((uintmax_t) significand);
+	const int32_t e = exp10 + (int32_t) n - 1;	/* of the first digit */
+	size_t len;
+	int32_t e_abs;
+
+	if ( (scientific == 0) && (e >= -4) && (e < 16) ){
+		if ( e < 0 ){
+			/* 0.00123 */
+			len = (size_t) -e + 1u;
+			(void) memset(dest, (int) '0', len);
+			dest[1u] = '.';
+			(void) printf_w2b_u(&dest[len], n, significand);
+			return len + n;
 		}
-	} while ( count != 0 );
+		len = (size_t) e + 1u;
+		if ( len >= n ){
+			/* 12300 */
+			(void) printf_w2b_u(dest, n, significand);
+			(void) memset(&dest[n], (int) '0', len - n);
+			return len;
+		}
+		/* 12.3 */
+		(void) printf_w2b_u(&dest[1u], n, significand);
+		(void) memmove(dest, &dest[1u], len);
+		dest[len] = '.';
+		return n + 1u;
+	}
 
-	return retval;
+	/* 1.23e+04 */
+	(void) printf_w2b_u(&dest[1u], n, significand);
+	dest[0u] = dest[1u];
+	len = (size_t) 1u;
+	if ( n > 1u ){
+		dest[1u] = '.';
+		len = n + 1u;
+	}
+	dest[len++] = 'e';
+	dest[len++] = (e < 0 ? '-' : '+');
+	e_abs = (e < 0 ? -e : e);
+	if ( e_abs >= 100 ){
+		dest[len++] = (char) ('0' + (char) (e_abs / 100));
+	}
+	(void) memcpy(
+		&dest[len], &digit_pairs[2 * (e_abs % 100)], (size_t) 2u
+	);
+	return len + 2u;
 }
 
 /* ------------------------------------------------------------------------ */
 
-/* returns the number of bytes written to the writebuf */
+/* returns the number of bytes processed, or SIZE_MAX on error */
+/* flags, field width, then 'g' or 'e' */
 static size_t
-printf_int_body(
-	struct ASSPF_WriteBuf *writebuf, const struct ItemFormat_Int *itemfmt,
-	uintmax_t value, const size_t value_size
+format_scan_double(
+	/*@out@*/ struct ItemFormat_Int *itemfmt, /*@out@*/ int *scientific,
+	const char *format, size_t format_len
 )
-/*@globals	fileSystem@*/
-/*@modifies	fileSystem,
-		*writebuf
+/*@modifies	*itemfmt,
+		*scientific
 @*/
 {
-	size_t retval = 0;
-	char   digit_buf[CHAR_BIT * (sizeof value)];	/* %b uintmax_t */
-	size_t ndigits_max;
-	unsigned int ndigits;
-	char   sigil_buf[2u];
-	size_t sigil_size = 0;
-	char   sign_c;
-	size_t sign_size = 0;
-	unsigned int precision_pad = 0;
-	size_t printed_size;
-	int    adjust_type = 0;	/* 0: none, >0: right <0: left */
-	size_t adjust_size = 0;
-	char   adjust_c = '\0';	/* only for right adjustment */
-	DEBUG_ONLY size_t result;
-
-	assert((value_size != 0) && (value_size <= sizeof value));
+	size_t       format_idx        = 0;
+	unsigned int format_flags      = FORMATFLAG_NONE;
+	unsigned int format_fieldwidth = FORMATFIELDWIDTH_UNSET;
 
-	#define PRINTFINT_WRITE_SIGIL { \
-		if ( sigil_size != 0 ){ \
-			retval += asspf_write( \
-				writebuf, sigil_buf, sigil_size \
-			); \
-		} \
-	}
-	#define PRINTFINT_WRITE_SIGN { \
-		if ( (itemfmt->convspec == FORMATCONVSPEC_INT_d) \
-		    && \
-		     (sign_size != 0) \
-		){ \
-			retval += asspf_write( \
-				writebuf, &sign_c, sizeof sign_c \
-			); \
-		} \
+	FORMATSCAN(format_scan_flags, format_flags);
+	FORMATSCAN(format_scan_fieldwidth, format_fieldwidth);
+	if UNLIKELY ( (format_flags & FORMATFLAG_ALTFORM_ALL) != 0 ){
+		FORMATREAD_ERROR;
 	}
 
-	/* maximum number of digit_buf bytes to use */
-	ndigits_max = printf_ndigits_max(value_size, itemfmt->convspec);
-	assert(ndigits_max != 0);
-
-	/* base number */
-	switch ( itemfmt->convspec ){
-	case FORMATCONVSPEC_INT_UNSET:
-		assert(FALSE);
-		break;
-	case FORMATCONVSPEC_INT_d:
-		value  = (uintmax_t) printf_read_raw_d(value, value_size);
-		sign_c = ((intmax_t) value < 0 ? '-' : '+');
-		value  = abs_imax((intmax_t) value);
-		/*@fallthrough@*/
-	case FORMATCONVSPEC_INT_u:
-		result = printf_w2b_u(digit_buf, ndigits_max, value);
-		assert(result == ndigits_max);
-		break;
-	case FORMATCONVSPEC_INT_b:
-		result = printf_w2b_b(digit_buf, ndigits_max, value);
-		assert(result == ndigits_max);
-		break;
-	case FORMATCONVSPEC_INT_o:
-		result = printf_w2b_o(digit_buf, ndigits_max, value);
-		assert(result == ndigits_max);
-		break;
-	case FORMATCONVSPEC_INT_x:
-		result = printf_w2b_x(digit_buf, ndigits_max, value);
-		assert(result == ndigits_max);
+	CHECK_FORMATBUF;
+	switch ( format[format_idx] ){
+	case 'g':
+		*scientific = FALSE;
 		break;
-	case FORMATCONVSPEC_INT_X:
-		result = printf_w2b_X(digit_buf, ndigits_max, value);
-		assert(result == ndigits_max);
+	case 'e':
+		*scientific = TRUE;
 		break;
+	default:
+		FORMATREAD_ERROR;
 	}
+	format_idx += 1u;
 
-	/* altform sigil */
-	assert(sigil_size == 0);
-	if ( (itemfmt->flags & FORMATFLAG_ALTFORM_ALL) != 0 ){
-		sigil_size = printf_flag_sigil_int(sigil_buf, itemfmt);
-	}
+	*itemfmt = itemformat_int_get(
+		format_flags, format_fieldwidth, FORMATPRECISION_UNSET,
+		FORMATSCALE_UNSET, FORMATCONVSPEC_INT_UNSET
+	);
+	return format_idx;
+}
 
-	/* sign ('-', '+', or ' ') */
-	assert(sign_size == 0);
-	if ( itemfmt->convspec == FORMATCONVSPEC_INT_d ){
-		switch ( sign_c ){
-		default:
-			assert(FALSE);
-			break;
-		case '-':
-			sign_size = (size_t) 1u;
-			break;
-		case '+':
-			if ( (itemfmt->flags & FORMATFLAG_ALWAYS_SIGN) != 0 ){
-				sign_size = (size_t) 1u;
-				break;
-			}
-			if ( (itemfmt->flags & FORMATFLAG_BLANK_SIGN) != 0 ){
-				sign_c    = ' ';
-				sign_size = (size_t) 1u;
-				break;
-			}
-			break;
+/* returns the number of bytes the printf-double will take up */
+/* lays it out like an integer, so printf_int_emit/put() can print it */
+static size_t
+printf_double_layout(
+	/*@out@*/ struct PrintfInt_Layout *layout,
+	const struct ItemFormat_Int *itemfmt, int scientific, double value
+)
+/*@modifies	*layout@*/
+{
+	uint64_t bits, mantissa, significand;
+	uint32_t exponent;
+	int32_t exp10;
+	int negative, finite = TRUE;
+	size_t printed_size;
+
+	(void) memcpy(&bits, &value, sizeof bits);
+	negative = (int) ((bits >> 63u) != 0);
+	exponent = (uint32_t) (bits >> D2S_MANTISSA_BITS) & D2S_EXPONENT_MASK;
+	mantissa = bits & ((UINT64_C(1) << D2S_MANTISSA_BITS) - 1u);
+
+	layout->digit_idx     = 0;
+	layout->value         = 0;
+	layout->value_ndigits = 0;
+	layout->value_convspec = itemfmt->convspec;
+	if ( exponent == D2S_EXPONENT_MASK ){
+		finite = FALSE;
+		if ( mantissa != 0 ){
+			(void) memcpy(layout->digit_buf, "nan", (size_t) 3u);
+			negative = FALSE;
 		}
+		else {	(void) memcpy(layout->digit_buf, "inf", (size_t) 3u); }
+		layout->ndigits = (size_t) 3u;
+	}
+	else if ( (exponent == 0) && (mantissa == 0) ){
+		layout->ndigits = d2s_format(
+			layout->digit_buf, 0, 0, scientific
+		);
+	}
+	else {	significand = d2s_shortest(mantissa, exponent, &exp10);
+		layout->ndigits = d2s_format(
+			layout->digit_buf, significand, exp10, scientific
+		);
 	}
 
-	/* precision calculation */
-	ndigits = (unsigned int) printf_ndigits_base(digit_buf, ndigits_max);
-	if ( itemfmt->precision == FORMATPRECISION_NATURAL ){
-		ndigits = (unsigned int) ndigits_max;
+	/* sign ('-', '+', or ' ') */
+	layout->sign_c    = '-';
+	layout->sign_size = 0;
+	if ( negative != 0 ){
+		layout->sign_size = (size_t) 1u;
 	}
-	else if ( itemfmt->precision > ndigits ){
-		ndigits = itemfmt->precision;
-		if ( itemfmt->precision > (unsigned int) ndigits_max ){
-			ndigits       = (unsigned int) ndigits_max;
-			precision_pad =	itemfmt->precision - ndigits;
-		}
-	} else{;}
+	else if ( (itemfmt->flags & FORMATFLAG_ALWAYS_SIGN) != 0 ){
+		layout->sign_c    = '+';
+		layout->sign_size = (size_t) 1u;
+	}
+	else if ( (itemfmt->flags & FORMATFLAG_BLANK_SIGN) != 0 ){
+		layout->sign_c    = ' ';
+		layout->sign_size = (size_t) 1u;
+	}
+	else {;}
 
+	layout->sigil_size	= 0;
+	layout->precision_pad	= 0;
+	layout->adjust_type	= 0;
+	layout->adjust_size	= 0;
+	layout->adjust_c	= '\0';
 
-	/* pre-adjustment calculations */
-	printed_size = sigil_size + sign_size + precision_pad + ndigits;
+	printed_size = layout->sign_size + layout->ndigits;
 	if ( printed_size < (size_t) itemfmt->fieldwidth ){
-		adjust_type = ((itemfmt->flags & FORMATFLAG_LEFT_ADJUST) == 0
-			? 1 : -1
+		layout->adjust_type = (
+			(itemfmt->flags & FORMATFLAG_LEFT_ADJUST) == 0 ? 1 : -1
 		);
-		adjust_size = ((size_t) itemfmt->fieldwidth) - printed_size;
-		adjust_c    = ((itemfmt->flags & FORMATFLAG_ZERO_PAD) == 0
+		layout->adjust_size = (
+			((size_t) itemfmt->fieldwidth) - printed_size
+		);
+		layout->adjust_c    = (
+			((itemfmt->flags & FORMATFLAG_ZERO_PAD) == 0)
+			||
+			(finite == 0)
 			? ' ' : '0'
 		);
+		printed_size = (size_t) itemfmt->fieldwidth;
 	}
 
-	/* ----------- */
+	return printed_size;
+}
 
-	/* sigil & sign 1 */
-	if ( (adjust_type > 0) && (adjust_c == '0') ){
-		PRINTFINT_WRITE_SIGIL;
-		PRINTFINT_WRITE_SIGN;
-	}
-	/* right adjustment */
-	if ( adjust_type > 0 ){
-		retval += printf_put_repchar(writebuf, adjust_c, adjust_size);
-	}
-	/* sigil & sign 2 */
-	if ( (adjust_type <= 0) || (adjust_c == ' ') ){
-		PRINTFINT_WRITE_SIGIL;
-		PRINTFINT_WRITE_SIGN;
-	}
-	/* precision padding */
-	if ( precision_pad != 0 ){
-		retval += printf_put_repchar(
-			writebuf, '0', (size_t) precision_pad
-		);
-	}
-	/* base */
-	retval += asspf_write(
-		writebuf, &digit_buf[ndigits_max - ndigits], (size_t) ndigits
-	);
-	/* left adjustment */
-	if ( adjust_type < 0 ){
-		retval += printf_put_repchar(writebuf, ' ', adjust_size);
+/* ------------------------------------------------------------------------ */
+
+/* returns the number of bytes written to the writebuf */
+size_t
+asspf_printf_double(
+	struct ASSPF_WriteBuf *writebuf, const char *format, double value
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+{
+	const size_t format_len = strlen(format);
+	struct ItemFormat_Int itemfmt;
+	struct PrintfInt_Layout layout;
+	int scientific;
+	size_t size;
+
+	size = format_scan_double(&itemfmt, &scientific, format, format_len);
+	if UNLIKELY ( size != format_len ){
+		STATS_ADD(writebuf, nformat_errors, 1u);
+		return 0;
 	}
 
-	return retval;
+	size = printf_double_layout(&layout, &itemfmt, scientific, value);
+	return printf_int_write(writebuf, &layout, size);
 }
 
 /* //////////////////////////////////////////////////////////////////////// */
 
+#endif	/* ASSPF_OPT_NO_FLOAT */
+
+/* //////////////////////////////////////////////////////////////////////// */
+
 #endif	/* ASSPF_OPT_NO_PRINTF */
 
 /* EOF //////////////////////////////////////////////////////////////////// */
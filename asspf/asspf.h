@@ -42,12 +42,117 @@
 struct X_ASSPF_WriteBuf {
 	/*@temp@*/
 	char		*x_0;
-	unsigned short	 x_1;
-	unsigned short	 x_2;
+	size_t		 x_1;
+	size_t		 x_2;
 	int		 x_3;
+	/*@null@*/ /*@dependent@*/
+	void		*x_4;
+	int		 x_5;
+	unsigned int	 x_6;
+	int		 x_7;
+	int		 x_8;
+	size_t		 x_9;
+#ifdef ASSPF_OPT_STATS
+	size_t		 x_10[7u];
+#endif
 };
 typedef /*@abstract@*/ struct X_ASSPF_WriteBuf	ASSPF_WriteBuf;
 
+/* flush policies (see asspf_writebuf_policy()) */
+#define ASSPF_POLICY_BLOCK	0
+#define ASSPF_POLICY_RETRY	1
+#define ASSPF_POLICY_POLL	2
+#define ASSPF_POLICY_DROP	3
+
+struct X_ASSPF_Ring {
+	size_t		 x_0;
+	char		 x_1[64u - (sizeof(size_t))];
+	size_t		 x_2;
+	char		 x_3[64u - (sizeof(size_t))];
+	/*@temp@*/
+	char		*x_4;
+	size_t		 x_5;
+	int		 x_6;
+};
+typedef /*@abstract@*/ struct X_ASSPF_Ring	ASSPF_Ring;
+
+struct X_ASSPF_SharedBuf {
+	uint64_t	 x_0;
+	char		 x_1[64u - (sizeof(uint64_t))];
+	/*@temp@*/
+	char		*x_2;
+	size_t		 x_3;
+	int		 x_4;
+};
+typedef /*@abstract@*/ struct X_ASSPF_SharedBuf	ASSPF_SharedBuf;
+
+struct X_ASSPF_Shards {
+	/*@temp@*/
+	ASSPF_SharedBuf	*x_0;
+	size_t		 x_1;
+	unsigned int	 x_2;
+	int		 x_3;
+};
+typedef /*@abstract@*/ struct X_ASSPF_Shards	ASSPF_Shards;
+
+struct X_ASSPF_MMapLog {
+	/*@temp@*/
+	void		*x_0;
+	/*@temp@*/
+	char		*x_1;
+	size_t		 x_2;
+};
+typedef /*@abstract@*/ struct X_ASSPF_MMapLog	ASSPF_MMapLog;
+
+struct ASSPF_IOVec {
+	/*@temp@*/
+	const void	*base;
+	size_t		 size;
+};
+typedef struct ASSPF_IOVec	ASSPF_IOVec;
+
+#ifdef ASSPF_OPT_STATS
+/* a WriteBuf object's counters (see asspf_writebuf_stats()) */
+struct ASSPF_Stats {
+	size_t	bytes_buffered;
+	size_t	bytes_written;
+	size_t	bytes_dropped;
+	size_t	syscalls;
+	size_t	partial_writes;
+	size_t	retries;
+	size_t	bypass_writes;
+	size_t	format_errors;
+};
+typedef struct ASSPF_Stats	ASSPF_Stats;
+#endif
+
+struct X_ASSPF_ReadBuf {
+	/*@temp@*/
+	char		*x_0;
+	size_t		 x_1;
+	size_t		 x_2;
+	size_t		 x_3;
+	int		 x_4;
+	int		 x_5;
+};
+typedef /*@abstract@*/ struct X_ASSPF_ReadBuf	ASSPF_ReadBuf;
+
+struct X_ASSPF_TimeCache {
+	uint64_t	 x_0;
+	uint64_t	 x_1;
+	uint64_t	 x_2[3u];
+};
+typedef /*@abstract@*/ struct X_ASSPF_TimeCache	ASSPF_TimeCache;
+
+/* timestamp clocks (see asspf_put_timestamp()) */
+#define ASSPF_CLOCK_REALTIME	0
+#define ASSPF_CLOCK_MONOTONIC	1
+
+/* integer parsing results (see asspf_read_u64()) */
+#define ASSPF_PARSE_OK		0
+#define ASSPF_PARSE_NONE	1
+#define ASSPF_PARSE_RANGE	2
+
 /* //////////////////////////////////////////////////////////////////////// */
 
 #undef writebuf
@@ -66,6 +171,58 @@ extern int asspf_writebuf_autoinit(
 /*@modifies	*writebuf@*/
 ;
 
+#undef writebuf
+#undef fd
+#undef buf
+#undef size
+/*@external@*/ /*@unused@*/
+extern int asspf_writebuf_autoinit_large(
+	/*@out@*/
+	ASSPF_WriteBuf *writebuf,
+	int fd,
+	/*@reldef@*/
+	char *buf,
+	size_t size
+)
+/*@modifies	*writebuf@*/
+;
+
+#undef writebuf
+#undef enable
+/*@external@*/ /*@unused@*/
+extern int asspf_writebuf_binary(ASSPF_WriteBuf *writebuf, int enable)
+/*@modifies	*writebuf@*/
+;
+
+#undef writebuf
+#undef policy
+#undef policy_arg
+/*@external@*/ /*@unused@*/
+extern int asspf_writebuf_policy(
+	ASSPF_WriteBuf *writebuf, int policy, int policy_arg
+)
+/*@modifies	*writebuf@*/
+;
+
+#undef writebuf
+/*@external@*/ /*@unused@*/
+extern size_t asspf_writebuf_dropped(const ASSPF_WriteBuf *writebuf)
+/*@*/
+;
+
+#ifdef ASSPF_OPT_STATS
+#undef writebuf
+#undef stats
+/*@external@*/ /*@unused@*/
+extern int asspf_writebuf_stats(
+	const ASSPF_WriteBuf *writebuf,
+	/*@out@*/
+	ASSPF_Stats *stats
+)
+/*@modifies	*stats@*/
+;
+#endif
+
 /* ======================================================================== */
 
 #undef fd
@@ -99,6 +256,36 @@ extern size_t asspf_write(
 @*/
 ;
 
+#undef writebuf
+#undef iov
+#undef iovcnt
+/*@external@*/ /*@unused@*/
+extern size_t asspf_writev(
+	ASSPF_WriteBuf *writebuf, const ASSPF_IOVec iov[], size_t iovcnt
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+;
+
+#undef writebuf
+#undef size
+/*@external@*/ /*@unused@*/ /*@null@*/ /*@dependent@*/
+extern char *asspf_reserve(ASSPF_WriteBuf *writebuf, size_t size)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+;
+
+#undef writebuf
+#undef size
+/*@external@*/ /*@unused@*/
+extern size_t asspf_commit(ASSPF_WriteBuf *writebuf, size_t size)
+/*@modifies	*writebuf@*/
+;
+
 #undef writebuf
 #undef s
 /*@external@*/ /*@unused@*/
@@ -119,49 +306,12 @@ extern size_t asspf_putc(ASSPF_WriteBuf *writebuf, char c)
 @*/
 ;
 
-/* ======================================================================== */
-
-#ifndef ASSPF_OPT_NO_PRINTF
-
-/* ======================================================================== */
-
-/* printf - base types */
-
-#if UINT_LEAST16_MAX != UINT_LEAST8_MAX
-#define X_ASSPS_U16LEAST_NEEDED
-#endif
-
-#if UINT_LEAST32_MAX != UINT_LEAST16_MAX
-#define X_ASSPS_U32LEAST_NEEDED
-#endif
-
-#if UINT_LEAST64_MAX != UINT_LEAST32_MAX
-#define X_ASSPS_U64LEAST_NEEDED
-#endif
-
-#if UINTMAX_MAX != UINT_LEAST8_MAX  \
- && UINTMAX_MAX != UINT_LEAST16_MAX \
- && UINTMAX_MAX != UINT_LEAST32_MAX \
- && UINTMAX_MAX != UINT_LEAST64_MAX
-#define X_ASSPS_UINTMAX_NEEDED
-#endif
-
-#if UINTPTR_MAX != UINT_LEAST8_MAX  \
- && UINTPTR_MAX != UINT_LEAST16_MAX \
- && UINTPTR_MAX != UINT_LEAST32_MAX \
- && UINTPTR_MAX != UINT_LEAST64_MAX \
- && UINTPTR_MAX != UINTMAX_MAX
-#define X_ASSPS_UINTPTR_NEEDED
-#endif
-
-/* ------------------------------------------------------------------------ */
-
 #undef writebuf
-#undef format
-#undef value
+#undef src
+#undef size
 /*@external@*/ /*@unused@*/
-extern size_t asspf_printf_int8least(
-	ASSPF_WriteBuf *writebuf, const char *format, uint_least8_t value
+extern size_t asspf_put_json_string(
+	ASSPF_WriteBuf *writebuf, const char *src, size_t size
 )
 /*@globals	fileSystem@*/
 /*@modifies	fileSystem,
@@ -169,354 +319,1341 @@ extern size_t asspf_printf_int8least(
 @*/
 ;
 
-/* ------------------------------------------------------------------------ */
-
-#ifdef X_ASSPS_U16LEAST_NEEDED
 #undef writebuf
-#undef format
-#undef value
+#undef src
+#undef size
 /*@external@*/ /*@unused@*/
-extern size_t asspf_printf_int16least(
-	ASSPF_WriteBuf *writebuf, const char *format, uint_least16_t value
+extern size_t asspf_put_c_escaped(
+	ASSPF_WriteBuf *writebuf, const char *src, size_t size
 )
 /*@globals	fileSystem@*/
 /*@modifies	fileSystem,
 		*writebuf
 @*/
 ;
-#else	/* !defined(X_ASSPS_U16LEAST_NEEDED) */
-#define asspf_printf_int16least(writebuf, format, value) \
-	asspf_printf_int8least( \
-		writebuf, format, (uint_least8_t) ((uint_least16_t) (value)) \
-	)
-#endif	/* X_ASSPS_U16LEAST_NEEDED */
-
-/* ------------------------------------------------------------------------ */
 
-#ifdef X_ASSPS_U32LEAST_NEEDED
 #undef writebuf
-#undef format
-#undef value
+#undef src_fd
+#undef max_bytes
 /*@external@*/ /*@unused@*/
-extern size_t asspf_printf_int32least(
-	ASSPF_WriteBuf *writebuf, const char *format, uint_least32_t value
+extern size_t asspf_copy_fd(
+	ASSPF_WriteBuf *writebuf, int src_fd, size_t max_bytes
 )
 /*@globals	fileSystem@*/
 /*@modifies	fileSystem,
 		*writebuf
 @*/
 ;
-#else	/* !defined(X_ASSPS_U32LEAST_NEEDED) */
-#define asspf_printf_int32least(writebuf, format, value) \
-	asspf_printf_int16least( \
-		writebuf, format, \
-		(uint_least16_t) ((uint_least32_t) (value)) \
-	)
-#endif	/* X_ASSPS_U32LEAST_NEEDED */
 
-/* ------------------------------------------------------------------------ */
+/* ======================================================================== */
 
-#ifdef X_ASSPS_U64LEAST_NEEDED
-#undef writebuf
-#undef format
-#undef value
+/* buffered reader */
+
+#undef readbuf
+#undef fd
+#undef buf
+#undef size
 /*@external@*/ /*@unused@*/
-extern size_t asspf_printf_int64least(
-	ASSPF_WriteBuf *writebuf, const char *format, uint_least64_t value
+extern int asspf_readbuf_autoinit(
+	/*@out@*/
+	ASSPF_ReadBuf *readbuf,
+	int fd,
+	/*@reldef@*/
+	char *buf,
+	size_t size
+)
+/*@modifies	*readbuf@*/
+;
+
+#undef readbuf
+#undef path
+#undef buf
+#undef size
+/*@external@*/ /*@unused@*/
+extern int asspf_readbuf_open(
+	/*@out@*/
+	ASSPF_ReadBuf *readbuf,
+	const char *path,
+	/*@reldef@*/
+	char *buf,
+	size_t size
 )
 /*@globals	fileSystem@*/
 /*@modifies	fileSystem,
-		*writebuf
+		*readbuf
 @*/
 ;
-#else	/* !defined(X_ASSPS_U64LEAST_NEEDED) */
-#define asspf_printf_int64least(writebuf, format value) \
-	asspf_printf_int32least( \
-		writebuf, format, \
-		(uint_least32_t) ((uint_least64_t) (value)) \
-	)
-#endif	/* X_ASSPS_U64LEAST_NEEDED */
 
-/* ------------------------------------------------------------------------ */
+#undef readbuf
+/*@external@*/ /*@unused@*/
+extern int asspf_readbuf_close(ASSPF_ReadBuf *readbuf)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*readbuf
+@*/
+;
 
-#ifdef X_ASSPS_UINTMAX_NEEDED
-#undef writebuf
-#undef format
-#undef value
+#undef readbuf
+#undef dest
+#undef size
 /*@external@*/ /*@unused@*/
-extern size_t asspf_printf_intmax(
-	ASSPF_WriteBuf *writebuf, const char *format, uintmax_t value
+extern size_t asspf_read(
+	ASSPF_ReadBuf *readbuf,
+	/*@out@*/
+	void *dest,
+	size_t size
 )
 /*@globals	fileSystem@*/
 /*@modifies	fileSystem,
-		*writebuf
+		*readbuf,
+		*dest
 @*/
 ;
-#else	/* !defined(X_ASSPS_UINTMAX_NEEDED) */
-#if   UINTMAX_MAX == UINT_LEAST8_MAX
-#define asspf_printf_intmax(writebuf, format, value) \
-	asspf_printf_int8least(writebuf, format, (uint_least8_t) (value))
-#elif UINTMAX_MAX == UINT_LEAST16_MAX
-#define asspf_printf_intmax(writebuf, format, value) \
-	asspf_printf_int16least(writebuf, format, (uint_least16_t) (value))
-#elif UINTMAX_MAX == UINT_LEAST32_MAX
-#define asspf_printf_intmax(writebuf, format, value) \
-	asspf_printf_int32least(writebuf, format, (uint_least32_t) (value))
-#elif UINTMAX_MAX == UINT_LEAST64_MAX
-#define asspf_printf_intmax(writebuf, format, value) \
-	asspf_printf_int64least(writebuf, format, (uint_least64_t) (value))
-#else
-#error "asspf_printf_intmax()"
-#endif
-#endif /* X_ASSPS_UINTMAX_NEEDED */
 
-/* ------------------------------------------------------------------------ */
+#undef readbuf
+#undef len
+/*@external@*/ /*@unused@*/ /*@null@*/ /*@dependent@*/
+extern char *asspf_readline(
+	ASSPF_ReadBuf *readbuf,
+	/*@out@*/
+	size_t *len
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*readbuf,
+		*len
+@*/
+;
 
-#ifdef X_ASSPS_UINTPTR_NEEDED
-#undef writebuf
-#undef format
-#undef value
+#undef readbuf
+#undef len
+/*@external@*/ /*@unused@*/ /*@null@*/ /*@dependent@*/
+extern char *asspf_readtoken(
+	ASSPF_ReadBuf *readbuf,
+	/*@out@*/
+	size_t *len
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*readbuf,
+		*len
+@*/
+;
+
+#undef readbuf
+#undef base
+#undef dest
 /*@external@*/ /*@unused@*/
-extern size_t asspf_printf_intptr(
-	ASSPF_WriteBuf *writebuf, const char *format, uintptr_t value
+extern int asspf_read_u64(
+	ASSPF_ReadBuf *readbuf,
+	int base,
+	/*@out@*/
+	uint_least64_t *dest
 )
 /*@globals	fileSystem@*/
 /*@modifies	fileSystem,
-		*writebuf
+		*readbuf,
+		*dest
 @*/
 ;
-#else	/* !defined(X_ASSPS_UINTPTR_NEEDED) */
-#if   UINTPTR_MAX == UINT_LEAST16_MAX
-#define asspf_printf_intptr(writebuf, format, (uint_least16_t) (value)) \
-	asspf_printf_int16least(writebuf, format, value)
-#elif UINTPTR_MAX == UINT_LEAST32_MAX
-#define asspf_printf_intptr(writebuf, format, value) \
-	asspf_printf_int32least(writebuf, format, (uint_least32_t) (value))
-#elif UINTPTR_MAX == UINT_LEAST64_MAX
-#define asspf_printf_intptr(writebuf, format, value) \
-	asspf_printf_int64least(writebuf, format, (uint_least64_t) (value))
+
+#undef readbuf
+#undef base
+#undef dest
+/*@external@*/ /*@unused@*/
+extern int asspf_read_i64(
+	ASSPF_ReadBuf *readbuf,
+	int base,
+	/*@out@*/
+	int_least64_t *dest
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*readbuf,
+		*dest
+@*/
+;
+
+/* ======================================================================== */
+
+/* timestamps */
+
+#undef writebuf
+#undef clock_id
+#undef sec
+#undef nsec
+#undef cache
+/*@external@*/ /*@unused@*/
+extern size_t asspf_put_time(
+	ASSPF_WriteBuf *writebuf,
+	int clock_id,
+	int_least64_t sec,
+	long nsec,
+	/*@null@*/
+	ASSPF_TimeCache *cache
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf,
+		*cache
+@*/
+;
+
+#undef writebuf
+#undef clock_id
+#undef cache
+/*@external@*/ /*@unused@*/
+extern size_t asspf_put_timestamp(
+	ASSPF_WriteBuf *writebuf,
+	int clock_id,
+	/*@null@*/
+	ASSPF_TimeCache *cache
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		*writebuf,
+		*cache
+@*/
+;
+
+/* ======================================================================== */
+
+/* SPSC ring sink */
+
+#undef ring
+#undef buf
+#undef size
+#undef wake_fd
+/*@external@*/ /*@unused@*/
+extern int asspf_ring_init(
+	/*@out@*/
+	ASSPF_Ring *ring,
+	/*@reldef@*/
+	char *buf,
+	size_t size,
+	int wake_fd
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*ring
+@*/
+;
+
+#undef writebuf
+#undef ring
+#undef buf
+#undef size
+/*@external@*/ /*@unused@*/
+extern int asspf_writebuf_autoinit_ring(
+	/*@out@*/
+	ASSPF_WriteBuf *writebuf,
+	ASSPF_Ring *ring,
+	/*@reldef@*/
+	char *buf,
+	size_t size
+)
+/*@modifies	*writebuf@*/
+;
+
+#undef ring
+#undef fd
+/*@external@*/ /*@unused@*/
+extern size_t asspf_ring_drain(ASSPF_Ring *ring, int fd)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*ring
+@*/
+;
+
+/* ======================================================================== */
+
+/* multi-writer shared buffer */
+
+#undef sharedbuf
+#undef fd
+#undef buf
+#undef limit
+/*@external@*/ /*@unused@*/
+extern int asspf_sharedbuf_init(
+	/*@out@*/
+	ASSPF_SharedBuf *sharedbuf,
+	int fd,
+	/*@reldef@*/
+	char *buf,
+	size_t limit
+)
+/*@modifies	*sharedbuf@*/
+;
+
+#undef writebuf
+#undef sharedbuf
+#undef buf
+#undef limit
+/*@external@*/ /*@unused@*/
+extern int asspf_writebuf_autoinit_shared(
+	/*@out@*/
+	ASSPF_WriteBuf *writebuf,
+	ASSPF_SharedBuf *sharedbuf,
+	/*@reldef@*/
+	char *buf,
+	size_t limit
+)
+/*@modifies	*writebuf@*/
+;
+
+#undef sharedbuf
+#undef src
+#undef size
+/*@external@*/ /*@unused@*/
+extern size_t asspf_shared_write(
+	ASSPF_SharedBuf *sharedbuf, const void *src, size_t size
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*sharedbuf
+@*/
+;
+
+#undef sharedbuf
+/*@external@*/ /*@unused@*/
+extern size_t asspf_shared_flush(ASSPF_SharedBuf *sharedbuf)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*sharedbuf
+@*/
+;
+
+/* ======================================================================== */
+
+/* per-CPU shards */
+
+#undef shards
+#undef fd
+#undef shard
+#undef nshards
+#undef buf
+#undef shard_limit
+/*@external@*/ /*@unused@*/
+extern int asspf_shards_init(
+	/*@out@*/
+	ASSPF_Shards *shards,
+	int fd,
+	/*@out@*/
+	ASSPF_SharedBuf shard[],
+	size_t nshards,
+	/*@reldef@*/
+	char *buf,
+	size_t shard_limit
+)
+/*@modifies	*shards,
+		shard[]
+@*/
+;
+
+#undef writebuf
+#undef shards
+#undef buf
+#undef limit
+/*@external@*/ /*@unused@*/
+extern int asspf_writebuf_autoinit_shards(
+	/*@out@*/
+	ASSPF_WriteBuf *writebuf,
+	ASSPF_Shards *shards,
+	/*@reldef@*/
+	char *buf,
+	size_t limit
+)
+/*@modifies	*writebuf@*/
+;
+
+#undef shards
+#undef src
+#undef size
+/*@external@*/ /*@unused@*/
+extern size_t asspf_shards_write(
+	ASSPF_Shards *shards, const void *src, size_t size
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*shards
+@*/
+;
+
+#undef shards
+#undef writebuf
+#undef scratch
+#undef scratch_size
+/*@external@*/ /*@unused@*/
+extern size_t asspf_shards_drain(
+	ASSPF_Shards *shards,
+	ASSPF_WriteBuf *writebuf,
+	/*@out@*/
+	char *scratch,
+	size_t scratch_size
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*shards,
+		*writebuf,
+		*scratch
+@*/
+;
+
+/* ======================================================================== */
+
+/* memory-mapped crash log */
+
+#undef mmaplog
+#undef map
+#undef map_size
+/*@external@*/ /*@unused@*/
+extern int asspf_mmaplog_init(
+	/*@out@*/
+	ASSPF_MMapLog *mmaplog,
+	void *map,
+	size_t map_size
+)
+/*@modifies	*mmaplog,
+		*map
+@*/
+;
+
+#undef writebuf
+#undef mmaplog
+#undef buf
+#undef limit
+/*@external@*/ /*@unused@*/
+extern int asspf_writebuf_autoinit_mmaplog(
+	/*@out@*/
+	ASSPF_WriteBuf *writebuf,
+	ASSPF_MMapLog *mmaplog,
+	/*@reldef@*/
+	char *buf,
+	size_t limit
+)
+/*@modifies	*writebuf@*/
+;
+
+#undef mmaplog
+#undef src
+#undef size
+/*@external@*/ /*@unused@*/
+extern size_t asspf_mmaplog_write(
+	ASSPF_MMapLog *mmaplog, const void *src, size_t size
+)
+/*@modifies	*mmaplog@*/
+;
+
+/* ======================================================================== */
+
+#ifndef ASSPF_OPT_NO_PRINTF
+
+/* ======================================================================== */
+
+/* printf - base types */
+
+#if UINT_LEAST16_MAX != UINT_LEAST8_MAX
+#define X_ASSPS_U16LEAST_NEEDED
+#endif
+
+#if UINT_LEAST32_MAX != UINT_LEAST16_MAX
+#define X_ASSPS_U32LEAST_NEEDED
+#endif
+
+#if UINT_LEAST64_MAX != UINT_LEAST32_MAX
+#define X_ASSPS_U64LEAST_NEEDED
+#endif
+
+#if UINTMAX_MAX != UINT_LEAST8_MAX  \
+ && UINTMAX_MAX != UINT_LEAST16_MAX \
+ && UINTMAX_MAX != UINT_LEAST32_MAX \
+ && UINTMAX_MAX != UINT_LEAST64_MAX
+#define X_ASSPS_UINTMAX_NEEDED
+#endif
+
+#if UINTPTR_MAX != UINT_LEAST8_MAX  \
+ && UINTPTR_MAX != UINT_LEAST16_MAX \
+ && UINTPTR_MAX != UINT_LEAST32_MAX \
+ && UINTPTR_MAX != UINT_LEAST64_MAX \
+ && UINTPTR_MAX != UINTMAX_MAX
+#define X_ASSPS_UINTPTR_NEEDED
+#endif
+
+/* ------------------------------------------------------------------------ */
+
+#undef writebuf
+#undef format
+#undef value
+/*@external@*/ /*@unused@*/
+extern size_t asspf_printf_int8least(
+	ASSPF_WriteBuf *writebuf, const char *format, uint_least8_t value
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+;
+
+/* ------------------------------------------------------------------------ */
+
+#ifdef X_ASSPS_U16LEAST_NEEDED
+#undef writebuf
+#undef format
+#undef value
+/*@external@*/ /*@unused@*/
+extern size_t asspf_printf_int16least(
+	ASSPF_WriteBuf *writebuf, const char *format, uint_least16_t value
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+;
+#else	/* !defined(X_ASSPS_U16LEAST_NEEDED) */
+#define asspf_printf_int16least(writebuf, format, value) \
+	asspf_printf_int8least( \
+		writebuf, format, (uint_least8_t) ((uint_least16_t) (value)) \
+	)
+#endif	/* X_ASSPS_U16LEAST_NEEDED */
+
+/* ------------------------------------------------------------------------ */
+
+#ifdef X_ASSPS_U32LEAST_NEEDED
+#undef writebuf
+#undef format
+#undef value
+/*@external@*/ /*@unused@*/
+extern size_t asspf_printf_int32least(
+	ASSPF_WriteBuf *writebuf, const char *format, uint_least32_t value
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+;
+#else	/* !defined(X_ASSPS_U32LEAST_NEEDED) */
+#define asspf_printf_int32least(writebuf, format, value) \
+	asspf_printf_int16least( \
+		writebuf, format, \
+		(uint_least16_t) ((uint_least32_t) (value)) \
+	)
+#endif	/* X_ASSPS_U32LEAST_NEEDED */
+
+/* ------------------------------------------------------------------------ */
+
+#ifdef X_ASSPS_U64LEAST_NEEDED
+#undef writebuf
+#undef format
+#undef value
+/*@external@*/ /*@unused@*/
+extern size_t asspf_printf_int64least(
+	ASSPF_WriteBuf *writebuf, const char *format, uint_least64_t value
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+;
+#else	/* !defined(X_ASSPS_U64LEAST_NEEDED) */
+#define asspf_printf_int64least(writebuf, format, value) \
+	asspf_printf_int32least( \
+		writebuf, format, \
+		(uint_least32_t) ((uint_least64_t) (value)) \
+	)
+#endif	/* X_ASSPS_U64LEAST_NEEDED */
+
+/* ------------------------------------------------------------------------ */
+
+#ifdef X_ASSPS_UINTMAX_NEEDED
+#undef writebuf
+#undef format
+#undef value
+/*@external@*/ /*@unused@*/
+extern size_t asspf_printf_intmax(
+	ASSPF_WriteBuf *writebuf, const char *format, uintmax_t value
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+;
+#else	/* !defined(X_ASSPS_UINTMAX_NEEDED) */
+#if   UINTMAX_MAX == UINT_LEAST8_MAX
+#define asspf_printf_intmax(writebuf, format, value) \
+	asspf_printf_int8least(writebuf, format, (uint_least8_t) (value))
+#elif UINTMAX_MAX == UINT_LEAST16_MAX
+#define asspf_printf_intmax(writebuf, format, value) \
+	asspf_printf_int16least(writebuf, format, (uint_least16_t) (value))
+#elif UINTMAX_MAX == UINT_LEAST32_MAX
+#define asspf_printf_intmax(writebuf, format, value) \
+	asspf_printf_int32least(writebuf, format, (uint_least32_t) (value))
+#elif UINTMAX_MAX == UINT_LEAST64_MAX
+#define asspf_printf_intmax(writebuf, format, value) \
+	asspf_printf_int64least(writebuf, format, (uint_least64_t) (value))
+#else
+#error "asspf_printf_intmax()"
+#endif
+#endif /* X_ASSPS_UINTMAX_NEEDED */
+
+/* ------------------------------------------------------------------------ */
+
+#ifdef X_ASSPS_UINTPTR_NEEDED
+#undef writebuf
+#undef format
+#undef value
+/*@external@*/ /*@unused@*/
+extern size_t asspf_printf_intptr(
+	ASSPF_WriteBuf *writebuf, const char *format, uintptr_t value
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+;
+#else	/* !defined(X_ASSPS_UINTPTR_NEEDED) */
+#if   UINTPTR_MAX == UINT_LEAST16_MAX
+#define asspf_printf_intptr(writebuf, format, (uint_least16_t) (value)) \
+	asspf_printf_int16least(writebuf, format, value)
+#elif UINTPTR_MAX == UINT_LEAST32_MAX
+#define asspf_printf_intptr(writebuf, format, value) \
+	asspf_printf_int32least(writebuf, format, (uint_least32_t) (value))
+#elif UINTPTR_MAX == UINT_LEAST64_MAX
+#define asspf_printf_intptr(writebuf, format, value) \
+	asspf_printf_int64least(writebuf, format, (uint_least64_t) (value))
+#else
+#define asspf_printf_intptr(writebuf, format, value) \
+	asspf_printf_intmax(writebuf, format, (uintmax_t) (value))
+#endif
+#endif /* X_ASSPS_UINTPTR_NEEDED */
+
+/* ------------------------------------------------------------------------ */
+
+/* 128-bit integers (signed ones convert, like with the others) */
+#if defined(__SIZEOF_INT128__) && (UINTMAX_MAX == UINT64_MAX) \
+ && !defined(S_SPLINT_S)
+#define ASSPF_HAVE_INT128
+__extension__ typedef unsigned __int128	ASSPF_UInt128;
+
+#undef writebuf
+#undef format
+#undef value
+/*@external@*/ /*@unused@*/
+extern size_t asspf_printf_int128(
+	ASSPF_WriteBuf *writebuf, const char *format, ASSPF_UInt128 value
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+;
+#endif	/* ASSPF_HAVE_INT128 */
+
+/* ======================================================================== */
+
+/* printf - dependent types */
+
+/* ------------------------------------------------------------------------ */
+
+#if UINT8_MAX == UINT_LEAST8_MAX
+#define asspf_printf_int8(writebuf, format, value) \
+	asspf_printf_int8least( \
+		writebuf, format, (uint_least8_t) ((value) & UINT8_MAX) \
+	)
+#endif	/* UINT8_MAX == UINT_LEAST8_MAX */
+
+#if UINT16_MAX == UINT_LEAST16_MAX
+#define asspf_printf_int16(writebuf, format, value) \
+	asspf_printf_int16least( \
+		writebuf, format, (uint_least16_t) ((value) & UINT16_MAX) \
+	)
+#endif	/* UINT16_MAX == UINT_LEAST16_MAX */
+
+#if UINT32_MAX == UINT_LEAST32_MAX
+#define asspf_printf_int32(writebuf, format, value) \
+	asspf_printf_int32least( \
+		writebuf, format, (uint_least32_t) ((value) & UINT32_MAX) \
+	)
+#endif	/* UINT32_MAX == UINT_LEAST32_MAX */
+
+#if UINT64_MAX == UINT_LEAST64_MAX
+#define asspf_printf_int64(writebuf, format, value) \
+	asspf_printf_int64least( \
+		writebuf, format, (uint_least64_t) ((value) & UINT64_MAX) \
+	)
+#endif	/* UINT64_MAX == UINT_LEAST64_MAX */
+
+/* ------------------------------------------------------------------------ */
+
+#if   UINT_FAST8_MAX == UINT_LEAST8_MAX
+#define asspf_printf_int8fast(writebuf, format, value) \
+	asspf_printf_int8least( \
+		writebuf, format, (uint_least8_t) ((uint_fast8_t) (value)) \
+	)
+#elif UINT_FAST8_MAX == UINT_LEAST16_MAX
+#define asspf_printf_int8fast(writebuf, format, value) \
+	asspf_printf_int16least( \
+		writebuf, format, (uint_least16_t) ((uint_fast8_t) (value)) \
+	)
+#elif UINT_FAST8_MAX == UINT_LEAST32_MAX
+#define asspf_printf_int8fast(writebuf, format, value) \
+	asspf_printf_int32least( \
+		writebuf, format, (uint_least32_t) ((uint_fast8_t) (value)) \
+	)
+#elif UINT_FAST8_MAX == UINT_LEAST64_MAX
+#define asspf_printf_int8fast(writebuf, format, value) \
+	asspf_printf_int64least( \
+		writebuf, format, (uint_least64_t) ((uint_fast8_t) (value)) \
+	)
+#else
+#define asspf_printf_int8fast(writebuf, format, value) \
+	asspf_printf_intmax( \
+		writebuf, format, (uintmax_t) ((uint_fast8_t) (value)) \
+	)
+#endif
+
+/* ------------------------------------------------------------------------ */
+
+#if   UINT_FAST16_MAX == UINT_LEAST16_MAX
+#define asspf_printf_int16fast(writebuf, format, value) \
+	asspf_printf_int16least( \
+		writebuf, format, (uint_least16_t) ((uint_fast16_t) (value)) \
+	)
+#elif UINT_FAST16_MAX == UINT_LEAST32_MAX
+#define asspf_printf_int16fast(writebuf, format, value) \
+	asspf_printf_int32least( \
+		writebuf, format, (uint_least32_t) ((uint_fast16_t) (value)) \
+	)
+#elif UINT_FAST16_MAX == UINT_LEAST64_MAX
+#define asspf_printf_int16fast(writebuf, format, value) \
+	asspf_printf_int64least( \
+		writebuf, format, (uint_least64_t) ((uint_fast16_t) (value)) \
+	)
+#else
+#define asspf_printf_int16fast(writebuf, format, value) \
+	asspf_printf_intmax( \
+		writebuf, format, (uintmax_t) ((uint_fast16_t) (value)) \
+	)
+#endif
+
+/* ------------------------------------------------------------------------ */
+
+#if   UINT_FAST32_MAX == UINT_LEAST32_MAX
+#define asspf_printf_int32fast(writebuf, format, value) \
+	asspf_printf_int32least( \
+		writebuf, format, (uint_least32_t) ((uint_fast32_t) (value)) \
+	)
+#elif UINT_FAST32_MAX == UINT_LEAST64_MAX
+#define asspf_printf_int32fast(writebuf, format, value) \
+	asspf_printf_int64least( \
+		writebuf, format, (uint_least64_t) ((uint_fast32_t) (value)) \
+	)
+#else
+#define asspf_printf_int32fast(writebuf, format, value) \
+	asspf_printf_intmax( \
+		writebuf, format, (uintmax_t) ((uint_fast32_t) (value)) \
+	)
+#endif
+
+/* ------------------------------------------------------------------------ */
+
+#if   UINT_FAST64_MAX == UINT_LEAST64_MAX
+#define asspf_printf_int64fast(writebuf, format, value) \
+	asspf_printf_int64least( \
+		writebuf, format, (uint_least64_t) ((uint_fast64_t) (value)) \
+	)
+#else
+#define asspf_printf_int64fast(writebuf, format, value) \
+	asspf_printf_intmax( \
+		writebuf, format, (uintmax_t) ((uint_fast64_t) (value)) \
+	)
+#endif
+
+/* ------------------------------------------------------------------------ */
+
+#if   UCHAR_MAX == UINT_LEAST8_MAX
+#define asspf_printf_char(writebuf, format, value) \
+	asspf_printf_int8least( \
+		writebuf, format, (uint_least8_t) ((unsigned char) (value)) \
+	)
+#elif UCHAR_MAX == UINT_LEAST16_MAX
+#define asspf_printf_char(writebuf, format, value) \
+	asspf_printf_int16least( \
+		writebuf, format, (uint_least16_t) ((unsigned char) (value)) \
+	)
+#elif UCHAR_MAX == UINT_LEAST32_MAX
+#define asspf_printf_char(writebuf, format, value) \
+	asspf_printf_int32least( \
+		writebuf, format, (uint_least32_t) ((unsigned char) (value)) \
+	)
+#elif UCHAR_MAX == UINT_LEAST64_MAX
+#define asspf_printf_char(writebuf, format, value) \
+	asspf_printf_int64least( \
+		writebuf, format, (uint_least64_t) ((unsigned char) (value)) \
+	)
+#else
+#define asspf_printf_char(writebuf, format, value) \
+	asspf_printf_intmax( \
+		writebuf, format, (uintmax_t) ((unsigned char) (value)) \
+	)
+#endif
+
+/* ------------------------------------------------------------------------ */
+
+#if   USHRT_MAX == UINT_LEAST16_MAX
+#define asspf_printf_short(writebuf, format, value) \
+	asspf_printf_int16least( \
+		writebuf, format, \
+		(uint_least16_t) ((unsigned short) (value)) \
+	)
+#elif USHRT_MAX == UINT_LEAST32_MAX
+#define asspf_printf_short(writebuf, format, value) \
+	asspf_printf_int32least( \
+		writebuf, format, \
+		(uint_least32_t) ((unsigned short) (value)) \
+	)
+#elif USHRT_MAX == UINT_LEAST64_MAX
+#define asspf_printf_short(writebuf, format, value) \
+	asspf_printf_int64least( \
+		writebuf, format, \
+		(uint_least64_t) ((unsigned short) (value)) \
+	)
+#else
+#define asspf_printf_short(writebuf, format, value) \
+	asspf_printf_intmax( \
+		writebuf, format, (uintmax_t) ((unsigned short) (value)) \
+	)
+#endif
+
+/* ------------------------------------------------------------------------ */
+
+#if   UINT_MAX == UINT_LEAST16_MAX
+#define asspf_printf_int(writebuf, format, value) \
+	asspf_printf_int16least( \
+		writebuf, format, (uint_least16_t) ((unsigned int) (value)) \
+	)
+#elif UINT_MAX == UINT_LEAST32_MAX
+#define asspf_printf_int(writebuf, format, value) \
+	asspf_printf_int32least( \
+		writebuf, format, (uint_least32_t) ((unsigned int) (value)) \
+	)
+#elif UINT_MAX == UINT_LEAST64_MAX
+#define asspf_printf_int(writebuf, format, value) \
+	asspf_printf_int64least( \
+		writebuf, format, (uint_least64_t) ((unsigned int) (value)) \
+	)
+#else
+#define asspf_printf_int(writebuf, format, value) \
+	asspf_printf_intmax( \
+		writebuf, format, (uintmax_t) ((unsigned int) (value)) \
+	)
+#endif
+
+/* ------------------------------------------------------------------------ */
+
+#if   ULONG_MAX == UINT_LEAST32_MAX
+#define asspf_printf_long(writebuf, format, value) \
+	asspf_printf_int32least( \
+		writebuf, format, (uint_least32_t) ((unsigned long) (value)) \
+	)
+#elif ULONG_MAX == UINT_LEAST64_MAX
+#define asspf_printf_long(writebuf, format, value) \
+	asspf_printf_int64least( \
+		writebuf, format, (uint_least64_t) ((unsigned long) (value)) \
+	)
+#else
+#define asspf_printf_long(writebuf, format, value) \
+	asspf_printf_intmax( \
+		writebuf, format, (uintmax_t) ((unsigned long) (value)) \
+	)
+#endif
+
+/* ------------------------------------------------------------------------ */
+
+#if __STDC_VERSION__ >= 199901L || defined(__GNUC__)
+#if   ULLONG_MAX == UINT_LEAST64_MAX
+#define asspf_printf_longlong(writebuf, format, value) \
+	asspf_printf_int64least( \
+		writebuf, format, \
+		(uint_least64_t) ((unsigned long long) (value)) \
+	)
+#else
+#define asspf_printf_longlong(writebuf, format, value) \
+	asspf_printf_intmax( \
+		writebuf, format, (uintmax_t) ((unsigned long long) (value)) \
+	)
+#endif
+#endif	/* __STDC_VERSION__ >= 199901L || defined(__GNUC__) */
+
+/* ------------------------------------------------------------------------ */
+
+#if   SIZE_MAX == INT_LEAST16_MAX
+#define asspf_printf_size(writebuf, format, value) \
+	asspf_printf_int16least( \
+		writebuf, format, (uint_least16_t) ((size_t) (value)) \
+	)
+#elif SIZE_MAX == INT_LEAST32_MAX
+#define asspf_printf_size(writebuf, format, value) \
+	asspf_printf_int32least( \
+		writebuf, format, (uint_least32_t) ((size_t) (value)) \
+	)
+#elif SIZE_MAX == INT_LEAST64_MAX
+#define asspf_printf_size(writebuf, format, value) \
+	asspf_printf_int64least( \
+		writebuf, format, (uint_least64_t) ((size_t) (value)) \
+	)
+#else
+#define asspf_printf_size(writebuf, format, value) \
+	asspf_printf_intmax( \
+		writebuf, format, (uintmax_t) ((size_t) (value)) \
+	)
+#endif
+
+/* ------------------------------------------------------------------------ */
+
+#if   PTRDIFF_MAX == INT_LEAST16_MAX
+#define asspf_printf_ptrdiff(writebuf, format, value) \
+	asspf_printf_int16least( \
+		writebuf, format, (uint_least16_t) ((ptrdiff_t) (value)) \
+	)
+#elif PTRDIFF_MAX == INT_LEAST32_MAX
+#define asspf_printf_ptrdiff(writebuf, format, value) \
+	asspf_printf_int32least( \
+		writebuf, format, (uint_least32_t) ((ptrdiff_t) (value)) \
+	)
+#elif PTRDIFF_MAX == INT_LEAST64_MAX
+#define asspf_printf_ptrdiff(writebuf, format, value) \
+	asspf_printf_int64least( \
+		writebuf, format, (uint_least64_t) ((ptrdiff_t) (value)) \
+	)
+#else
+#define asspf_printf_ptrdiff(writebuf, format, value) \
+	asspf_printf_intmax( \
+		writebuf, format, (uintmax_t) ((ptrdiff_t) (value)) \
+	)
+#endif
+
+/* ======================================================================== */
+
+/* printfc - compiled formats */
+
+struct X_ASSPF_Format {
+	unsigned int	x_0;
+	unsigned int	x_1;
+	unsigned int	x_2;
+	unsigned int	x_3;
+	int		x_4;
+	unsigned int	x_5;
+};
+typedef /*@abstract@*/ struct X_ASSPF_Format	ASSPF_Format;
+
+/* ------------------------------------------------------------------------ */
+
+#undef fmt
+#undef format
+/*@external@*/ /*@unused@*/
+extern int asspf_format_compile(
+	/*@out@*/
+	ASSPF_Format *fmt,
+	const char *format
+)
+/*@modifies	*fmt@*/
+;
+
+#undef fmt
+#undef format
+#undef id
+/*@external@*/ /*@unused@*/
+extern int asspf_format_compile_id(
+	/*@out@*/
+	ASSPF_Format *fmt,
+	const char *format,
+	unsigned short id
+)
+/*@modifies	*fmt@*/
+;
+
+/* ------------------------------------------------------------------------ */
+
+#undef writebuf
+#undef fmt
+#undef value
+/*@external@*/ /*@unused@*/
+extern size_t asspf_printfc_int8least(
+	ASSPF_WriteBuf *writebuf, const ASSPF_Format *fmt, uint_least8_t value
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+;
+
+/* ------------------------------------------------------------------------ */
+
+#ifdef X_ASSPS_U16LEAST_NEEDED
+#undef writebuf
+#undef fmt
+#undef value
+/*@external@*/ /*@unused@*/
+extern size_t asspf_printfc_int16least(
+	ASSPF_WriteBuf *writebuf, const ASSPF_Format *fmt, uint_least16_t value
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+;
+#else	/* !defined(X_ASSPS_U16LEAST_NEEDED) */
+#define asspf_printfc_int16least(writebuf, fmt, value) \
+	asspf_printfc_int8least( \
+		writebuf, fmt, (uint_least8_t) ((uint_least16_t) (value)) \
+	)
+#endif	/* X_ASSPS_U16LEAST_NEEDED */
+
+/* ------------------------------------------------------------------------ */
+
+#ifdef X_ASSPS_U32LEAST_NEEDED
+#undef writebuf
+#undef fmt
+#undef value
+/*@external@*/ /*@unused@*/
+extern size_t asspf_printfc_int32least(
+	ASSPF_WriteBuf *writebuf, const ASSPF_Format *fmt, uint_least32_t value
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+;
+#else	/* !defined(X_ASSPS_U32LEAST_NEEDED) */
+#define asspf_printfc_int32least(writebuf, fmt, value) \
+	asspf_printfc_int16least( \
+		writebuf, fmt, \
+		(uint_least16_t) ((uint_least32_t) (value)) \
+	)
+#endif	/* X_ASSPS_U32LEAST_NEEDED */
+
+/* ------------------------------------------------------------------------ */
+
+#ifdef X_ASSPS_U64LEAST_NEEDED
+#undef writebuf
+#undef fmt
+#undef value
+/*@external@*/ /*@unused@*/
+extern size_t asspf_printfc_int64least(
+	ASSPF_WriteBuf *writebuf, const ASSPF_Format *fmt, uint_least64_t value
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+;
+#else	/* !defined(X_ASSPS_U64LEAST_NEEDED) */
+#define asspf_printfc_int64least(writebuf, fmt, value) \
+	asspf_printfc_int32least( \
+		writebuf, fmt, \
+		(uint_least32_t) ((uint_least64_t) (value)) \
+	)
+#endif	/* X_ASSPS_U64LEAST_NEEDED */
+
+/* ------------------------------------------------------------------------ */
+
+#ifdef X_ASSPS_UINTMAX_NEEDED
+#undef writebuf
+#undef fmt
+#undef value
+/*@external@*/ /*@unused@*/
+extern size_t asspf_printfc_intmax(
+	ASSPF_WriteBuf *writebuf, const ASSPF_Format *fmt, uintmax_t value
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+;
+#else	/* !defined(X_ASSPS_UINTMAX_NEEDED) */
+#if   UINTMAX_MAX == UINT_LEAST8_MAX
+#define asspf_printfc_intmax(writebuf, fmt, value) \
+	asspf_printfc_int8least(writebuf, fmt, (uint_least8_t) (value))
+#elif UINTMAX_MAX == UINT_LEAST16_MAX
+#define asspf_printfc_intmax(writebuf, fmt, value) \
+	asspf_printfc_int16least(writebuf, fmt, (uint_least16_t) (value))
+#elif UINTMAX_MAX == UINT_LEAST32_MAX
+#define asspf_printfc_intmax(writebuf, fmt, value) \
+	asspf_printfc_int32least(writebuf, fmt, (uint_least32_t) (value))
+#elif UINTMAX_MAX == UINT_LEAST64_MAX
+#define asspf_printfc_intmax(writebuf, fmt, value) \
+	asspf_printfc_int64least(writebuf, fmt, (uint_least64_t) (value))
+#else
+#error "asspf_printfc_intmax()"
+#endif
+#endif /* X_ASSPS_UINTMAX_NEEDED */
+
+/* ------------------------------------------------------------------------ */
+
+#ifdef X_ASSPS_UINTPTR_NEEDED
+#undef writebuf
+#undef fmt
+#undef value
+/*@external@*/ /*@unused@*/
+extern size_t asspf_printfc_intptr(
+	ASSPF_WriteBuf *writebuf, const ASSPF_Format *fmt, uintptr_t value
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+;
+#else	/* !defined(X_ASSPS_UINTPTR_NEEDED) */
+#if   UINTPTR_MAX == UINT_LEAST16_MAX
+#define asspf_printfc_intptr(writebuf, fmt, value) \
+	asspf_printfc_int16least(writebuf, fmt, (uint_least16_t) (value))
+#elif UINTPTR_MAX == UINT_LEAST32_MAX
+#define asspf_printfc_intptr(writebuf, fmt, value) \
+	asspf_printfc_int32least(writebuf, fmt, (uint_least32_t) (value))
+#elif UINTPTR_MAX == UINT_LEAST64_MAX
+#define asspf_printfc_intptr(writebuf, fmt, value) \
+	asspf_printfc_int64least(writebuf, fmt, (uint_least64_t) (value))
 #else
-#define asspf_printf_intptr(writebuf, format, value) \
-	asspf_printf_intmax(writebuf, format, (uintmax_t) (value))
+#define asspf_printfc_intptr(writebuf, fmt, value) \
+	asspf_printfc_intmax(writebuf, fmt, (uintmax_t) (value))
 #endif
 #endif /* X_ASSPS_UINTPTR_NEEDED */
 
+/* ------------------------------------------------------------------------ */
+
+#ifdef ASSPF_HAVE_INT128
+#undef writebuf
+#undef fmt
+#undef value
+/*@external@*/ /*@unused@*/
+extern size_t asspf_printfc_int128(
+	ASSPF_WriteBuf *writebuf, const ASSPF_Format *fmt, ASSPF_UInt128 value
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+;
+#endif	/* ASSPF_HAVE_INT128 */
+
 /* ======================================================================== */
 
-/* printf - dependent types */
+/* printfc - dependent types */
 
 /* ------------------------------------------------------------------------ */
 
 #if UINT8_MAX == UINT_LEAST8_MAX
-#define asspf_printf_int8(writebuf, format, value) \
-	asspf_printf_int8least( \
-		writebuf, format, (uint_least8_t) ((value) & UINT8_MAX) \
+#define asspf_printfc_int8(writebuf, fmt, value) \
+	asspf_printfc_int8least( \
+		writebuf, fmt, (uint_least8_t) ((value) & UINT8_MAX) \
 	)
 #endif	/* UINT8_MAX == UINT_LEAST8_MAX */
 
 #if UINT16_MAX == UINT_LEAST16_MAX
-#define asspf_printf_int16(writebuf, format, value) \
-	asspf_printf_int16least( \
-		writebuf, format, (uint_least16_t) ((value) & UINT16_MAX) \
+#define asspf_printfc_int16(writebuf, fmt, value) \
+	asspf_printfc_int16least( \
+		writebuf, fmt, (uint_least16_t) ((value) & UINT16_MAX) \
 	)
 #endif	/* UINT16_MAX == UINT_LEAST16_MAX */
 
 #if UINT32_MAX == UINT_LEAST32_MAX
-#define asspf_printf_int32(writebuf, format, value) \
-	asspf_printf_int32least( \
-		writebuf, format, (uint_least32_t) ((value) & UINT32_MAX) \
+#define asspf_printfc_int32(writebuf, fmt, value) \
+	asspf_printfc_int32least( \
+		writebuf, fmt, (uint_least32_t) ((value) & UINT32_MAX) \
 	)
 #endif	/* UINT32_MAX == UINT_LEAST32_MAX */
 
 #if UINT64_MAX == UINT_LEAST64_MAX
-#define asspf_printf_int64(writebuf, format, value) \
-	asspf_printf_int64least( \
-		writebuf, format, (uint_least64_t) ((value) & UINT64_MAX) \
+#define asspf_printfc_int64(writebuf, fmt, value) \
+	asspf_printfc_int64least( \
+		writebuf, fmt, (uint_least64_t) ((value) & UINT64_MAX) \
 	)
 #endif	/* UINT64_MAX == UINT_LEAST64_MAX */
 
 /* ------------------------------------------------------------------------ */
 
 #if   UINT_FAST8_MAX == UINT_LEAST8_MAX
-#define asspf_printf_int8fast(writebuf, format, value) \
-	asspf_printf_int8least( \
-		writebuf, format, (uint_least8_t) ((uint_fast8_t) (value)) \
+#define asspf_printfc_int8fast(writebuf, fmt, value) \
+	asspf_printfc_int8least( \
+		writebuf, fmt, (uint_least8_t) ((uint_fast8_t) (value)) \
 	)
 #elif UINT_FAST8_MAX == UINT_LEAST16_MAX
-#define asspf_printf_int8fast(writebuf, format, value) \
-	asspf_printf_int16least( \
-		writebuf, format, (uint_least16_t) ((uint_fast8_t) (value)) \
+#define asspf_printfc_int8fast(writebuf, fmt, value) \
+	asspf_printfc_int16least( \
+		writebuf, fmt, (uint_least16_t) ((uint_fast8_t) (value)) \
 	)
 #elif UINT_FAST8_MAX == UINT_LEAST32_MAX
-#define asspf_printf_int8fast(writebuf, format, value) \
-	asspf_printf_int32least( \
-		writebuf, format, (uint_least32_t) ((uint_fast8_t) (value)) \
+#define asspf_printfc_int8fast(writebuf, fmt, value) \
+	asspf_printfc_int32least( \
+		writebuf, fmt, (uint_least32_t) ((uint_fast8_t) (value)) \
 	)
 #elif UINT_FAST8_MAX == UINT_LEAST64_MAX
-#define asspf_printf_int8fast(writebuf, format, value) \
-	asspf_printf_int64least( \
-		writebuf, format, (uint_least64_t) ((uint_fast8_t) (value)) \
+#define asspf_printfc_int8fast(writebuf, fmt, value) \
+	asspf_printfc_int64least( \
+		writebuf, fmt, (uint_least64_t) ((uint_fast8_t) (value)) \
 	)
 #else
-#define asspf_printf_int8fast(writebuf, format, value) \
-	asspf_printf_intmax( \
-		writebuf, format, (uintmax_t) ((uint_fast8_t) (value)) \
+#define asspf_printfc_int8fast(writebuf, fmt, value) \
+	asspf_printfc_intmax( \
+		writebuf, fmt, (uintmax_t) ((uint_fast8_t) (value)) \
 	)
 #endif
 
 /* ------------------------------------------------------------------------ */
 
 #if   UINT_FAST16_MAX == UINT_LEAST16_MAX
-#define asspf_printf_int16fast(writebuf, format, value) \
-	asspf_printf_int16least( \
-		writebuf, format, (uint_least16_t) ((uint_fast16_t) (value)) \
+#define asspf_printfc_int16fast(writebuf, fmt, value) \
+	asspf_printfc_int16least( \
+		writebuf, fmt, (uint_least16_t) ((uint_fast16_t) (value)) \
 	)
 #elif UINT_FAST16_MAX == UINT_LEAST32_MAX
-#define asspf_printf_int16fast(writebuf, format, value) \
-	asspf_printf_int32least( \
-		writebuf, format, (uint_least32_t) ((uint_fast16_t) (value)) \
+#define asspf_printfc_int16fast(writebuf, fmt, value) \
+	asspf_printfc_int32least( \
+		writebuf, fmt, (uint_least32_t) ((uint_fast16_t) (value)) \
 	)
 #elif UINT_FAST16_MAX == UINT_LEAST64_MAX
-#define asspf_printf_int16fast(writebuf, format, value) \
-	asspf_printf_int64least( \
-		writebuf, format, (uint_least64_t) ((uint_fast16_t) (value)) \
+#define asspf_printfc_int16fast(writebuf, fmt, value) \
+	asspf_printfc_int64least( \
+		writebuf, fmt, (uint_least64_t) ((uint_fast16_t) (value)) \
 	)
 #else
-#define asspf_printf_int16fast(writebuf, format, value) \
-	asspf_printf_intmax( \
-		writebuf, format, (uintmax_t) ((uint_fast16_t) (value)) \
+#define asspf_printfc_int16fast(writebuf, fmt, value) \
+	asspf_printfc_intmax( \
+		writebuf, fmt, (uintmax_t) ((uint_fast16_t) (value)) \
 	)
 #endif
 
 /* ------------------------------------------------------------------------ */
 
 #if   UINT_FAST32_MAX == UINT_LEAST32_MAX
-#define asspf_printf_int32fast(writebuf, format, value) \
-	asspf_printf_int32least( \
-		writebuf, format, (uint_least32_t) ((uint_fast32_t) (value)) \
+#define asspf_printfc_int32fast(writebuf, fmt, value) \
+	asspf_printfc_int32least( \
+		writebuf, fmt, (uint_least32_t) ((uint_fast32_t) (value)) \
 	)
 #elif UINT_FAST32_MAX == UINT_LEAST64_MAX
-#define asspf_printf_int32fast(writebuf, format, value) \
-	asspf_printf_int64least( \
-		writebuf, format, (uint_least64_t) ((uint_fast32_t) (value)) \
+#define asspf_printfc_int32fast(writebuf, fmt, value) \
+	asspf_printfc_int64least( \
+		writebuf, fmt, (uint_least64_t) ((uint_fast32_t) (value)) \
 	)
 #else
-#define asspf_printf_int32fast(writebuf, format, value) \
-	asspf_printf_intmax( \
-		writebuf, format, (uintmax_t) ((uint_fast32_t) (value)) \
+#define asspf_printfc_int32fast(writebuf, fmt, value) \
+	asspf_printfc_intmax( \
+		writebuf, fmt, (uintmax_t) ((uint_fast32_t) (value)) \
 	)
 #endif
 
 /* ------------------------------------------------------------------------ */
 
 #if   UINT_FAST64_MAX == UINT_LEAST64_MAX
-#define asspf_printf_int64fast(writebuf, format, value) \
-	asspf_printf_int64least( \
-		writebuf, format, (uint_least64_t) ((uint_fast64_t) (value)) \
+#define asspf_printfc_int64fast(writebuf, fmt, value) \
+	asspf_printfc_int64least( \
+		writebuf, fmt, (uint_least64_t) ((uint_fast64_t) (value)) \
 	)
 #else
-#define asspf_printf_int64fast(writebuf, format, value) \
-	asspf_printf_intmax( \
-		writebuf, format, (uintmax_t) ((uint_fast64_t) (value)) \
+#define asspf_printfc_int64fast(writebuf, fmt, value) \
+	asspf_printfc_intmax( \
+		writebuf, fmt, (uintmax_t) ((uint_fast64_t) (value)) \
 	)
 #endif
 
 /* ------------------------------------------------------------------------ */
 
 #if   UCHAR_MAX == UINT_LEAST8_MAX
-#define asspf_printf_char(writebuf, format, value) \
-	asspf_printf_int8least( \
-		writebuf, format, (uint_least8_t) ((unsigned char) (value)) \
+#define asspf_printfc_char(writebuf, fmt, value) \
+	asspf_printfc_int8least( \
+		writebuf, fmt, (uint_least8_t) ((unsigned char) (value)) \
 	)
 #elif UCHAR_MAX == UINT_LEAST16_MAX
-#define asspf_printf_char(writebuf, format, value) \
-	asspf_printf_int16least( \
-		writebuf, format, (uint_least16_t) ((unsigned char) (value)) \
+#define asspf_printfc_char(writebuf, fmt, value) \
+	asspf_printfc_int16least( \
+		writebuf, fmt, (uint_least16_t) ((unsigned char) (value)) \
 	)
 #elif UCHAR_MAX == UINT_LEAST32_MAX
-#define asspf_printf_char(writebuf, format, value) \
-	asspf_printf_int32least( \
-		writebuf, format, (uint_least32_t) ((unsigned char) (value)) \
+#define asspf_printfc_char(writebuf, fmt, value) \
+	asspf_printfc_int32least( \
+		writebuf, fmt, (uint_least32_t) ((unsigned char) (value)) \
 	)
 #elif UCHAR_MAX == UINT_LEAST64_MAX
-#define asspf_printf_char(writebuf, format, value) \
-	asspf_printf_int64least( \
-		writebuf, format, (uint_least64_t) ((unsigned char) (value)) \
+#define asspf_printfc_char(writebuf, fmt, value) \
+	asspf_printfc_int64least( \
+		writebuf, fmt, (uint_least64_t) ((unsigned char) (value)) \
 	)
 #else
-#define asspf_printf_char(writebuf, format, value) \
-	asspf_printf_intmax( \
-		writebuf, format, (uintmax_t) ((unsigned char) (value)) \
+#define asspf_printfc_char(writebuf, fmt, value) \
+	asspf_printfc_intmax( \
+		writebuf, fmt, (uintmax_t) ((unsigned char) (value)) \
 	)
 #endif
 
 /* ------------------------------------------------------------------------ */
 
 #if   USHRT_MAX == UINT_LEAST16_MAX
-#define asspf_printf_short(writebuf, format, value) \
-	asspf_printf_int16least( \
-		writebuf, format, \
+#define asspf_printfc_short(writebuf, fmt, value) \
+	asspf_printfc_int16least( \
+		writebuf, fmt, \
 		(uint_least16_t) ((unsigned short) (value)) \
 	)
 #elif USHRT_MAX == UINT_LEAST32_MAX
-#define asspf_printf_short(writebuf, format, value) \
-	asspf_printf_int32least( \
-		writebuf, format, \
+#define asspf_printfc_short(writebuf, fmt, value) \
+	asspf_printfc_int32least( \
+		writebuf, fmt, \
 		(uint_least32_t) ((unsigned short) (value)) \
 	)
 #elif USHRT_MAX == UINT_LEAST64_MAX
-#define asspf_printf_short(writebuf, format, value) \
-	asspf_printf_int64least( \
-		writebuf, format, \
+#define asspf_printfc_short(writebuf, fmt, value) \
+	asspf_printfc_int64least( \
+		writebuf, fmt, \
 		(uint_least64_t) ((unsigned short) (value)) \
 	)
 #else
-#define asspf_printf_short(writebuf, format, value) \
-	asspf_printf_intmax( \
-		writebuf, format, (uintmax_t) ((unsigned short) (value)) \
+#define asspf_printfc_short(writebuf, fmt, value) \
+	asspf_printfc_intmax( \
+		writebuf, fmt, (uintmax_t) ((unsigned short) (value)) \
 	)
 #endif
 
 /* ------------------------------------------------------------------------ */
 
 #if   UINT_MAX == UINT_LEAST16_MAX
-#define asspf_printf_int(writebuf, format, value) \
-	asspf_printf_int16least( \
-		writebuf, format, (uint_least16_t) ((unsigned int) (value)) \
+#define asspf_printfc_int(writebuf, fmt, value) \
+	asspf_printfc_int16least( \
+		writebuf, fmt, (uint_least16_t) ((unsigned int) (value)) \
 	)
 #elif UINT_MAX == UINT_LEAST32_MAX
-#define asspf_printf_int(writebuf, format, value) \
-	asspf_printf_int32least( \
-		writebuf, format, (uint_least32_t) ((unsigned int) (value)) \
+#define asspf_printfc_int(writebuf, fmt, value) \
+	asspf_printfc_int32least( \
+		writebuf, fmt, (uint_least32_t) ((unsigned int) (value)) \
 	)
 #elif UINT_MAX == UINT_LEAST64_MAX
-#define asspf_printf_int(writebuf, format, value) \
-	asspf_printf_int64least( \
-		writebuf, format, (uint_least64_t) ((unsigned int) (value)) \
+#define asspf_printfc_int(writebuf, fmt, value) \
+	asspf_printfc_int64least( \
+		writebuf, fmt, (uint_least64_t) ((unsigned int) (value)) \
 	)
 #else
-#define asspf_printf_int(writebuf, format, value) \
-	asspf_printf_intmax( \
-		writebuf, format, (uintmax_t) ((unsigned int) (value)) \
+#define asspf_printfc_int(writebuf, fmt, value) \
+	asspf_printfc_intmax( \
+		writebuf, fmt, (uintmax_t) ((unsigned int) (value)) \
 	)
 #endif
 
 /* ------------------------------------------------------------------------ */
 
 #if   ULONG_MAX == UINT_LEAST32_MAX
-#define asspf_printf_long(writebuf, format, value) \
-	asspf_printf_int32least( \
-		writebuf, format, (uint_least32_t) ((unsigned long) (value)) \
+#define asspf_printfc_long(writebuf, fmt, value) \
+	asspf_printfc_int32least( \
+		writebuf, fmt, (uint_least32_t) ((unsigned long) (value)) \
 	)
 #elif ULONG_MAX == UINT_LEAST64_MAX
-#define asspf_printf_long(writebuf, format, value) \
-	asspf_printf_int64least( \
-		writebuf, format, (uint_least64_t) ((unsigned long) (value)) \
+#define asspf_printfc_long(writebuf, fmt, value) \
+	asspf_printfc_int64least( \
+		writebuf, fmt, (uint_least64_t) ((unsigned long) (value)) \
 	)
 #else
-#define asspf_printf_long(writebuf, format, value) \
-	asspf_printf_intmax( \
-		writebuf, format, (uintmax_t) ((unsigned long) (value)) \
+#define asspf_printfc_long(writebuf, fmt, value) \
+	asspf_printfc_intmax( \
+		writebuf, fmt, (uintmax_t) ((unsigned long) (value)) \
 	)
 #endif
 
@@ -524,15 +1661,15 @@ extern size_t asspf_printf_intptr(
 
 #if __STDC_VERSION__ >= 199901L || defined(__GNUC__)
 #if   ULLONG_MAX == UINT_LEAST64_MAX
-#define asspf_printf_longlong(writebuf, format, value) \
-	asspf_printf_int64least( \
-		writebuf, format, \
+#define asspf_printfc_longlong(writebuf, fmt, value) \
+	asspf_printfc_int64least( \
+		writebuf, fmt, \
 		(uint_least64_t) ((unsigned long long) (value)) \
 	)
 #else
-#define asspf_printf_longlong(writebuf, format, value) \
-	asspf_printf_intmax( \
-		writebuf, format, (uintmax_t) ((unsigned long long) (value)) \
+#define asspf_printfc_longlong(writebuf, fmt, value) \
+	asspf_printfc_intmax( \
+		writebuf, fmt, (uintmax_t) ((unsigned long long) (value)) \
 	)
 #endif
 #endif	/* __STDC_VERSION__ >= 199901L || defined(__GNUC__) */
@@ -540,53 +1677,257 @@ extern size_t asspf_printf_intptr(
 /* ------------------------------------------------------------------------ */
 
 #if   SIZE_MAX == INT_LEAST16_MAX
-#define asspf_printf_size(writebuf, format, value) \
-	asspf_printf_int16least( \
-		writebuf, format, (uint_least16_t) ((size_t) (value)) \
+#define asspf_printfc_size(writebuf, fmt, value) \
+	asspf_printfc_int16least( \
+		writebuf, fmt, (uint_least16_t) ((size_t) (value)) \
 	)
 #elif SIZE_MAX == INT_LEAST32_MAX
-#define asspf_printf_size(writebuf, format, value) \
-	asspf_printf_int32least( \
-		writebuf, format, (uint_least32_t) ((size_t) (value)) \
+#define asspf_printfc_size(writebuf, fmt, value) \
+	asspf_printfc_int32least( \
+		writebuf, fmt, (uint_least32_t) ((size_t) (value)) \
 	)
 #elif SIZE_MAX == INT_LEAST64_MAX
-#define asspf_printf_size(writebuf, format, value) \
-	asspf_printf_int64least( \
-		writebuf, format, (uint_least64_t) ((size_t) (value)) \
+#define asspf_printfc_size(writebuf, fmt, value) \
+	asspf_printfc_int64least( \
+		writebuf, fmt, (uint_least64_t) ((size_t) (value)) \
 	)
 #else
-#define asspf_printf_size(writebuf, format, value) \
-	asspf_printf_intmax( \
-		writebuf, format, (uintmax_t) ((size_t) (value)) \
+#define asspf_printfc_size(writebuf, fmt, value) \
+	asspf_printfc_intmax( \
+		writebuf, fmt, (uintmax_t) ((size_t) (value)) \
 	)
 #endif
 
 /* ------------------------------------------------------------------------ */
 
 #if   PTRDIFF_MAX == INT_LEAST16_MAX
-#define asspf_printf_ptrdiff(writebuf, format, value) \
-	asspf_printf_int16least( \
-		writebuf, format, (uint_least16_t) ((ptrdiff_t) (value)) \
+#define asspf_printfc_ptrdiff(writebuf, fmt, value) \
+	asspf_printfc_int16least( \
+		writebuf, fmt, (uint_least16_t) ((ptrdiff_t) (value)) \
 	)
 #elif PTRDIFF_MAX == INT_LEAST32_MAX
-#define asspf_printf_ptrdiff(writebuf, format, value) \
-	asspf_printf_int32least( \
-		writebuf, format, (uint_least32_t) ((ptrdiff_t) (value)) \
+#define asspf_printfc_ptrdiff(writebuf, fmt, value) \
+	asspf_printfc_int32least( \
+		writebuf, fmt, (uint_least32_t) ((ptrdiff_t) (value)) \
 	)
 #elif PTRDIFF_MAX == INT_LEAST64_MAX
-#define asspf_printf_ptrdiff(writebuf, format, value) \
-	asspf_printf_int64least( \
-		writebuf, format, (uint_least64_t) ((ptrdiff_t) (value)) \
+#define asspf_printfc_ptrdiff(writebuf, fmt, value) \
+	asspf_printfc_int64least( \
+		writebuf, fmt, (uint_least64_t) ((ptrdiff_t) (value)) \
 	)
 #else
-#define asspf_printf_ptrdiff(writebuf, format, value) \
-	asspf_printf_intmax( \
-		writebuf, format, (uintmax_t) ((ptrdiff_t) (value)) \
+#define asspf_printfc_ptrdiff(writebuf, fmt, value) \
+	asspf_printfc_intmax( \
+		writebuf, fmt, (uintmax_t) ((ptrdiff_t) (value)) \
 	)
 #endif
 
 /* ======================================================================== */
 
+/* printr - records */
+
+struct ASSPF_Arg {
+	/*@null@*/ /*@temp@*/
+	const char	*str;
+	uintmax_t	 value;
+	size_t		 size;
+};
+typedef struct ASSPF_Arg	ASSPF_Arg;
+
+/* initializers: C89 only takes constants in them */
+#define ASSPF_ARG_STR(Xstr) \
+	{ (Xstr), (uintmax_t) 0, (size_t) 0 }
+
+#define ASSPF_ARG_INT(Xtype, Xvalue) \
+	{ NULL, (uintmax_t) ((Xtype) (Xvalue)), sizeof(Xtype) }
+
+/* setters, for runtime values ('Xarg' gets evaluated more than once) */
+#define ASSPF_ARG_SET_STR(Xarg, Xstr) ( \
+	(Xarg).str   = (Xstr), \
+	(Xarg).value = (uintmax_t) 0, \
+	(void) ((Xarg).size = (size_t) 0) \
+)
+
+#define ASSPF_ARG_SET_INT(Xarg, Xtype, Xvalue) ( \
+	(Xarg).str   = NULL, \
+	(Xarg).value = (uintmax_t) ((Xtype) (Xvalue)), \
+	(void) ((Xarg).size = sizeof(Xtype)) \
+)
+
+/* ------------------------------------------------------------------------ */
+
+#undef writebuf
+#undef tmpl
+#undef args
+#undef nargs
+/*@external@*/ /*@unused@*/
+extern size_t asspf_printr(
+	ASSPF_WriteBuf *writebuf, const char *tmpl, const ASSPF_Arg args[],
+	size_t nargs
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+;
+
+/* ======================================================================== */
+
+/* records - structured log lines */
+
+#define ASSPF_RECORD_JSON	0	/* {"key":value,...} */
+#define ASSPF_RECORD_LOGFMT	1	/* key=value ... */
+
+struct X_ASSPF_Field {
+	/*@temp@*/
+	const char	*x_0;
+	/*@null@*/ /*@temp@*/
+	const char	*x_1;
+	uintmax_t	 x_2;
+	size_t		 x_3;
+	int		 x_4;
+};
+typedef /*@abstract@*/ struct X_ASSPF_Field	ASSPF_Field;
+
+struct X_ASSPF_Record {
+	/*@temp@*/
+	ASSPF_Field	*x_0;
+	size_t		 x_1;
+	size_t		 x_2;
+	int		 x_3;
+	int		 x_4;
+};
+typedef /*@abstract@*/ struct X_ASSPF_Record	ASSPF_Record;
+
+/* ------------------------------------------------------------------------ */
+
+#undef rec
+#undef fields
+#undef nfields_max
+#undef style
+/*@external@*/ /*@unused@*/
+extern int asspf_record_begin(
+	/*@out@*/
+	ASSPF_Record *rec,
+	ASSPF_Field fields[], size_t nfields_max, int style
+)
+/*@modifies	*rec@*/
+;
+
+#undef rec
+#undef key
+#undef value
+/*@external@*/ /*@unused@*/
+extern int asspf_record_int(ASSPF_Record *rec, const char *key, intmax_t value)
+/*@modifies	*rec@*/
+;
+
+#undef rec
+#undef key
+#undef value
+/*@external@*/ /*@unused@*/
+extern int asspf_record_uint(
+	ASSPF_Record *rec, const char *key, uintmax_t value
+)
+/*@modifies	*rec@*/
+;
+
+#undef rec
+#undef key
+#undef value
+/*@external@*/ /*@unused@*/
+extern int asspf_record_hex(
+	ASSPF_Record *rec, const char *key, uintmax_t value
+)
+/*@modifies	*rec@*/
+;
+
+#undef rec
+#undef key
+#undef str
+/*@external@*/ /*@unused@*/
+extern int asspf_record_str(
+	ASSPF_Record *rec, const char *key, const char *str
+)
+/*@modifies	*rec@*/
+;
+
+#undef rec
+#undef writebuf
+/*@external@*/ /*@unused@*/
+extern size_t asspf_record_end(
+	const ASSPF_Record *rec, ASSPF_WriteBuf *writebuf
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+;
+
+#ifdef ASSPF_OPT_STATS
+#undef writebuf
+#undef stats
+#undef style
+/*@external@*/ /*@unused@*/
+extern size_t asspf_stats_dump(
+	ASSPF_WriteBuf *writebuf, const ASSPF_Stats *stats, int style
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+;
+#endif
+
+/* ======================================================================== */
+
+/* hexdump */
+
+#define ASSPF_HEXDUMP_UPPER		0x01u
+#define ASSPF_HEXDUMP_NO_ASCII		0x02u
+#define ASSPF_HEXDUMP_ADDR		0x04u
+#define ASSPF_HEXDUMP_GROUP(Xn)		(((unsigned int) (Xn) & 0x1Fu) << 8u)
+
+/* ------------------------------------------------------------------------ */
+
+#undef writebuf
+#undef ptr
+#undef size
+#undef flags
+/*@external@*/ /*@unused@*/
+extern size_t asspf_hexdump(
+	ASSPF_WriteBuf *writebuf, const void *ptr, size_t size,
+	unsigned int flags
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+;
+
+/* ======================================================================== */
+
+#ifndef ASSPF_OPT_NO_FLOAT
+
+/* shortest round-trip floating-point */
+
+#undef writebuf
+#undef format
+#undef value
+/*@external@*/ /*@unused@*/
+extern size_t asspf_printf_double(
+	ASSPF_WriteBuf *writebuf, const char *format, double value
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*writebuf
+@*/
+;
+
+#endif	/* ASSPF_OPT_NO_FLOAT */
+
+/* ======================================================================== */
+
 #endif	/* ASSPF_OPT_NO_PRINTF */
 
 /* EOF //////////////////////////////////////////////////////////////////// */
@@ -0,0 +1,438 @@
+#ifndef ASSPF_HPP
+#define ASSPF_HPP
+/* ///////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// asspf.hpp - Async-Signal-Safe Print Functions (C++20 wrapper)            //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Copyright (C) 2025, Shane Seelig                                         //
+// SPDX-License-Identifier: GPL-3.0-or-later                                //
+//                                                                          //
+/////////////////////////////////////////////////////////////////////////// */
+
+#if __cplusplus < 202002L
+#error "asspf.hpp needs C++20"
+#endif
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+extern "C" {
+#include "asspf.h"
+}
+
+#ifndef ASSPF_OPT_NO_PRINTF
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+namespace asspf {
+
+/* a format string as a template argument: asspf::print<"08x">(wb, value) */
+template <std::size_t N>
+struct Fmt {
+	char str[N];
+
+	consteval Fmt(const char (&s)[N])
+	{
+		for ( std::size_t i = 0; i < N; ++i ){
+			str[i] = s[i];
+		}
+	}
+};
+
+/* binary mode id meaning "no id" (see asspf_format_compile_id()) */
+inline constexpr unsigned short FORMAT_ID_NONE = 0xFFFFu;
+
+/* __int128 is not std::is_integral in strict (non-GNU) modes */
+#ifdef ASSPF_HAVE_INT128
+__extension__ typedef __int128	Int128;
+
+template <typename T>
+inline constexpr bool is_int128_v =
+	std::is_same_v<T, Int128> || std::is_same_v<T, ASSPF_UInt128>;
+#else
+template <typename T>
+inline constexpr bool is_int128_v = false;
+#endif
+
+/* ======================================================================== */
+
+namespace detail {
+
+/* mirrors of asspf.c's FORMAT* constants (keep in sync) */
+inline constexpr unsigned int FLAG_ALTFORM_C		= 0x01u;
+inline constexpr unsigned int FLAG_ALTFORM_M		= 0x02u;
+inline constexpr unsigned int FLAG_ZERO_PAD		= 0x04u;
+inline constexpr unsigned int FLAG_LEFT_ADJUST		= 0x08u;
+inline constexpr unsigned int FLAG_BLANK_SIGN		= 0x10u;
+inline constexpr unsigned int FLAG_ALWAYS_SIGN		= 0x20u;
+
+inline constexpr unsigned int FIELDWIDTH_UNSET		= 0u;
+inline constexpr unsigned int PRECISION_UNSET		= 1u;
+inline constexpr unsigned int SCALE_UNSET		= 0u;
+inline constexpr unsigned int SCALE_MAX			= 19u;
+
+enum ConvSpec : int {
+	CONVSPEC_UNSET,
+	CONVSPEC_d,
+	CONVSPEC_u,
+	CONVSPEC_b,
+	CONVSPEC_o,
+	CONVSPEC_x,
+	CONVSPEC_X
+};
+
+/* ------------------------------------------------------------------------ */
+
+/* not constexpr, so reaching it while compiling a format is an error;
+   the compiler's note points at the call and its message */
+void format_error(const char *why);
+
+/* ------------------------------------------------------------------------ */
+
+/* like asspf.c's format scanner, but all in one pass */
+class FormatScanner {
+public:
+	consteval FormatScanner(const char *format)
+	: format_(format), idx_(0)
+	{}
+
+	consteval unsigned int
+	flags(void)
+	{
+		unsigned int flags = 0;
+		unsigned int flag;
+
+		for (;;){
+			switch ( format_[idx_] ){
+			case '#': flag = FLAG_ALTFORM_C;	break;
+			case '$': flag = FLAG_ALTFORM_M;	break;
+			case '0': flag = FLAG_ZERO_PAD;		break;
+			case '-': flag = FLAG_LEFT_ADJUST;	break;
+			case ' ': flag = FLAG_BLANK_SIGN;	break;
+			case '+': flag = FLAG_ALWAYS_SIGN;	break;
+			default:
+				return flags;
+			}
+			if ( (flags & flag) != 0 ){
+				format_error("asspf: repeated flag character");
+			}
+			flags |= flag;
+			++idx_;
+		}
+	}
+
+	consteval unsigned int
+	fieldwidth(void)
+	{
+		if ( is_digit() ){
+			return number();
+		}
+		return FIELDWIDTH_UNSET;
+	}
+
+	consteval unsigned int
+	precision(void)
+	{
+		if ( format_[idx_] == '.' ){
+			++idx_;
+			if ( ! is_digit() ){
+				format_error("asspf: '.' without a precision");
+			}
+			return number();
+		}
+		return PRECISION_UNSET;
+	}
+
+	consteval unsigned int
+	scale(void)
+	{
+		unsigned int scale;
+
+		if ( format_[idx_] == ',' ){
+			++idx_;
+			if ( ! is_digit() ){
+				format_error("asspf: ',' without a scale");
+			}
+			scale = number();
+			if ( scale > SCALE_MAX ){
+				format_error("asspf: scale is over 19");
+			}
+			return scale;
+		}
+		return SCALE_UNSET;
+	}
+
+	consteval ConvSpec
+	convspec_int(void)
+	{
+		switch ( format_[idx_++] ){
+		case 'd': return CONVSPEC_d;
+		case 'u': return CONVSPEC_u;
+		case 'b': return CONVSPEC_b;
+		case 'o': return CONVSPEC_o;
+		case 'x': return CONVSPEC_x;
+		case 'X': return CONVSPEC_X;
+		default:
+			format_error("asspf: bad integer conversion specifier");
+		}
+		return CONVSPEC_UNSET;
+	}
+
+	consteval void
+	convspec_double(void)
+	{
+		switch ( format_[idx_++] ){
+		case 'g':
+		case 'e':
+			return;
+		default:
+			format_error("asspf: bad double conversion specifier");
+		}
+	}
+
+	consteval void
+	end(void)
+	{
+		if ( format_[idx_] != '\0' ){
+			format_error("asspf: trailing characters in format");
+		}
+	}
+
+private:
+	const char  *format_;
+	std::size_t  idx_;
+
+	consteval bool
+	is_digit(void) const
+	{
+		return (format_[idx_] >= '0') && (format_[idx_] <= '9');
+	}
+
+	/* same limits as the runtime scanner: UINT_MAX's digits, INT_MAX */
+	consteval unsigned int
+	number(void)
+	{
+		const std::size_t ndigits_max = std::size_t{10u};
+		std::uintmax_t value = 0;
+		std::size_t ndigits  = 0;
+
+		while ( is_digit() ){
+			value = (value * 10u)
+			      + static_cast<unsigned int>(format_[idx_] - '0');
+			++idx_;
+			if ( ++ndigits > ndigits_max ){
+				format_error("asspf: number too long");
+			}
+		}
+		if ( value > static_cast<std::uintmax_t>(INT_MAX) ){
+			format_error("asspf: number in format over INT_MAX");
+		}
+		return static_cast<unsigned int>(value);
+	}
+};
+
+/* ------------------------------------------------------------------------ */
+
+/* returns what asspf_format_compile_id() would fill in */
+consteval ASSPF_Format
+format_compile(const char *format, unsigned short id)
+{
+	FormatScanner scan(format);
+	unsigned int  flags, fieldwidth, precision, scale;
+	ConvSpec      convspec;
+
+	flags      = scan.flags();
+	fieldwidth = scan.fieldwidth();
+	precision  = scan.precision();
+	scale      = scan.scale();
+	convspec   = scan.convspec_int();
+	scan.end();
+
+	if ( (scale != SCALE_UNSET)
+	&&   (convspec != CONVSPEC_d) && (convspec != CONVSPEC_u)
+	){
+		format_error("asspf: scale is only for 'd' and 'u'");
+	}
+
+	return ASSPF_Format{
+		flags, fieldwidth, precision, scale,
+		static_cast<int>(convspec), static_cast<unsigned int>(id)
+	};
+}
+
+/* checks a format string for asspf_printf_double() */
+consteval bool
+format_check_double(const char *format)
+{
+	FormatScanner scan(format);
+
+	if ( (scan.flags() & (FLAG_ALTFORM_C | FLAG_ALTFORM_M)) != 0 ){
+		format_error("asspf: no sigils for doubles");
+	}
+	(void) scan.fieldwidth();
+	scan.convspec_double();
+	scan.end();
+	return true;
+}
+
+/* one read-only Format object per format string and id */
+template <Fmt F, unsigned short Id>
+inline constexpr ASSPF_Format compiled = format_compile(F.str, Id);
+
+template <Fmt F>
+inline constexpr bool double_ok = format_check_double(F.str);
+
+} /* namespace detail */
+
+/* ======================================================================== */
+
+/* returns the number of bytes written to the writebuf */
+/* the format string is scanned by the compiler (a bad one does not build),
+   so only the digit conversion is left for run time */
+template <Fmt F, unsigned short Id = FORMAT_ID_NONE, typename T>
+inline std::size_t
+print(ASSPF_WriteBuf *writebuf, T value)
+{
+	static_assert(
+		(std::is_arithmetic_v<T> || is_int128_v<T>)
+	&&
+		! std::is_same_v<T, bool>,
+		"asspf::print() takes an integer or a double"
+	);
+
+#ifdef ASSPF_HAVE_INT128
+	if constexpr ( is_int128_v<T> ){
+		return asspf_printfc_int128(
+			writebuf, &detail::compiled<F, Id>,
+			static_cast<ASSPF_UInt128>(value)
+		);
+	}
+	else
+#endif
+	if constexpr ( std::is_floating_point_v<T> ){
+		static_assert(Id == FORMAT_ID_NONE, "no ids for doubles");
+#ifndef ASSPF_OPT_NO_FLOAT
+		static_assert(detail::double_ok<F>);
+		return asspf_printf_double(
+			writebuf, F.str, static_cast<double>(value)
+		);
+#else
+		static_assert(! std::is_floating_point_v<T>,
+			"asspf was built with ASSPF_OPT_NO_FLOAT"
+		);
+		return 0;
+#endif
+	}
+	else {
+		const ASSPF_Format *fmt = &detail::compiled<F, Id>;
+		const auto          u   = static_cast<std::make_unsigned_t<T>>(
+			value
+		);
+
+		/* same width as T, so 'd' sees the sign bit where it is */
+		if constexpr ( sizeof(T) == sizeof(uint_least8_t) ){
+			return asspf_printfc_int8least(
+				writebuf, fmt, static_cast<uint_least8_t>(u)
+			);
+		}
+		else if constexpr ( sizeof(T) == sizeof(uint_least16_t) ){
+			return asspf_printfc_int16least(
+				writebuf, fmt, static_cast<uint_least16_t>(u)
+			);
+		}
+		else if constexpr ( sizeof(T) == sizeof(uint_least32_t) ){
+			return asspf_printfc_int32least(
+				writebuf, fmt, static_cast<uint_least32_t>(u)
+			);
+		}
+		else if constexpr ( sizeof(T) == sizeof(uint_least64_t) ){
+			return asspf_printfc_int64least(
+				writebuf, fmt, static_cast<uint_least64_t>(u)
+			);
+		}
+		else {
+			static_assert(sizeof(T) == sizeof(uintmax_t),
+				"asspf::print(): integer is too wide"
+			);
+			return asspf_printfc_intmax(
+				writebuf, fmt, static_cast<uintmax_t>(u)
+			);
+		}
+	}
+}
+
+/* ======================================================================== */
+
+/* a WriteBuf object pointer with the printing functions as members;
+   it owns nothing, so it is as AS-Safe as the WriteBuf object itself */
+class Writer {
+public:
+	explicit constexpr Writer(ASSPF_WriteBuf *writebuf) noexcept
+	: writebuf_(writebuf)
+	{}
+
+	constexpr ASSPF_WriteBuf *
+	get(void) const
+	{
+		return writebuf_;
+	}
+
+	template <Fmt F, unsigned short Id = FORMAT_ID_NONE, typename T>
+	std::size_t
+	print(T value) const
+	{
+		return asspf::print<F, Id>(writebuf_, value);
+	}
+
+	std::size_t
+	puts(const char *s) const
+	{
+		return asspf_puts(writebuf_, s);
+	}
+
+	std::size_t
+	putc(char c) const
+	{
+		return asspf_putc(writebuf_, c);
+	}
+
+	std::size_t
+	put_json_string(const char *src, std::size_t size) const
+	{
+		return asspf_put_json_string(writebuf_, src, size);
+	}
+
+	std::size_t
+	put_c_escaped(const char *src, std::size_t size) const
+	{
+		return asspf_put_c_escaped(writebuf_, src, size);
+	}
+
+	std::size_t
+	write(const void *src, std::size_t size) const
+	{
+		return asspf_write(writebuf_, src, size);
+	}
+
+	unsigned short
+	flush(void) const
+	{
+		return asspf_flush(writebuf_);
+	}
+
+private:
+	ASSPF_WriteBuf *writebuf_;
+};
+
+} /* namespace asspf */
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+#endif	/* ASSPF_OPT_NO_PRINTF */
+
+/* EOF //////////////////////////////////////////////////////////////////// */
+#endif	/* ASSPF_HPP */
@@ -0,0 +1,413 @@
+/* ///////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// asspf_crash.c - Async-Signal-Safe crash reporter                         //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Copyright (C) 2025, Shane Seelig                                         //
+// SPDX-License-Identifier: GPL-3.0-or-later                                //
+//                                                                          //
+/////////////////////////////////////////////////////////////////////////// */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE	/* REG_RIP, ... */
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#include "asspf.h"
+#include "asspf_crash.h"
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+#ifdef ASSPF_OPT_NO_PRINTF
+#error "asspf_crash.c needs the asspf printf-like functions"
+#endif
+
+#define CRASH_BUF_SIZE		4096u
+#define CRASH_BACKTRACE_MAX	64u
+#define CRASH_FRAME_SIZE_MAX	((uintptr_t) 0x100000u)	/* 1 MiB */
+#define CRASH_HEX		"#.16x"
+
+/* ------------------------------------------------------------------------ */
+
+#if defined(__linux__) && defined(__x86_64__)
+#define CRASH_ARCH_X86_64
+#elif defined(__linux__) && defined(__aarch64__)
+#define CRASH_ARCH_AARCH64
+#endif
+
+/* ------------------------------------------------------------------------ */
+
+static const int crash_signals[] = {
+	SIGSEGV, SIGBUS, SIGABRT, SIGFPE, SIGILL
+};
+
+/* preallocated, so a crash never touches the heap */
+static char crash_buf[CRASH_BUF_SIZE];
+static int  crash_fd   = -1;
+static int  crash_busy = 0;	/* only the first crash gets reported */
+static int  crash_probe[2] = {-1, -1};	/* pipe the stack is read through */
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/*@observer@*/
+static const char *
+crash_signame(int sig)
+/*@*/
+{
+	switch ( sig ){
+	case SIGSEGV:	return "SIGSEGV";
+	case SIGBUS:	return "SIGBUS";
+	case SIGABRT:	return "SIGABRT";
+	case SIGFPE:	return "SIGFPE";
+	case SIGILL:	return "SIGILL";
+	default:	return "?";
+	}
+}
+
+static void
+crash_put_hex(ASSPF_WriteBuf *wb, const char *label, uintptr_t value)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*wb
+@*/
+{
+	(void) asspf_puts(wb, label);
+	(void) asspf_printf_intptr(wb, CRASH_HEX, value);
+	return;
+}
+
+/* ------------------------------------------------------------------------ */
+
+static void
+crash_put_siginfo(ASSPF_WriteBuf *wb, int sig, const siginfo_t *info)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*wb
+@*/
+{
+	(void) asspf_puts(wb, "*** fatal signal ");
+	(void) asspf_printf_int(wb, "d", sig);
+	(void) asspf_puts(wb, " (");
+	(void) asspf_puts(wb, crash_signame(sig));
+	(void) asspf_puts(wb, ") in pid ");
+	(void) asspf_printf_long(wb, "d", (long) getpid());
+	(void) asspf_puts(wb, " ***\nsi_code ");
+	(void) asspf_printf_int(wb, "d", info->si_code);
+	(void) asspf_puts(wb, ", si_errno ");
+	(void) asspf_printf_int(wb, "d", info->si_errno);
+	if ( sig == SIGABRT ){
+		(void) asspf_puts(wb, ", si_pid ");
+		(void) asspf_printf_long(wb, "d", (long) info->si_pid);
+	}
+	else {	crash_put_hex(
+			wb, ", fault address ", (uintptr_t) info->si_addr
+		);
+	}
+	(void) asspf_putc(wb, '\n');
+	return;
+}
+
+/* ------------------------------------------------------------------------ */
+
+#if defined(CRASH_ARCH_X86_64)
+
+struct Crash_Reg {
+	/*@observer@*/
+	const char	*name;
+	int		idx;
+};
+
+static const struct Crash_Reg crash_regs[] = {
+	{"rax", REG_RAX}, {"rbx", REG_RBX}, {"rcx", REG_RCX},
+	{"rdx", REG_RDX}, {"rsi", REG_RSI}, {"rdi", REG_RDI},
+	{"rbp", REG_RBP}, {"rsp", REG_RSP}, {"r8 ", REG_R8 },
+	{"r9 ", REG_R9 }, {"r10", REG_R10}, {"r11", REG_R11},
+	{"r12", REG_R12}, {"r13", REG_R13}, {"r14", REG_R14},
+	{"r15", REG_R15}, {"rip", REG_RIP}, {"efl", REG_EFL},
+	{"err", REG_ERR}, {"trp", REG_TRAPNO}, {"cr2", REG_CR2}
+};
+
+static void
+crash_put_regs(ASSPF_WriteBuf *wb, const ucontext_t *uc)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*wb
+@*/
+{
+	size_t i;
+
+	(void) asspf_puts(wb, "registers:");
+	for ( i = 0; i < (sizeof crash_regs) / (sizeof crash_regs[0]); ++i ){
+		(void) asspf_puts(wb, (i % 3u == 0 ? "\n  " : "  "));
+		(void) asspf_puts(wb, crash_regs[i].name);
+		crash_put_hex(
+			wb, " ",
+			(uintptr_t) uc->uc_mcontext.gregs[crash_regs[i].idx]
+		);
+	}
+	(void) asspf_putc(wb, '\n');
+	return;
+}
+
+#define CRASH_PC(Xuc)	((uintptr_t) (Xuc)->uc_mcontext.gregs[REG_RIP])
+#define CRASH_FP(Xuc)	((uintptr_t) (Xuc)->uc_mcontext.gregs[REG_RBP])
+
+#elif defined(CRASH_ARCH_AARCH64)
+
+static void
+crash_put_regs(ASSPF_WriteBuf *wb, const ucontext_t *uc)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*wb
+@*/
+{
+	char name[8u];
+	unsigned int i;
+
+	(void) asspf_puts(wb, "registers:");
+	for ( i = 0; i < 31u; ++i ){
+		(void) asspf_puts(wb, (i % 3u == 0 ? "\n  x" : "  x"));
+		name[0] = (char) ('0' + (i / 10u));
+		name[1] = (char) ('0' + (i % 10u));
+		(void) asspf_write(wb, name, (size_t) 2u);
+		crash_put_hex(
+			wb, " ", (uintptr_t) uc->uc_mcontext.regs[i]
+		);
+	}
+	crash_put_hex(wb, "  sp  ", (uintptr_t) uc->uc_mcontext.sp);
+	crash_put_hex(wb, "\n  pc  ", (uintptr_t) uc->uc_mcontext.pc);
+	crash_put_hex(wb, "  pstate ", (uintptr_t) uc->uc_mcontext.pstate);
+	(void) asspf_putc(wb, '\n');
+	return;
+}
+
+#define CRASH_PC(Xuc)	((uintptr_t) (Xuc)->uc_mcontext.pc)
+#define CRASH_FP(Xuc)	((uintptr_t) (Xuc)->uc_mcontext.regs[29])
+
+#else
+
+static void
+crash_put_regs(ASSPF_WriteBuf *wb, const ucontext_t *uc)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*wb
+@*/
+{
+	(void) uc;
+	(void) asspf_puts(wb, "registers: (unsupported architecture)\n");
+	return;
+}
+
+/* walks from the handler's own frame */
+#define CRASH_PC(Xuc)	((uintptr_t) 0u)
+#define CRASH_FP(Xuc)	((uintptr_t) __builtin_frame_address(0))
+
+#endif
+
+/* ------------------------------------------------------------------------ */
+
+/* returns 0 if 'size' bytes at 'addr' were copied into 'dest' */
+/* goes through the probe pipe, where a bad address is only EFAULT */
+static int
+crash_peek(/*@out@*/ void *dest, uintptr_t addr, size_t size)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*dest
+@*/
+{
+	ssize_t nbytes;
+
+	if ( crash_probe[1] < 0 ){
+		return 1;
+	}
+	/* at most PIPE_BUF bytes, so it is all or nothing */
+	do {	nbytes = write(crash_probe[1], (const void *) addr, size);
+	} while ( (nbytes < 0) && (errno == EINTR) );
+	if ( nbytes != (ssize_t) size ){
+		return 1;
+	}
+	nbytes = read(crash_probe[0], dest, size);
+	return (nbytes == (ssize_t) size ? 0 : 1);
+}
+
+/* walks the frame-pointer chain: [fp] = caller's fp, [fp + 1] = return pc */
+/* (needs -fno-omit-frame-pointer to see past the faulting function) */
+/* a frame pointer into unmapped memory ends the walk, instead of faulting */
+static void
+crash_put_backtrace(ASSPF_WriteBuf *wb, const ucontext_t *uc)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*wb
+@*/
+{
+	uintptr_t pc, fp, fp_next;
+	uintptr_t frame[2u];
+	unsigned int i = 0;
+
+	(void) asspf_puts(wb, "backtrace:\n");
+
+	pc = CRASH_PC(uc);
+	fp = CRASH_FP(uc);
+	if ( pc != 0 ){
+		(void) asspf_puts(wb, "  #");
+		(void) asspf_printf_int(wb, "-2u", i++);
+		crash_put_hex(wb, " ", pc);
+		(void) asspf_putc(wb, '\n');
+	}
+
+	for ( ; i < CRASH_BACKTRACE_MAX; ++i ){
+		if ( (fp == 0) || ((fp % sizeof(uintptr_t)) != 0) ){
+			break;
+		}
+		if ( crash_peek(frame, fp, sizeof frame) != 0 ){
+			(void) asspf_puts(wb, "  (unreadable frame)\n");
+			break;
+		}
+		fp_next = frame[0];
+		pc      = frame[1];
+		if ( pc == 0 ){
+			break;
+		}
+
+		(void) asspf_puts(wb, "  #");
+		(void) asspf_printf_int(wb, "-2u", i);
+		crash_put_hex(wb, " ", pc);
+		(void) asspf_putc(wb, '\n');
+
+		/* stacks grow down: callers' frames sit above, and close */
+		if ( (fp_next <= fp) || (fp_next - fp > CRASH_FRAME_SIZE_MAX) ){
+			break;
+		}
+		fp = fp_next;
+	}
+	return;
+}
+
+/* ------------------------------------------------------------------------ */
+
+static void
+crash_put_maps(ASSPF_WriteBuf *wb)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*wb
+@*/
+{
+	int fd;
+
+	(void) asspf_puts(wb, "maps:\n");
+
+	fd = open("/proc/self/maps", O_RDONLY);
+	if ( fd < 0 ){
+		return;
+	}
+
+	/* kernel-side where procfs allows it, else read straight into 'wb' */
+	(void) asspf_copy_fd(wb, fd, SIZE_MAX);
+
+	(void) close(fd);
+	return;
+}
+
+/* ------------------------------------------------------------------------ */
+
+static void
+crash_handler(int sig, siginfo_t *info, void *uctx)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState
+@*/
+{
+	const int errno_old = errno;
+	ASSPF_WriteBuf wb;
+
+	if ( __atomic_exchange_n(&crash_busy, 1, __ATOMIC_ACQ_REL) == 0 ){
+		(void) asspf_writebuf_autoinit_large(
+			&wb, crash_fd, crash_buf, sizeof crash_buf
+		);
+		crash_put_siginfo(&wb, sig, info);
+		crash_put_regs(&wb, uctx);
+		/* out before anything that reads the stack */
+		(void) asspf_flush(&wb);
+		crash_put_backtrace(&wb, uctx);
+		crash_put_maps(&wb);
+		(void) asspf_flush(&wb);
+	}
+
+	errno = errno_old;
+
+	/* SA_RESETHAND put back the default action,
+	   which runs as soon as this returns */
+	(void) raise(sig);
+	return;
+}
+
+/* ======================================================================== */
+
+/* returns 0 on success */
+/* 'altstack' (or NULL for none) becomes the calling thread's signal stack */
+int
+asspf_crash_install(int fd, void *altstack, size_t altstack_size)
+/*@globals	internalState@*/
+/*@modifies	internalState@*/
+{
+	struct sigaction sa;
+	size_t i;
+
+	if ( altstack != NULL ){
+		if ( asspf_crash_thread_init(altstack, altstack_size) != 0 ){
+			return 1;
+		}
+	}
+
+	crash_fd = fd;
+
+	if ( crash_probe[0] < 0 ){
+		if ( pipe(crash_probe) != 0 ){
+			return 1;
+		}
+		for ( i = 0; i < 2u; ++i ){
+			(void) fcntl(crash_probe[i], F_SETFD, FD_CLOEXEC);
+			(void) fcntl(crash_probe[i], F_SETFL, O_NONBLOCK);
+		}
+	}
+
+	(void) memset(&sa, 0, sizeof sa);
+	sa.sa_sigaction = crash_handler;
+	sa.sa_flags     = SA_SIGINFO | SA_ONSTACK | SA_RESETHAND;
+	(void) sigemptyset(&sa.sa_mask);
+	for ( i = 0; i < (sizeof crash_signals) / (sizeof *crash_signals); ++i ){
+		if ( sigaction(crash_signals[i], &sa, NULL) != 0 ){
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/* returns 0 on success */
+/* signal stacks are per-thread, so each thread gets its own */
+int
+asspf_crash_thread_init(void *altstack, size_t altstack_size)
+/*@globals	internalState@*/
+/*@modifies	internalState@*/
+{
+	stack_t ss;
+
+	(void) memset(&ss, 0, sizeof ss);
+	ss.ss_sp    = altstack;
+	ss.ss_size  = altstack_size;
+	ss.ss_flags = 0;
+	return (sigaltstack(&ss, NULL) != 0 ? 1 : 0);
+}
+
+/* EOF //////////////////////////////////////////////////////////////////// */
@@ -0,0 +1,50 @@
+#ifndef ASSPF_CRASH_H
+#define ASSPF_CRASH_H
+/* ///////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// asspf_crash.h - Async-Signal-Safe crash reporter                         //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Copyright (C) 2025, Shane Seelig                                         //
+// SPDX-License-Identifier: GPL-3.0-or-later                                //
+//                                                                          //
+/////////////////////////////////////////////////////////////////////////// */
+
+#include <stddef.h>
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/* recommended alternate signal stack size */
+#define ASSPF_CRASH_ALTSTACK_SIZE	65536u
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+#undef fd
+#undef altstack
+#undef altstack_size
+/*@external@*/ /*@unused@*/
+extern int asspf_crash_install(
+	int fd,
+	/*@null@*/ /*@dependent@*/
+	void *altstack,
+	size_t altstack_size
+)
+/*@globals	internalState@*/
+/*@modifies	internalState@*/
+;
+
+#undef altstack
+#undef altstack_size
+/*@external@*/ /*@unused@*/
+extern int asspf_crash_thread_init(
+	/*@dependent@*/
+	void *altstack,
+	size_t altstack_size
+)
+/*@globals	internalState@*/
+/*@modifies	internalState@*/
+;
+
+/* EOF //////////////////////////////////////////////////////////////////// */
+#endif	/* ASSPF_CRASH_H */
@@ -0,0 +1,368 @@
+/* ///////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// asspf_decode.c - render asspf binary trace records as text               //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Copyright (C) 2025, Shane Seelig                                         //
+// SPDX-License-Identifier: GPL-3.0-or-later                                //
+//                                                                          //
+/////////////////////////////////////////////////////////////////////////// */
+
+/* usage: asspf_decode [FORMAT]... < TRACE
+	the n-th FORMAT is the one compiled with id n */
+
+#include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "asspf.h"
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+#define INBUF_SIZE	65536u
+
+struct InBuf {
+	char		buf[INBUF_SIZE];
+	size_t		idx;
+	size_t		nmemb;
+	uintmax_t	offset;	/* of 'buf[idx]' in the trace */
+	int		fd;
+};
+
+/* ------------------------------------------------------------------------ */
+
+/* returns the number of bytes available at 'buf[idx]' */
+/* (less than 'want' only at the end of the input) */
+static size_t
+inbuf_fill(struct InBuf *in, size_t want)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*in
+@*/
+{
+	ssize_t nbytes_read;
+
+	if ( want > INBUF_SIZE ){
+		want = INBUF_SIZE;
+	}
+
+	if ( in->nmemb - in->idx >= want ){
+		return in->nmemb - in->idx;
+	}
+
+	(void) memmove(in->buf, &in->buf[in->idx], in->nmemb - in->idx);
+	in->nmemb -= in->idx;
+	in->idx    = 0;
+
+	while ( in->nmemb < want ){
+		nbytes_read = read(
+			in->fd, &in->buf[in->nmemb], INBUF_SIZE - in->nmemb
+		);
+		if ( nbytes_read <= 0 ){
+			break;
+		}
+		in->nmemb += (size_t) nbytes_read;
+	}
+	return in->nmemb;
+}
+
+/* returns the little-endian value in 'src' */
+static uintmax_t
+le_read(const char *src, size_t size)
+/*@*/
+{
+	uintmax_t retval = 0;
+	size_t i;
+
+	for ( i = size; i-- > 0; ){
+		retval <<= 4u;
+		retval <<= 4u;
+		retval  |= (uintmax_t) (unsigned char) src[i];
+	}
+	return retval;
+}
+
+#ifdef ASSPF_HAVE_INT128
+/* returns the 16-byte little-endian value in 'src' */
+static ASSPF_UInt128
+le_read128(const char *src)
+/*@*/
+{
+	return (((ASSPF_UInt128) le_read(&src[8u], 8u)) << 64u)
+	     | le_read(src, 8u);
+}
+#endif
+
+/* ------------------------------------------------------------------------ */
+
+/* returns the number of bytes written */
+/* 'src' is the little-endian value */
+static size_t
+put_int(
+	ASSPF_WriteBuf *wb, const char *format, const char *src,
+	size_t value_size
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*wb
+@*/
+{
+	uintmax_t value;
+
+#ifdef ASSPF_HAVE_INT128
+	if ( value_size == sizeof(ASSPF_UInt128) ){
+		return asspf_printf_int128(wb, format, le_read128(src));
+	}
+#endif
+	value = le_read(src, value_size);
+
+	switch ( value_size ){
+	case sizeof(uint_least8_t):
+		return asspf_printf_int8least(
+			wb, format, (uint_least8_t) value
+		);
+	case sizeof(uint_least16_t):
+		return asspf_printf_int16least(
+			wb, format, (uint_least16_t) value
+		);
+	case sizeof(uint_least32_t):
+		return asspf_printf_int32least(
+			wb, format, (uint_least32_t) value
+		);
+	default:
+		return asspf_printf_int64least(
+			wb, format, (uint_least64_t) value
+		);
+	}
+}
+
+/* returns the number of bytes written */
+/* 'src' is the little-endian value */
+static size_t
+putc_int(
+	ASSPF_WriteBuf *wb, const ASSPF_Format *fmt, const char *src,
+	size_t value_size
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*wb
+@*/
+{
+	uintmax_t value;
+
+#ifdef ASSPF_HAVE_INT128
+	if ( value_size == sizeof(ASSPF_UInt128) ){
+		return asspf_printfc_int128(wb, fmt, le_read128(src));
+	}
+#endif
+	value = le_read(src, value_size);
+
+	switch ( value_size ){
+	case sizeof(uint_least8_t):
+		return asspf_printfc_int8least(
+			wb, fmt, (uint_least8_t) value
+		);
+	case sizeof(uint_least16_t):
+		return asspf_printfc_int16least(
+			wb, fmt, (uint_least16_t) value
+		);
+	case sizeof(uint_least32_t):
+		return asspf_printfc_int32least(
+			wb, fmt, (uint_least32_t) value
+		);
+	default:
+		return asspf_printfc_int64least(
+			wb, fmt, (uint_least64_t) value
+		);
+	}
+}
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/*@noreturn@*/
+static void
+die(
+	ASSPF_WriteBuf *wb_out, const char *msg, const char *what,
+	uintmax_t n
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*wb_out
+@*/
+{
+	ASSPF_WriteBuf wb_err;
+	char cbuf_err[160u];
+
+	(void) asspf_flush(wb_out);
+
+	(void) asspf_writebuf_autoinit(
+		&wb_err, ASSPF_FD_STDERR, cbuf_err,
+		(unsigned short) sizeof cbuf_err
+	);
+	(void) asspf_puts(&wb_err, "asspf_decode: ");
+	(void) asspf_puts(&wb_err, msg);
+	(void) asspf_puts(&wb_err, " (");
+	(void) asspf_puts(&wb_err, what);
+	(void) asspf_putc(&wb_err, ' ');
+	(void) asspf_printf_intmax(&wb_err, "u", n);
+	(void) asspf_puts(&wb_err, ")\n");
+	(void) asspf_flush(&wb_err);
+
+	exit(EXIT_FAILURE);
+}
+
+/* ------------------------------------------------------------------------ */
+
+/* dies if there are not 'size' bytes left in the input */
+static void
+inbuf_need(struct InBuf *in, ASSPF_WriteBuf *wb_out, size_t size)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*in,
+		*wb_out
+@*/
+{
+	if ( inbuf_fill(in, size) < size ){
+		die(wb_out, "truncated record", "offset", in->offset);
+	}
+	return;
+}
+
+static void
+inbuf_skip(struct InBuf *in, size_t size)
+/*@modifies	*in@*/
+{
+	in->idx    += size;
+	in->offset += size;
+	return;
+}
+
+/* returns the value size, or dies if it is not 1 to 8 (or 16) */
+static size_t
+value_size_check(struct InBuf *in, ASSPF_WriteBuf *wb_out, char c)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*wb_out
+@*/
+{
+	const size_t retval = (size_t) (unsigned char) c;
+
+#ifdef ASSPF_HAVE_INT128
+	if ( retval == sizeof(ASSPF_UInt128) ){
+		return retval;
+	}
+#endif
+	if ( (retval == 0) || (retval > 8u) ){
+		die(wb_out, "bad value size", "offset", in->offset);
+	}
+	return retval;
+}
+
+/* ------------------------------------------------------------------------ */
+
+int
+main(int argc, char *argv[])
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem@*/
+{
+	static struct InBuf in;
+	static char cbuf_out[INBUF_SIZE];
+	ASSPF_WriteBuf wb_out;
+	/*@only@*/
+	ASSPF_Format *fmts;
+	size_t nfmts;
+	char format[UCHAR_MAX + 1u];
+	size_t avail, size, value_size, id;
+	int i;
+
+	(void) asspf_writebuf_autoinit_large(
+		&wb_out, ASSPF_FD_STDOUT, cbuf_out, sizeof cbuf_out
+	);
+
+	nfmts = (size_t) (argc > 1 ? argc - 1 : 0);
+	fmts  = malloc((nfmts != 0 ? nfmts : 1u) * (sizeof *fmts));
+	if ( fmts == NULL ){
+		die(&wb_out, "out of memory", "formats", (uintmax_t) nfmts);
+	}
+	for ( i = 1; i < argc; ++i ){
+		if ( asspf_format_compile(&fmts[i - 1], argv[i]) != 0 ){
+			die(&wb_out, "bad format", "id", (uintmax_t) (i - 1));
+		}
+	}
+
+	in.fd = STDIN_FILENO;
+	while ( inbuf_fill(&in, (size_t) 1u) != 0 ){
+		switch ( in.buf[in.idx] ){
+		case 'S':
+			inbuf_need(&in, &wb_out, (size_t) 5u);
+			size = (size_t) le_read(&in.buf[in.idx + 1u], 4u);
+			inbuf_skip(&in, (size_t) 5u);
+
+			/* pass it through, a bufferful at a time */
+			while ( size != 0 ){
+				avail = inbuf_fill(&in, size);
+				if ( avail == 0 ){
+					inbuf_need(&in, &wb_out, size);
+				}
+				avail = (avail < size ? avail : size);
+				(void) asspf_write(
+					&wb_out, &in.buf[in.idx], avail
+				);
+				inbuf_skip(&in, avail);
+				size -= avail;
+			}
+			break;
+
+		case 'I':
+			inbuf_need(&in, &wb_out, (size_t) 4u);
+			id = (size_t) le_read(&in.buf[in.idx + 1u], 2u);
+			value_size = value_size_check(
+				&in, &wb_out, in.buf[in.idx + 3u]
+			);
+			if ( id >= nfmts ){
+				die(&wb_out, "unknown format id", "offset",
+					in.offset
+				);
+			}
+			size = 4u + value_size;
+			inbuf_need(&in, &wb_out, size);
+
+			(void) putc_int(
+				&wb_out, &fmts[id], &in.buf[in.idx + 4u],
+				value_size
+			);
+			inbuf_skip(&in, size);
+			break;
+
+		case 'F':
+			inbuf_need(&in, &wb_out, (size_t) 2u);
+			size = (size_t) (unsigned char) in.buf[in.idx + 1u];
+			inbuf_need(&in, &wb_out, 3u + size);
+			(void) memcpy(format, &in.buf[in.idx + 2u], size);
+			format[size] = '\0';
+			value_size = value_size_check(
+				&in, &wb_out, in.buf[in.idx + 2u + size]
+			);
+			size += 3u + value_size;
+			inbuf_need(&in, &wb_out, size);
+
+			(void) put_int(
+				&wb_out, format,
+				&in.buf[in.idx + size - value_size], value_size
+			);
+			inbuf_skip(&in, size);
+			break;
+
+		default:
+			die(&wb_out, "bad record tag", "offset", in.offset);
+		}
+	}
+
+	(void) asspf_flush(&wb_out);
+	free(fmts);
+	return 0;
+}
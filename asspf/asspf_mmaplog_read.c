@@ -0,0 +1,169 @@
+/* ///////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// asspf_mmaplog_read.c - print an asspf memory-mapped crash log in order   //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Copyright (C) 2025, Shane Seelig                                         //
+// SPDX-License-Identifier: GPL-3.0-or-later                                //
+//                                                                          //
+/////////////////////////////////////////////////////////////////////////// */
+
+/* usage: asspf_mmaplog_read FILE [NBYTES]
+	prints the last NBYTES (default: all) still in the log,
+	oldest first */
+
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "asspf.h"
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/* must match 'struct MMapLog_Hdr' in asspf.c */
+#define HDR_MAGIC		"ASSPFLOG"
+#define HDR_VERSION		1u
+#define HDR_SIZE		64u
+#define HDR_OFF_VERSION		8u
+#define HDR_OFF_HDR_SIZE	12u
+#define HDR_OFF_DATA_SIZE	16u
+#define HDR_OFF_HEAD		24u
+
+/* ------------------------------------------------------------------------ */
+
+/*@noreturn@*/
+static void
+die(const char *msg)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem@*/
+{
+	ASSPF_WriteBuf wb_err;
+	char cbuf_err[160u];
+
+	(void) asspf_writebuf_autoinit(
+		&wb_err, ASSPF_FD_STDERR, cbuf_err,
+		(unsigned short) sizeof cbuf_err
+	);
+	(void) asspf_puts(&wb_err, "asspf_mmaplog_read: ");
+	(void) asspf_puts(&wb_err, msg);
+	(void) asspf_putc(&wb_err, '\n');
+	(void) asspf_flush(&wb_err);
+
+	exit(EXIT_FAILURE);
+}
+
+/* returns 0 on success */
+static int
+read_all(int fd, /*@out@*/ char *dest, size_t size)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*dest
+@*/
+{
+	ssize_t nbytes_read;
+
+	while ( size != 0 ){
+		nbytes_read = read(fd, dest, size);
+		if ( nbytes_read <= 0 ){
+			return 1;
+		}
+		dest = &dest[nbytes_read];
+		size -= (size_t) nbytes_read;
+	}
+	return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+
+int
+main(int argc, char *argv[])
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem@*/
+{
+	ASSPF_WriteBuf wb_out;
+	char cbuf_out[4096u];
+	char hdr[HDR_SIZE];
+	uint32_t version, hdr_size;
+	uint64_t data_size, head, nbytes, oldest;
+	/*@only@*/
+	char *data;
+	size_t off;
+	int fd;
+
+	if ( (argc != 2) && (argc != 3) ){
+		die("usage: asspf_mmaplog_read FILE [NBYTES]");
+	}
+
+	fd = open(argv[1], O_RDONLY);
+	if ( fd < 0 ){
+		die("cannot open the log");
+	}
+	if ( read_all(fd, hdr, sizeof hdr) != 0 ){
+		die("cannot read the header");
+	}
+
+	(void) memcpy(&version, &hdr[HDR_OFF_VERSION], sizeof version);
+	(void) memcpy(&hdr_size, &hdr[HDR_OFF_HDR_SIZE], sizeof hdr_size);
+	(void) memcpy(&data_size, &hdr[HDR_OFF_DATA_SIZE], sizeof data_size);
+	(void) memcpy(&head, &hdr[HDR_OFF_HEAD], sizeof head);
+	if (
+		(memcmp(hdr, HDR_MAGIC, sizeof HDR_MAGIC - 1u) != 0)
+	||
+		(version != (uint32_t) HDR_VERSION)
+	||
+		(hdr_size != (uint32_t) HDR_SIZE)
+	||
+		(data_size == 0) || (data_size > (uint64_t) SIZE_MAX)
+	){
+		die("not an asspf mmap log");
+	}
+
+	data = malloc((size_t) data_size);
+	if ( data == NULL ){
+		die("out of memory");
+	}
+	if ( read_all(fd, data, (size_t) data_size) != 0 ){
+		die("cannot read the log data");
+	}
+	(void) close(fd);
+
+	/* the ring holds the last 'data_size' bytes of 'head' */
+	nbytes = (head < data_size ? head : data_size);
+	if ( argc == 3 ){
+		oldest = (uint64_t) strtoul(argv[2], NULL, 10);
+		nbytes = (oldest < nbytes ? oldest : nbytes);
+	}
+	oldest = head - nbytes;
+
+	/* older bytes were overwritten: start on a whole line */
+	if ( oldest != 0 ){
+		while ( nbytes != 0 ){
+			--nbytes;
+			if ( data[(size_t) (oldest++ % data_size)] == '\n' ){
+				break;
+			}
+		}
+	}
+
+	(void) asspf_writebuf_autoinit(
+		&wb_out, ASSPF_FD_STDOUT, cbuf_out,
+		(unsigned short) sizeof cbuf_out
+	);
+	off = (size_t) (oldest % data_size);
+	if ( (uint64_t) off + nbytes > data_size ){
+		(void) asspf_write(
+			&wb_out, &data[off], (size_t) data_size - off
+		);
+		nbytes -= data_size - off;
+		off     = 0;
+	}
+	(void) asspf_write(&wb_out, &data[off], (size_t) nbytes);
+	(void) asspf_flush(&wb_out);
+
+	free(data);
+	return 0;
+}